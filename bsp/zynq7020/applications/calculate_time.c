@@ -11,6 +11,7 @@
  * <table>
  * <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  * <tr><td>v1.0 <td>文佳源 <td>2024-07-10 <td>内容
+ * <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>tic/toc改用单调时钟，不再清零停止全局定时器
  * </table>
  */
 #include <acoral.h>
@@ -153,21 +154,15 @@ void print_float(double num, acoral_u8 keep, acoral_32 width)
     }
 }
 
+static acoral_u64 tic_cycles = 0;  //tic时刻的全局定时器计数值，全局定时器为系统单调时钟，不能清零
 void tic(void)
 {
-   *((volatile int*)(GTC_BASE+GTC_CTRL)) = 0x00;
-   *((volatile int*)(GTC_BASE+GTC_DATL)) = 0x00000000;
-   *((volatile int*)(GTC_BASE+GTC_DATH)) = 0x00000000;     //清零定时器的计数值
-   *((volatile int*)(GTC_BASE+GTC_CTRL)) = 0x01;
+   tic_cycles = acoral_clock_cycles();
 }
 double toc(void)
 {
-   *((volatile int*)(GTC_BASE+GTC_CTRL)) = 0x00;
-   long long j=*((volatile int*)(GTC_BASE+GTC_DATH));
-   double elapsed_time = j<<32;
-   j=*((volatile int*)(GTC_BASE+GTC_DATL));              //读取64bit定时器值，转换为double
-   elapsed_time+=j;
-   elapsed_time=elapsed_time*2000.0/666666687.0;
+   acoral_u64 elapsed_ns = acoral_cycles_to_ns(acoral_clock_cycles() - tic_cycles);
+   double elapsed_time = (double)elapsed_ns / 1000000.0;   //单位ms
 //    acoral_print("%f\r\n",elapsed_time);
    return elapsed_time;
 }
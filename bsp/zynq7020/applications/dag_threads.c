@@ -11,6 +11,9 @@
  * <table>
  * <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  * <tr><td>v1.0 <td>胡博文 <td>2025-02-24 <td>内容
+ * <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>节点标注最坏执行时间，用于自动映射
+ * <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>节点名称，用于统计输出
+ * <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>手动映射的cpu与优先级标记为固定，打开自动映射时保留
  * </table>
  */
 #include <acoral.h>
@@ -41,7 +44,10 @@ acoral_dag_user_node dag_func_1_node =
     .route = dag_func_1,
     .args = NULL,
     .processor = 1,
-    .prio = 13
+    .prio = 13,
+    .fixed = ACORAL_DAG_FIX_CPU|ACORAL_DAG_FIX_PRIO,
+    .wcet = 2000,
+    .name = "dag_func_1"
 };
 
 // Node 2
@@ -69,7 +75,10 @@ acoral_dag_user_node dag_func_2_node =
     .route = dag_func_2,
     .args = NULL,
     .processor = 1,
-    .prio = 14
+    .prio = 14,
+    .fixed = ACORAL_DAG_FIX_CPU|ACORAL_DAG_FIX_PRIO,
+    .wcet = 1000,
+    .name = "dag_func_2"
 };
 
 // Node 3
@@ -97,7 +106,10 @@ acoral_dag_user_node dag_func_3_node =
     .route = dag_func_3,
     .args = NULL,
     .processor = 0,
-    .prio = 15
+    .prio = 15,
+    .fixed = ACORAL_DAG_FIX_CPU|ACORAL_DAG_FIX_PRIO,
+    .wcet = 500,
+    .name = "dag_func_3"
 };
 
 void dag_func_4(void *args)
@@ -124,7 +136,10 @@ acoral_dag_user_node dag_func_4_node =
     .route = dag_func_4,
     .args = NULL,
     .processor = 1,
-    .prio = 16
+    .prio = 16,
+    .fixed = ACORAL_DAG_FIX_CPU|ACORAL_DAG_FIX_PRIO,
+    .wcet = 1000,
+    .name = "dag_func_4"
 };
 
 // Node 5
@@ -144,7 +159,7 @@ void dag_func_5(void *args)
                     acoral_cur_thread -> prio );
 #endif
 }
-acoral_func_point dag_func_5_prev[1] = {dag_func_2, dag_func_4};
+acoral_func_point dag_func_5_prev[2] = {dag_func_2, dag_func_4};
 acoral_dag_user_node dag_func_5_node =
 {
     .prev_route = dag_func_5_prev,
@@ -152,7 +167,10 @@ acoral_dag_user_node dag_func_5_node =
     .route = dag_func_5,
     .args = NULL,
     .processor = 0,
-    .prio = 17
+    .prio = 17,
+    .fixed = ACORAL_DAG_FIX_CPU|ACORAL_DAG_FIX_PRIO,
+    .wcet = 2000,
+    .name = "dag_func_5"
 };
 
 
@@ -181,7 +199,10 @@ acoral_dag_user_node dag_func_6_node =
     .route = dag_func_6,
     .args = NULL,
     .processor = 0,
-    .prio = 18
+    .prio = 18,
+    .fixed = ACORAL_DAG_FIX_CPU|ACORAL_DAG_FIX_PRIO,
+    .wcet = 1000,
+    .name = "dag_func_6"
 };
 
 // Node 7
@@ -209,7 +230,10 @@ acoral_dag_user_node dag_func_7_node =
     .route = dag_func_7,
     .args = NULL,
     .processor = 1,
-    .prio = 19
+    .prio = 19,
+    .fixed = ACORAL_DAG_FIX_CPU|ACORAL_DAG_FIX_PRIO,
+    .wcet = 3000,
+    .name = "dag_func_7"
 };
 
 // Node 8
@@ -237,7 +261,10 @@ acoral_dag_user_node dag_func_8_node =
     .route = dag_func_8,
     .args = NULL,
     .processor = 0,
-    .prio = 20
+    .prio = 20,
+    .fixed = ACORAL_DAG_FIX_CPU|ACORAL_DAG_FIX_PRIO,
+    .wcet = 1000,
+    .name = "dag_func_8"
 };
 
 // Node 9
@@ -265,7 +292,10 @@ acoral_dag_user_node dag_func_9_node =
     .route = dag_func_9,
     .args = NULL,
     .processor = 0,
-    .prio = 21
+    .prio = 21,
+    .fixed = ACORAL_DAG_FIX_CPU|ACORAL_DAG_FIX_PRIO,
+    .wcet = 1000,
+    .name = "dag_func_9"
 };
 
 // 设置dag任务的周期
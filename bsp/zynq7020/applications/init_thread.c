@@ -11,12 +11,15 @@
  * <table>
  * <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  * <tr><td>v1.0 <td>胡博文 <td>- <td>内容
+ * <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>初始化中断发送的串口驱动
+ * <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>初始化二进制日志
  * </table>
  */
 
 #include <acoral.h>
 #include "xgpiops.h"
 #include "xuartps.h"
+#include "uart.h"
 //#include "led_intr_ip.h"
 #include "xil_printf.h"
 #include <timed.h>
@@ -69,6 +72,9 @@ void init(void *args)
     
     acoral_sched_enable=true;
 
+    /*串口初始化，之后的打印经发送缓冲区由中断发送*/
+    acoral_uart_init();
+
     /*软件延时初始化*/
 #ifdef CFG_SOFT_DELAY
     soft_delay_init();
@@ -77,6 +83,9 @@ void init(void *args)
 #ifdef CFG_TRACE_THREADS_SWITCH_ENABLE
     acoral_monitor_init();
 #endif
+#ifdef CFG_BINLOG
+    acoral_binlog_init();
+#endif
 #ifdef CFG_SHELL
     acoral_ash_shell_init();
 #endif
@@ -36,6 +36,32 @@
 #define CFG_MAX_THREAD (60)
 ///线程配置：最小栈空间大小
 #define CFG_MIN_STACK_SIZE (128)
+///线程配置：栈涂色与高水位检测
+#define CFG_STACK_CHECK
+#ifdef CFG_STACK_CHECK
+///线程配置：空闲线程扫描栈高水位的周期(ms)
+#define CFG_STACK_CHECK_PERIOD (1000)
+///线程配置：推荐栈大小相对高水位的余量(%)
+#define CFG_STACK_CHECK_MARGIN (25)
+///线程配置：栈底保护区溢出检测，线程切换时检查
+// #define CFG_STACK_CHECK_GUARD
+#endif
+///线程配置：线程tcb+栈回收缓存，线程创建时直接取出
+#define CFG_THREAD_RECYCLE
+#ifdef CFG_THREAD_RECYCLE
+///线程配置：回收缓存栈大小等级数量，从128字节开始按2倍递增
+#define CFG_THREAD_RECYCLE_CLASS_NUM (6)
+///线程配置：回收缓存每个等级最多缓存数量
+#define CFG_THREAD_RECYCLE_MAX (8)
+///线程配置：启动时各等级预热数量，依次为128/256/512/1024/2048/4096字节栈
+#define CFG_THREAD_RECYCLE_PREWARM {0, 0, 0, 4, 0, 0}
+#endif
+///线程配置：时间确定性线程分派表（循环执行）模式，超周期展开为每个cpu的有序表
+// #define CFG_TIMED_TABLE
+#ifdef CFG_TIMED_TABLE
+///线程配置：每个cpu分派表表项数量，每个实例占段数量+1项
+#define CFG_TIMED_TABLE_SIZE (128)
+#endif
 
 /*
  * event configuration
@@ -48,6 +74,52 @@
  */
 ///基石时钟配置：时钟tick与秒的转换倍率
 #define CFG_TICKS_PER_SEC (1000)
+///基石时钟配置：软件定时器
+#define CFG_SOFT_TIMER
+#ifdef CFG_SOFT_TIMER
+///基石时钟配置：软件定时器池大小
+#define CFG_SOFT_TIMER_NUM (32)
+///基石时钟配置：时间轮槽数量的位数，槽数量为2的该次方
+#define CFG_SOFT_TIMER_WHEEL_BITS (6)
+///基石时钟配置：定时器线程优先级
+#define CFG_SOFT_TIMER_PRIO (2)
+///基石时钟配置：定时器线程栈大小
+#define CFG_SOFT_TIMER_STACK_SIZE (512)
+#endif
+
+/*
+ * dag configuration
+ */
+///并行编程框架配置：工作线程池执行器，节点由每个cpu固定的工作线程执行，不再各自映射为周期线程
+// #define CFG_DAG_POOL
+#ifdef CFG_DAG_POOL
+///并行编程框架配置：每个cpu工作线程数量
+#define CFG_DAG_POOL_WORKERS (1)
+///并行编程框架配置：工作线程栈大小
+#define CFG_DAG_POOL_STACK_SIZE (1024)
+///并行编程框架配置：工作线程优先级
+#define CFG_DAG_POOL_PRIO (13)
+///并行编程框架配置：每个dag同时在途的实例数上限，1表示上一实例完成后才释放下一实例
+#define CFG_DAG_POOL_PIPELINE (2)
+///并行编程框架配置：事件触发dag排队等待释放的触发个数上限
+#define CFG_DAG_POOL_EVENT_QUEUE (8)
+///并行编程框架配置：每个cpu就绪节点双端队列容量，须为2的幂且不小于所有dag节点总数乘在途实例数
+#define CFG_DAG_POOL_DEQUE_SIZE (64)
+///并行编程框架配置：实例端到端延迟直方图、截止期检查、节点响应时间与观测关键路径统计
+#define CFG_DAG_STAT
+#ifdef CFG_DAG_STAT
+///并行编程框架配置：端到端延迟直方图格数，第i格为[2^i,2^(i+1))us，末格包含更大的值
+#define CFG_DAG_STAT_HIST_NUM (24)
+#endif
+#endif
+///并行编程框架配置：按节点最坏执行时间自动映射cpu（HEFT表调度），并按关键路径排名分配优先级
+// #define CFG_DAG_AUTO_MAP
+#ifdef CFG_DAG_AUTO_MAP
+///并行编程框架配置：自动分配的最高优先级，排名越靠后优先级数值越大
+#define CFG_DAG_AUTO_MAP_PRIO (13)
+///并行编程框架配置：跨cpu边的通信开销估计(ms)
+#define CFG_DAG_AUTO_MAP_COMM (0)
+#endif
 
 /*
  * cmp configuration
@@ -85,14 +157,33 @@
 #endif
 
 
+///用户配置: 是否开启内核事件追踪
+// #define CFG_TRACE
+
 ///用户配置: 是否开启追踪线程切换信息
 // #define CFG_TRACE_THREADS_SWITCH_ENABLE
 
 #ifdef CFG_TRACE_THREADS_SWITCH_ENABLE
 #define CFG_TRACE_THREADS_SWITCH_WITH_SIM_ENABLE
+#ifndef CFG_TRACE
+#define CFG_TRACE
+#endif
+#endif
+
+#ifdef CFG_TRACE
+///用户配置: 每个cpu追踪环形缓冲区的记录个数，必须为2的幂
+#define CFG_TRACE_RING_SIZE (256)
+///用户配置: 默认开启的追踪事件类别掩码
+#define CFG_TRACE_MASK (0xFFFFFFFF)
+///用户配置: 默认缓冲区满时的处理方式，0覆盖最旧记录，1停止记录
+#define CFG_TRACE_MODE (0)
 #endif
 
 #ifdef CFG_TRACE_THREADS_SWITCH_WITH_SIM_ENABLE
+///用户配置: 追踪数据以紧凑编码发送（差分时间戳、小线程号、变长整数、带序号和CRC的批量帧），注释掉则发送原始结构体
+#define CFG_TRACE_WIRE_COMPACT
+///用户配置: 紧凑编码每帧负载的最大字节数
+#define CFG_TRACE_WIRE_BATCH (240)
 
 #ifdef CFG_PERIOD_THREADS_PRINT_ENABLE
 #undef CFG_PERIOD_THREADS_PRINT_ENABLE
@@ -112,6 +203,69 @@
 
 #endif
 
+///用户配置: 是否开启二进制日志，调用处只记录格式串号和参数，格式化在主机端完成
+// #define CFG_BINLOG
+
+#ifdef CFG_BINLOG
+///用户配置: 每个cpu日志缓冲区的字数，必须为2的幂
+#define CFG_BINLOG_RING_WORDS (1024)
+///用户配置: 单条日志最多的参数个数，不超过15
+#define CFG_BINLOG_MAX_ARGS (8)
+///用户配置: 日志发送线程的优先级
+#define CFG_BINLOG_PRIO (ACORAL_DAEMON_PRIO-1)
+///用户配置: 日志发送线程的周期(ms)
+#define CFG_BINLOG_PERIOD (100)
+///用户配置: 日志发送线程的栈大小
+#define CFG_BINLOG_STACK_SIZE (1024)
+#endif
+
+#if defined(CFG_TRACE_WIRE_COMPACT) || defined(CFG_BINLOG)
+///串口紧凑编码帧，由追踪和二进制日志共用
+#define CFG_WIRE
+#endif
+
+///用户配置: 是否开启cpu时间统计，统计各线程运行时间和各核线程/内核/中断/空闲时间，shell命令top
+// #define CFG_CPU_USAGE
+
+#ifdef CFG_CPU_USAGE
+///用户配置: 占用率统计窗口(ms)
+#define CFG_CPU_USAGE_WINDOW (1000)
+#endif
+
+///用户配置: 是否开启中断统计，统计各中断次数、服务时间与延迟直方图和各核嵌套深度，shell命令irq
+// #define CFG_IRQ_STAT
+
+#ifdef CFG_IRQ_STAT
+///用户配置: 直方图桶数，第0桶小于1us，第i桶为[2^(i-1),2^i)us
+#define CFG_IRQ_STAT_HIST_NUM (12)
+///用户配置: 统计的最大中断嵌套深度
+#define CFG_IRQ_STAT_NEST_MAX (8)
+#endif
+
+///用户配置: 是否开启性能计数器统计，线程切换时把cycle与事件计数累加到线程上，shell命令pmu
+// #define CFG_PMU
+
+#ifdef CFG_PMU
+///用户配置: 事件个数，不超过6，硬件事件计数器不足时(如QEMU)只统计cycle
+#define CFG_PMU_EVENT_NUM (3)
+///用户配置: 事件号，默认为L1数据cache回填(即对L2的访问)、分支预测失败、指令数
+#define CFG_PMU_EVENTS {0x03,0x10,0x68}
+///用户配置: 采样计数器，0为cycle，i为第i个事件，只统计cycle时使用cycle
+#define CFG_PMU_SAMPLE_COUNTER (1)
+///用户配置: 采样周期，采样计数器每计这么多次给正在运行的线程记一次采样，0表示不采样
+#define CFG_PMU_SAMPLE_PERIOD (10000)
+#endif
+
+///用户配置: 是否开启临界区分析，统计各核最外层临界区(关中断且锁调度)的时长、直方图与调用地址，shell命令crit
+// #define CFG_CRIT_PROF
+
+#ifdef CFG_CRIT_PROF
+///用户配置: 直方图桶数，第0桶小于1us，第i桶为[2^(i-1),2^i)us
+#define CFG_CRIT_PROF_HIST_NUM (12)
+///用户配置: 按调用地址统计的表项数，表满时保留最长时长较大的
+#define CFG_CRIT_PROF_TOP_NUM (8)
+#endif
+
 /// 开销测试相关 start
 /* note: can only choose one */
 #define MEASURE_CONSEXT_SWITCH      0   /* 上下文切换测试 */
@@ -167,6 +321,16 @@
 ///用户配置：shell
 // #define CFG_SHELL
 //#undef CFG_SHELL
+///用户配置：串口波特率
+#define CFG_UART_BAUD_RATE (115200)
+///用户配置：串口发送经环形缓冲区由发送中断搬运，打印不再关中断等待串口发完
+#define CFG_UART_TX_RING
+#ifdef CFG_UART_TX_RING
+///用户配置：串口发送环形缓冲区字节数，必须为2的幂
+#define CFG_UART_TX_RING_SIZE (4096)
+///用户配置：发送缓冲区满时的处理方式，0丢弃整条消息，1等待腾出空间
+#define CFG_UART_TX_POLICY (1)
+#endif
 ///用户配置：FIFO队列为0
 #define CFG_FIFO_QUEUE 0
 ///用户配置：PRIO队列为1
@@ -0,0 +1,339 @@
+/**
+ * @file uart.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief 串口驱动源文件，发送经环形缓冲区由发送中断搬运
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>中断发送的串口驱动
+ */
+#include <acoral.h>
+#include "uart.h"
+#include "xuartps.h"
+
+///串口设备ID，与标准输出为同一串口
+#define UART_DEVICE_ID XPAR_PS7_UART_0_DEVICE_ID
+///串口中断ID
+#define UART_INT_ID XPAR_XUARTPS_0_INTR
+
+///串口实例
+static XUartPs uart;
+///是否已初始化，初始化前以轮询方式发送
+static volatile acoral_u8 uart_ready;
+///接收回调
+static acoral_uart_rx_hook_t uart_rx_hook;
+
+#ifdef CFG_UART_TX_RING
+#if (CFG_UART_TX_RING_SIZE&(CFG_UART_TX_RING_SIZE-1))
+#error "CFG_UART_TX_RING_SIZE must be power of 2"
+#endif
+///发送环形缓冲区
+static acoral_u8 tx_ring[CFG_UART_TX_RING_SIZE];
+///已写入缓冲区的字节总数
+static volatile acoral_u32 tx_head;
+///已搬入发送FIFO的字节总数
+static volatile acoral_u32 tx_tail;
+///发送空中断是否开启
+static volatile acoral_u8 tx_active;
+///缓冲区满时的处理方式
+static volatile acoral_u8 tx_policy = CFG_UART_TX_POLICY;
+///因缓冲区满被丢弃的字节数
+static volatile acoral_u32 tx_dropped;
+#ifdef CFG_SMP
+///发送缓冲区自旋锁，写入者与发送中断共用
+static acoral_spinlock_t tx_lock;
+#endif
+
+/**
+ * @brief 获取发送缓冲区，只关本cpu中断，持有时间为拷贝若干字节
+ *
+ * @return acoral_u32 进入前的中断状态
+ */
+static acoral_u32 uart_tx_lock(void)
+{
+    acoral_u32 flags=acoral_intr_save();
+#ifdef CFG_SMP
+    acoral_spin_lock(&tx_lock);
+#endif
+    return flags;
+}
+
+/**
+ * @brief 释放发送缓冲区
+ *
+ * @param flags uart_tx_lock返回的中断状态
+ */
+static void uart_tx_unlock(acoral_u32 flags)
+{
+#ifdef CFG_SMP
+    acoral_spin_unlock(&tx_lock);
+#endif
+    acoral_intr_restore_flags(flags);
+}
+
+/**
+ * @brief 把缓冲区内容搬入发送FIFO直到FIFO满或缓冲区空，调用者持有发送缓冲区
+ *
+ */
+static void uart_fifo_fill(void)
+{
+    acoral_u32 base=uart.Config.BaseAddress;
+    while(tx_tail!=tx_head&&!(XUartPs_ReadReg(base,XUARTPS_SR_OFFSET)&XUARTPS_SR_TXFULL))
+    {
+        XUartPs_WriteReg(base,XUARTPS_FIFO_OFFSET,tx_ring[tx_tail&(CFG_UART_TX_RING_SIZE-1)]);
+        tx_tail++;
+    }
+}
+
+/**
+ * @brief 发送空中断未开启时先填满FIFO，剩余内容交给发送空中断，调用者持有发送缓冲区
+ *
+ */
+static void uart_tx_kick(void)
+{
+    acoral_u32 base=uart.Config.BaseAddress;
+    if(tx_active)
+        return;
+    uart_fifo_fill();
+    if(tx_tail!=tx_head)
+    {
+        XUartPs_WriteReg(base,XUARTPS_ISR_OFFSET,XUARTPS_IXR_TXEMPTY);//清除以前留下的空标志，FIFO此时不空
+        XUartPs_WriteReg(base,XUARTPS_IER_OFFSET,XUARTPS_IXR_TXEMPTY);
+        tx_active=1;
+    }
+}
+
+/**
+ * @brief 把一段数据整体写入发送缓冲区
+ *
+ * @param data 数据
+ * @param len 字节数，不超过缓冲区大小
+ * @param block 空间不足时是否等待
+ * @return acoral_u32 写入的字节数，丢弃时为0
+ */
+static acoral_u32 uart_tx_put(const acoral_u8 *data, acoral_u32 len, acoral_u8 block)
+{
+    acoral_u32 flags,i;
+    flags=uart_tx_lock();
+    while(CFG_UART_TX_RING_SIZE-(tx_head-tx_tail)<len)
+    {
+        if(!block)
+        {
+            tx_dropped+=len;
+            uart_tx_unlock(flags);
+            return 0;
+        }
+        //等待时自己搬运，不依赖发送中断，调用者关着中断也能推进；每轮放开一次让其他cpu和中断进入
+        uart_fifo_fill();
+        uart_tx_unlock(flags);
+        flags=uart_tx_lock();
+    }
+    for(i=0;i<len;i++)
+        tx_ring[(tx_head+i)&(CFG_UART_TX_RING_SIZE-1)]=data[i];
+    tx_head+=len;
+    uart_tx_kick();
+    uart_tx_unlock(flags);
+    return len;
+}
+#endif
+
+/**
+ * @brief 轮询方式发送，初始化前或不使用发送缓冲区时使用
+ *
+ * @param data 数据
+ * @param len 字节数
+ */
+static void uart_poll_write(const acoral_u8 *data, acoral_u32 len)
+{
+    while(len-->0)
+        outbyte(*data++);
+}
+
+/**
+ * @brief 串口中断服务函数，处理发送空和接收
+ *
+ * @param ref 串口实例
+ */
+static void uart_intr_handler(void *ref)
+{
+    XUartPs *inst=(XUartPs *)ref;
+    acoral_u32 base=inst->Config.BaseAddress;
+    acoral_u32 status;
+#ifdef CFG_UART_TX_RING
+    acoral_u32 flags;
+#endif
+    status=XUartPs_ReadReg(base,XUARTPS_IMR_OFFSET);
+    status&=XUartPs_ReadReg(base,XUARTPS_ISR_OFFSET);
+    XUartPs_WriteReg(base,XUARTPS_ISR_OFFSET,status);//先清标志再补充FIFO，补充后再次变空时能重新触发
+#ifdef CFG_UART_TX_RING
+    if(status&XUARTPS_IXR_TXEMPTY)
+    {
+        flags=uart_tx_lock();
+        uart_fifo_fill();
+        if(tx_tail==tx_head)
+        {
+            XUartPs_WriteReg(base,XUARTPS_IDR_OFFSET,XUARTPS_IXR_TXEMPTY);
+            tx_active=0;
+        }
+        uart_tx_unlock(flags);
+    }
+#endif
+    if((status&XUARTPS_IXR_RXOVR)&&uart_rx_hook!=NULL)
+        uart_rx_hook();
+}
+
+/**
+ * @brief 串口初始化，之后的发送经发送缓冲区由中断搬运
+ *
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_uart_init(void)
+{
+    XUartPs_Config *cfg;
+    if(uart_ready)
+        return KR_OK;
+    cfg=XUartPs_LookupConfig(UART_DEVICE_ID);
+    if(cfg==NULL)
+        return KR_UART_ERR_INIT;
+    if(XUartPs_CfgInitialize(&uart,cfg,cfg->BaseAddress)!=XST_SUCCESS)
+        return KR_UART_ERR_INIT;
+    XUartPs_SetOperMode(&uart,XUARTPS_OPER_MODE_NORMAL);
+    XUartPs_SetBaudRate(&uart,CFG_UART_BAUD_RATE);
+    XUartPs_SetFifoThreshold(&uart,1);//接收FIFO中有1个字节即触发
+    XUartPs_WriteReg(cfg->BaseAddress,XUARTPS_IDR_OFFSET,XUARTPS_IXR_MASK);
+#if defined(CFG_UART_TX_RING) && defined(CFG_SMP)
+    acoral_spin_init(&tx_lock);
+#endif
+    XScuGic_Connect(&int_ctrl[0],UART_INT_ID,(Xil_ExceptionHandler)uart_intr_handler,(void *)&uart);
+    XScuGic_Enable(&int_ctrl[0],UART_INT_ID);
+    acoral_dmb();
+    uart_ready=1;
+    if(uart_rx_hook!=NULL)
+        XUartPs_WriteReg(cfg->BaseAddress,XUARTPS_IER_OFFSET,XUARTPS_IXR_RXOVR);
+    return KR_OK;
+}
+
+/**
+ * @brief 发送数据，空间不足时按设置的处理方式等待或丢弃；超过缓冲区大小的数据分段写入
+ *
+ * @param data 数据
+ * @param len 字节数
+ * @return acoral_u32 写入的字节数
+ */
+acoral_u32 acoral_uart_write(const void *data, acoral_u32 len)
+{
+#ifdef CFG_UART_TX_RING
+    const acoral_u8 *p=(const acoral_u8 *)data;
+    acoral_u32 n,done=0;
+    if(uart_ready)
+    {
+        while(done<len)
+        {
+            n=len-done<CFG_UART_TX_RING_SIZE?len-done:CFG_UART_TX_RING_SIZE;
+            if(uart_tx_put(p+done,n,tx_policy==ACORAL_UART_FULL_BLOCK)==0)
+                break;
+            done+=n;
+        }
+        return done;
+    }
+#endif
+    uart_poll_write((const acoral_u8 *)data,len);
+    return len;
+}
+
+/**
+ * @brief 不等待地发送数据，空间不足时整体丢弃
+ *
+ * @param data 数据
+ * @param len 字节数
+ * @return acoral_u32 写入的字节数，丢弃时为0
+ */
+acoral_u32 acoral_uart_write_nb(const void *data, acoral_u32 len)
+{
+#ifdef CFG_UART_TX_RING
+    if(uart_ready)
+    {
+        if(len>CFG_UART_TX_RING_SIZE)
+        {
+            tx_dropped+=len;
+            return 0;
+        }
+        return uart_tx_put((const acoral_u8 *)data,len,0);
+    }
+#endif
+    uart_poll_write((const acoral_u8 *)data,len);
+    return len;
+}
+
+/**
+ * @brief 发送一个字符
+ *
+ * @param c 字符
+ */
+void acoral_uart_putc(acoral_char c)
+{
+    acoral_uart_write(&c,1);
+}
+
+/**
+ * @brief 设置发送缓冲区满时的处理方式
+ *
+ * @param policy ACORAL_UART_FULL_DROP或ACORAL_UART_FULL_BLOCK
+ */
+void acoral_uart_set_policy(acoral_u8 policy)
+{
+#ifdef CFG_UART_TX_RING
+    tx_policy=policy;
+#endif
+}
+
+/**
+ * @brief 获取因发送缓冲区满被丢弃的字节数
+ *
+ * @return acoral_u32 字节数
+ */
+acoral_u32 acoral_uart_dropped(void)
+{
+#ifdef CFG_UART_TX_RING
+    return tx_dropped;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 设置接收回调，接收FIFO有数据时在中断中调用
+ *
+ * @param hook 回调，NULL关闭接收中断
+ */
+void acoral_uart_set_rx_hook(acoral_uart_rx_hook_t hook)
+{
+    uart_rx_hook=hook;
+    if(!uart_ready)
+        return;
+    XUartPs_WriteReg(uart.Config.BaseAddress,hook!=NULL?XUARTPS_IER_OFFSET:XUARTPS_IDR_OFFSET,XUARTPS_IXR_RXOVR);
+}
+
+/**
+ * @brief 读取接收FIFO中已有的数据，不等待
+ *
+ * @param buf 输出缓冲区
+ * @param len 缓冲区字节数
+ * @return acoral_u32 读取的字节数
+ */
+acoral_u32 acoral_uart_read(void *buf, acoral_u32 len)
+{
+    acoral_u8 *p=(acoral_u8 *)buf;
+    acoral_u32 n=0;
+    if(!uart_ready)
+        return 0;
+    //直接读FIFO，不用XUartPs_Recv，它会暂时关闭全部串口中断并恢复成旧的屏蔽值，与发送空中断的开关冲突
+    while(n<len&&!(XUartPs_ReadReg(uart.Config.BaseAddress,XUARTPS_SR_OFFSET)&XUARTPS_SR_RXEMPTY))
+        p[n++]=(acoral_u8)XUartPs_ReadReg(uart.Config.BaseAddress,XUARTPS_FIFO_OFFSET);
+    return n;
+}
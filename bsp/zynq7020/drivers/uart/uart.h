@@ -0,0 +1,39 @@
+/**
+ * @file uart.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief 串口驱动头文件，发送经环形缓冲区由发送中断搬运
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>中断发送的串口驱动
+ */
+#ifndef BSP_UART_H
+#define BSP_UART_H
+#include <config.h>
+#include <type.h>
+
+///发送缓冲区满时丢弃整条消息
+#define ACORAL_UART_FULL_DROP 0
+///发送缓冲区满时等待，等待期间由写入者自己把缓冲区内容搬入发送FIFO
+#define ACORAL_UART_FULL_BLOCK 1
+
+/**
+ * @brief 串口接收回调，在串口中断中调用
+ *
+ */
+typedef void (*acoral_uart_rx_hook_t)(void);
+
+acoral_err acoral_uart_init(void);
+acoral_u32 acoral_uart_write(const void *data, acoral_u32 len);
+acoral_u32 acoral_uart_write_nb(const void *data, acoral_u32 len);
+void acoral_uart_putc(acoral_char c);
+void acoral_uart_set_policy(acoral_u8 policy);
+acoral_u32 acoral_uart_dropped(void);
+void acoral_uart_set_rx_hook(acoral_uart_rx_hook_t hook);
+acoral_u32 acoral_uart_read(void *buf, acoral_u32 len);
+#endif
@@ -11,6 +11,11 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-09-07 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>增加top命令
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>增加irq命令
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>增加pmu命令
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>增加crit命令
+ *         <tr><td>v1.5 <td>胡博文 <td>2026-10-19 <td>增加dag命令
  */
 #include <queue.h>
 #include <mem.h>
@@ -19,6 +24,21 @@
 #include <str.h>
 #include <print.h>
 #include "ff.h"
+#ifdef CFG_CPU_USAGE
+#include <usage.h>
+#endif
+#ifdef CFG_IRQ_STAT
+#include <irq_stat.h>
+#endif
+#ifdef CFG_PMU
+#include <pmu.h>
+#endif
+#ifdef CFG_CRIT_PROF
+#include <crit_prof.h>
+#endif
+#ifdef CFG_DAG_STAT
+#include <acoral.h>//dag.h依赖内核类型，与shell.c一样经acoral.h引入
+#endif
 ///ash终端命令队列
 acoral_queue_t acoral_ash_cmd_queue;
 extern struct ash_shell acoral_shell;
@@ -370,6 +390,131 @@ acoral_ash_cmd_t cd_cmd =
 };
 /***********************************file system cmd******************************/
 
+#ifdef CFG_CPU_USAGE
+/**
+ * @brief ash终端命令之top
+ * 
+ * @param argc 参数数目
+ * @param argv 参数列表
+ */
+void top(acoral_32 argc,acoral_char **argv)
+{
+    acoral_usage_report();
+}
+/**
+ * @brief top命令结构体
+ * 
+ */
+acoral_ash_cmd_t top_cmd =
+{
+    .name = "top",
+    .exe = top,
+    .comment = "Show cpu usage of cores and threads"
+};
+#endif
+
+#ifdef CFG_IRQ_STAT
+/**
+ * @brief ash终端命令之irq，带参数reset时清零统计
+ * 
+ * @param argc 参数数目
+ * @param argv 参数列表
+ */
+void irq(acoral_32 argc,acoral_char **argv)
+{
+    if(argc == 2 && acoral_str_cmp(argv[1], "reset") == 0)
+    {
+        acoral_irq_stat_reset();
+        return;
+    }
+    acoral_irq_stat_report();
+}
+/**
+ * @brief irq命令结构体
+ * 
+ */
+acoral_ash_cmd_t irq_cmd =
+{
+    .name = "irq",
+    .exe = irq,
+    .comment = "Show interrupt stats, 'irq reset' to clear"
+};
+#endif
+
+#ifdef CFG_PMU
+/**
+ * @brief ash终端命令之pmu
+ * 
+ * @param argc 参数数目
+ * @param argv 参数列表
+ */
+void pmu(acoral_32 argc,acoral_char **argv)
+{
+    acoral_pmu_report();
+}
+/**
+ * @brief pmu命令结构体
+ * 
+ */
+acoral_ash_cmd_t pmu_cmd =
+{
+    .name = "pmu",
+    .exe = pmu,
+    .comment = "Show cycles, pmu events and samples of threads"
+};
+#endif
+
+#ifdef CFG_CRIT_PROF
+/**
+ * @brief ash终端命令之crit，带参数reset时清零统计
+ * 
+ * @param argc 参数数目
+ * @param argv 参数列表
+ */
+void crit(acoral_32 argc,acoral_char **argv)
+{
+    if(argc == 2 && acoral_str_cmp(argv[1], "reset") == 0)
+    {
+        acoral_crit_prof_reset();
+        return;
+    }
+    acoral_crit_prof_report();
+}
+/**
+ * @brief crit命令结构体
+ * 
+ */
+acoral_ash_cmd_t crit_cmd =
+{
+    .name = "crit",
+    .exe = crit,
+    .comment = "Show critical section stats, 'crit reset' to clear"
+};
+#endif
+
+#ifdef CFG_DAG_STAT
+/**
+ * @brief ash终端命令之dag
+ * 
+ * @param argc 参数数目
+ * @param argv 参数列表
+ */
+void dag(acoral_32 argc,acoral_char **argv)
+{
+    dag_stat_report();
+}
+/**
+ * @brief dag命令结构体
+ * 
+ */
+acoral_ash_cmd_t dag_cmd =
+{
+    .name = "dag",
+    .exe = dag,
+    .comment = "Show dag latency, deadline misses and critical paths"
+};
+#endif
+
 /**
  * @brief ash终端命令初始化
  * 
@@ -380,4 +525,19 @@ void ash_cmd_init()
     ash_cmd_register(&ls_cmd);
     ash_cmd_register(&cd_cmd);
     ash_cmd_register(&help_cmd);
+#ifdef CFG_CPU_USAGE
+    ash_cmd_register(&top_cmd);
+#endif
+#ifdef CFG_IRQ_STAT
+    ash_cmd_register(&irq_cmd);
+#endif
+#ifdef CFG_PMU
+    ash_cmd_register(&pmu_cmd);
+#endif
+#ifdef CFG_CRIT_PROF
+    ash_cmd_register(&crit_cmd);
+#endif
+#ifdef CFG_DAG_STAT
+    ash_cmd_register(&dag_cmd);
+#endif
 }
@@ -13,12 +13,13 @@
  *         <tr><td>v1.0 <td>胡博文 <td>2022-09-07 <td>增加注释
  *         <tr><td>v1.1 <td>胡博文 <td>2022-11-11 <td>改为中断方式
  *         <tr><td>v1.2 <td>胡博文 <td>2023-09-09 <td>减少中断运行内容
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>串口收发改用串口驱动
  */
 #include <acoral.h>
 #include <ff.h>
 #include <shell.h>
 #include <cmd.h>
-#include "xuartps.h"
+#include "uart.h"
 
 ///ash终端shell结构体实例
 struct ash_shell acoral_shell;
@@ -32,14 +33,6 @@ static int input_pos = 0;
 ///ash终端shell串口中断信号量
 acoral_ipc_t shell_sem;
 
-///ash终端shell串口结构体
-XUartPs UartPs;
-
-///ash终端shell串口设备ID
-#define UART_DEVICE_ID     XPAR_PS7_UART_0_DEVICE_ID
-///ash终端shell串口中断ID
-#define UART_INT_ID    XPAR_XUARTPS_0_INTR
-
 ///ash终端shell线程栈大小
 #define SHELL_STACK_SIZE 1024
 
@@ -131,7 +124,7 @@ void ash_cmd_process(struct ash_shell *shell)
     {
         acoral_sem_pend(&shell_sem);
         //获取缓冲区所有内容
-        while((shell_input[input_pos]==0)&&((recv_number = XUartPs_Recv(&UartPs, &shell_input[input_pos], 1))!=0))
+        while((shell_input[input_pos]==0)&&((recv_number = acoral_uart_read(&shell_input[input_pos], 1))!=0))
         {
             input_pos++;
             if(input_pos==ASH_CMD_SIZE)
@@ -280,7 +273,7 @@ void ash_cmd_process(struct ash_shell *shell)
                         {
                             shell->line[shell->line_curpos] = ch;
                             if(shell->echo_mode)
-                                outbyte(ch);
+                                acoral_uart_putc(ch);
                         }
                         shell->line_position++;
                         shell->line_curpos++;
@@ -314,57 +307,15 @@ void ash_shell_thread(void *args)
 
 
 
-void shell_uart_intr_handler(void *call_back_ref)
-{
-    XUartPs *uart_instance_ptr = (XUartPs *) call_back_ref;
-    u32 isr_status ;                           //中断状态标志
-    //读取中断ID寄存器，判断触发的是哪种中断
-    isr_status = XUartPs_ReadReg(uart_instance_ptr->Config.BaseAddress,
-                   XUARTPS_IMR_OFFSET);
-    isr_status &= XUartPs_ReadReg(uart_instance_ptr->Config.BaseAddress,
-                   XUARTPS_ISR_OFFSET);
-    //判断中断标志位RxFIFO是否触发
-    if (isr_status & (u32)XUARTPS_IXR_RXOVR)
-    {
-        acoral_sem_post(&shell_sem);
-    }
-    //清除中断标志
-    XUartPs_WriteReg(uart_instance_ptr->Config.BaseAddress,
-                        XUARTPS_ISR_OFFSET, isr_status) ;
-}
-
-//UART初始化函数
-static int shell_uart_init()
+/**
+ * @brief shell串口接收回调，在串口中断中调用，唤醒shell线程读取
+ * 
+ */
+static void shell_uart_rx(void)
 {
-    int status;
-    XUartPs_Config *uart_cfg;
-
-    uart_cfg = XUartPs_LookupConfig(UART_DEVICE_ID);
-    if (NULL == uart_cfg)
-        return XST_FAILURE;
-    status = XUartPs_CfgInitialize(&UartPs, uart_cfg, uart_cfg->BaseAddress);
-    if (status != XST_SUCCESS)
-        return XST_FAILURE;
-
-    //设置工作模式:正常模式
-    XUartPs_SetOperMode(&UartPs, XUARTPS_OPER_MODE_NORMAL);
-    //设置波特率:115200
-    XUartPs_SetBaudRate(&UartPs,115200);
-    //设置RxFIFO的中断触发等级
-    XUartPs_SetFifoThreshold(&UartPs, 1);
-
-    //为中断设置中断处理函数
-    XScuGic_Connect(&int_ctrl[0], UART_INT_ID,
-            (Xil_ExceptionHandler) shell_uart_intr_handler,(void *) &UartPs);
-    //设置UART的中断触发方式
-    XUartPs_SetInterruptMask(&UartPs, XUARTPS_IXR_RXOVR);
-    //使能GIC中的串口中断
-    XScuGic_Enable(&int_ctrl[0], UART_INT_ID);
-
-    return XST_SUCCESS;
+    acoral_sem_post(&shell_sem);
 }
 
-
 /**
  * @brief ash中断shell初始化
  * 
@@ -375,8 +326,9 @@ void acoral_ash_shell_init()
     acoral_comm_policy_data_t p_data;
 #endif
     ash_cmd_init();
-    shell_uart_init();
     acoral_sem_init(&shell_sem, 0);
+    acoral_uart_init();
+    acoral_uart_set_rx_hook(shell_uart_rx);
     acoral_shell.echo_mode = 1;
     acoral_shell.current_history = 0;
     acoral_shell.history_count = 0;
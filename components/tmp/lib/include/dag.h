@@ -11,11 +11,30 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2023-09-09 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>工作线程池执行器
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>节点自动映射与优先级分配
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>边缓冲区
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>流水执行
+ *         <tr><td>v1.5 <td>胡博文 <td>2026-10-19 <td>实例端到端延迟与关键路径统计
+ *         <tr><td>v1.6 <td>胡博文 <td>2026-10-19 <td>事件触发
+ *         <tr><td>v1.7 <td>胡博文 <td>2026-10-19 <td>多速率节点
+ *         <tr><td>v1.8 <td>胡博文 <td>2026-10-19 <td>流水执行时缓冲槽个数的下限
+ *         <tr><td>v1.9 <td>胡博文 <td>2026-10-19 <td>截止期为0时不做端到端检查
  */
 #ifndef LIB_DAG_H
 #define LIB_DAG_H
 #include <type.h>
 
+///用户节点手动指定标志：自动映射时保留processor
+#define ACORAL_DAG_FIX_CPU (1<<0)
+///用户节点手动指定标志：自动映射时保留prio
+#define ACORAL_DAG_FIX_PRIO (1<<1)
+
+///事件触发突发处理：到达间隔不足或在途实例已满时丢弃触发
+#define ACORAL_DAG_BURST_DROP 0
+///事件触发突发处理：到达间隔不足或在途实例已满时排队，条件满足后依次释放
+#define ACORAL_DAG_BURST_QUEUE 1
+
 /**
  * @brief 用户节点结构体
  * 
@@ -28,23 +47,74 @@ typedef struct{
     acoral_list_t list;///<用户节点链表
     acoral_u32 processor;///<所在的处理器
     acoral_u8 prio;///<优先级
+    acoral_time wcet;///<最坏执行时间(ms)，用于自动映射
+    acoral_u8 fixed;///<手动指定标志，自动映射时保留对应的processor/prio
+    const char *name;///<节点名称，用于统计输出，可为NULL
+    acoral_u16 rate;///<节点周期为dag周期的倍数，0与1均表示与dag同周期
 }acoral_dag_user_node;
 
+/**
+ * @brief 用户边缓冲区结构体，为一条边声明生产者到消费者的数据缓冲
+ * 
+ */
+typedef struct{
+    acoral_func_point prev_route;///<生产者节点执行函数
+    acoral_func_point next_route;///<消费者节点执行函数
+    acoral_u32 size;///<每个缓冲槽字节数
+    acoral_u8 depth;///<缓冲槽个数，1单缓冲，2双缓冲，3三缓冲；流水执行时小于在途实例数的按在途实例数分配，跨速率FIFO读取时还需加上速率比
+    acoral_list_t list;///<用户边缓冲区链表
+}acoral_dag_user_buf;
+
 /**
  * @brief 用户dag结构体
  * 
  */
 typedef struct{
-    acoral_time period_time;///<周期时间
+    acoral_time period_time;///<周期时间，0表示事件触发，由dag_trigger释放实例
+    acoral_time deadline;///<端到端截止期(ms)，0表示等于周期；事件触发(周期为0)时为0则不检查截止期
+    acoral_time min_interval;///<事件触发最小到达间隔(ms)
+    acoral_u8 burst;///<事件触发突发处理方式
     acoral_queue_t dag_user_node_queue;///<用户节点队列
+    acoral_queue_t dag_user_buf_queue;///<用户边缓冲区队列
     acoral_list_t list;///<用户dag链表
+    struct acoral_dag *dag;///<映射出的系统dag
 }acoral_dag_user;
 
+#ifdef CFG_DAG_STAT
 /**
- * @brief 系统节点结构体
+ * @brief dag实例统计结构体，时间单位均为ns
+ * 
+ */
+typedef struct{
+    acoral_u32 releases;///<释放的实例数
+    acoral_u32 completions;///<完成的实例数
+    acoral_u32 misses;///<端到端延迟超过截止期的实例数
+    acoral_u32 overruns;///<在途实例已达上限而跳过的释放次数
+    acoral_u32 drops;///<被丢弃的事件触发次数
+    acoral_u64 latency_max;///<最大端到端延迟，源节点释放到最后一个汇节点完成
+    acoral_u64 latency_avg;///<平均端到端延迟
+    acoral_u64 latency_total;///<端到端延迟总和
+    acoral_u32 hist[CFG_DAG_STAT_HIST_NUM];///<端到端延迟直方图，第i格为[2^i,2^(i+1))us
+}acoral_dag_stat_t;
+
+/**
+ * @brief dag节点统计结构体，时间单位均为ns
  * 
  */
 typedef struct{
+    acoral_u32 runs;///<执行次数
+    acoral_u32 critical;///<位于实例观测关键路径上的次数
+    acoral_u64 exec_max;///<最大执行时间，开始到完成
+    acoral_u64 exec_total;///<执行时间总和
+    acoral_u64 response_max;///<最大响应时间，实例释放到该节点完成
+}acoral_dag_node_stat_t;
+#endif
+
+/**
+ * @brief 系统节点结构体
+ * 
+ */
+typedef struct acoral_dag_node{
     void (*route)(void *args);///<dag执行函数
     void *args;///<dag执行函数参数
     acoral_u16 in_degree;///<入度，即前驱节点个数
@@ -52,31 +122,107 @@ typedef struct{
     acoral_list_t list;///<系统节点链表
     acoral_u32 processor;///<所在的处理器
     acoral_u8 prio;///<优先级
+    const char *name;///<节点名称
+    struct acoral_dag_edge *in_buf;///<带缓冲区的入边链
+    struct acoral_dag_edge *out_buf;///<带缓冲区的出边链
+    acoral_u32 instance;///<已完成的执行次数，决定本次使用的缓冲槽
+    acoral_u16 rate;///<节点周期为dag周期的倍数，在第k个dag实例中k%rate==0时激活
+#ifdef CFG_DAG_POOL
+    acoral_u16 pred_num;///<有效前驱个数（不含NULL前驱）
+    struct acoral_dag_node **pred;///<前驱节点数组
+    acoral_u16 pending[CFG_DAG_POOL_PIPELINE];///<各在途实例中尚未完成的前驱个数，上一实例未完成时多计自身
+    acoral_u32 finished;///<最近一次完成的实例序号加1
+    acoral_u16 succ_num;///<后继节点个数
+    struct acoral_dag_node **succ;///<后继节点数组
+    struct acoral_dag *dag;///<所属系统dag
+#endif
+#ifdef CFG_DAG_STAT
+    acoral_u64 start_ts[CFG_DAG_POOL_PIPELINE];///<各在途实例中开始执行时刻(cycles)
+    acoral_u64 finish_ts[CFG_DAG_POOL_PIPELINE];///<各在途实例中完成时刻(cycles)
+    acoral_dag_node_stat_t stat;///<节点统计
+#endif
+#ifdef CFG_DAG_AUTO_MAP
+    acoral_time wcet;///<最坏执行时间(ms)
+    acoral_u8 fixed;///<手动指定标志
+    acoral_time rank;///<向上排名，即到出口节点的关键路径长度(ms)
+    acoral_time finish;///<映射时估计的完成时刻(ms)
+#endif
 }acoral_dag_node;
 
 /**
  * @brief 系统边结构体
  * 
  */
-typedef struct{
+typedef struct acoral_dag_edge{
     acoral_dag_node *prev_node;///<前部系统节点
     acoral_dag_node *next_node;///<后部系统节点
     acoral_list_t list;///<系统边链表
+    void *buf;///<缓冲槽起始地址，NULL表示只同步不传数据
+    acoral_u32 buf_size;///<每个缓冲槽字节数
+    acoral_u32 buf_stride;///<缓冲槽间距，按cache行对齐
+    acoral_u8 buf_depth;///<缓冲槽个数
+    struct acoral_dag_edge *next_in;///<后部节点的下一条带缓冲区入边
+    struct acoral_dag_edge *next_out;///<前部节点的下一条带缓冲区出边
 }acoral_dag_edge;
 
 /**
  * @brief 系统dag结构体
  * 
  */
-typedef struct{
+typedef struct acoral_dag{
     acoral_time period_time;///<周期时间
     acoral_queue_t dag_node_queue;///<dag图节点队列
     acoral_queue_t dag_edge_queue;///<dag图边队列
     acoral_list_t list;///<系统dag链表
+#ifdef CFG_DAG_AUTO_MAP
+    acoral_time makespan;///<映射时估计的一个实例的完成时间(ms)
+#endif
+#ifdef CFG_DAG_POOL
+    acoral_u16 node_num;///<节点个数
+    acoral_u32 hyper;///<超周期包含的实例数，即各节点rate的最小公倍数
+    acoral_u16 remaining[CFG_DAG_POOL_PIPELINE];///<各在途实例中尚未完成的节点个数
+    acoral_u32 release;///<已释放的实例数
+    acoral_u32 complete;///<已完成的实例数
+    acoral_u32 overrun;///<在途实例已达上限而跳过的释放次数
+    acoral_soft_timer_t *timer;///<周期释放定时器，事件触发时为到达间隔定时器
+    void *event_arg[CFG_DAG_POOL_PIPELINE];///<各在途实例的触发参数
+    void *event_queue[CFG_DAG_POOL_EVENT_QUEUE];///<排队等待释放的触发参数
+    acoral_u8 event_head;///<排队触发队头
+    acoral_u8 event_num;///<排队触发个数
+    acoral_u8 burst;///<突发处理方式
+    acoral_u32 dropped;///<被丢弃的触发次数
+    acoral_u64 min_interval;///<最小到达间隔(cycles)
+    acoral_u64 last_release;///<上次释放时刻(cycles)
+#ifdef CFG_SMP
+    acoral_spinlock_t lock;///<节点计数自旋锁
+#endif
+#endif
+#ifdef CFG_DAG_STAT
+    acoral_time deadline;///<端到端截止期(ms)，0表示不检查
+    acoral_u64 release_ts[CFG_DAG_POOL_PIPELINE];///<各在途实例的释放时刻(cycles)
+    acoral_dag_stat_t stat;///<实例统计
+    acoral_dag_node **crit_path;///<最大延迟实例的观测关键路径，从汇节点到源节点
+    acoral_u16 crit_len;///<关键路径节点个数
+#endif
 }acoral_dag;
 
 void dag_user_init();
 void dag_decode();
 void dag_add_user_node(acoral_dag_user *dag_user, acoral_dag_user_node *user_node);
 void dag_add_user(acoral_dag_user *dag_user);
+void dag_add_user_buf(acoral_dag_user *dag_user, acoral_dag_user_buf *user_buf);
+void *dag_out_buf(acoral_func_point next_route);
+const void *dag_in_buf(acoral_func_point prev_route);
+acoral_u32 dag_in_count(acoral_func_point prev_route);
+const void *dag_in_fifo(acoral_func_point prev_route, acoral_u32 index);
+#ifdef CFG_DAG_POOL
+acoral_err dag_trigger(acoral_dag_user *dag_user, void *arg);
+acoral_id dag_trigger_on_sem(acoral_dag_user *dag_user, acoral_ipc_t *sem, acoral_u32 cpu, acoral_u8 prio);
+void *dag_event_arg(void);
+#endif
+#ifdef CFG_DAG_STAT
+acoral_err dag_stat_get(acoral_dag_user *dag_user, acoral_dag_stat_t *stat);
+acoral_err dag_stat_reset(acoral_dag_user *dag_user);
+void dag_stat_report(void);
+#endif
 #endif
@@ -0,0 +1,105 @@
+/**
+ * @file rta.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief component层lib库响应时间分析相关头文件，不依赖内核，可在主机端编译
+ * @version 1.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>从准入控制中抽出的响应时间分析
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>增量分析与迭代次数上限
+ */
+#ifndef LIB_RTA_H
+#define LIB_RTA_H
+#include <type.h>
+
+///响应时间分析结果：不可调度
+#define ACORAL_RTA_UNSCHED 0xffffffff
+///任务或资源未分配cpu
+#define ACORAL_RTA_NO_CPU 0xffffffff
+///支持的最大cpu数量
+#define ACORAL_RTA_MAX_CPU 32
+///增量分析中平均每个任务的最大重新计算次数，超过时按不可调度处理
+#define ACORAL_RTA_INCR_ROUND 4
+
+/**
+ * @brief 任务对资源的使用
+ *
+ */
+typedef struct{
+    acoral_u32 res;///<资源在资源表中的下标
+    acoral_u32 cnt;///<临界区次数
+    acoral_u32 len;///<最大临界区长度
+}acoral_rta_use_t;
+
+/**
+ * @brief dpcp资源
+ *
+ */
+typedef struct{
+    const acoral_char *name;///<资源名字
+    acoral_u32 cpu;///<资源代理所在cpu
+    acoral_u32 ceiling;///<优先级天花板
+    acoral_u8 global;///<是否为全局资源（被不同cpu上的任务使用）
+    acoral_u8 pinned;///<cpu已指定，不参与自动绑定
+}acoral_rta_res_t;
+
+/**
+ * @brief 周期任务，时间单位由使用者统一
+ *
+ */
+typedef struct{
+    const acoral_char *name;///<任务名字
+    acoral_u32 period;///<周期
+    acoral_u32 wcet;///<最坏执行时间
+    acoral_u32 dl;///<截止时间
+    acoral_u32 wcrt;///<最坏响应时间，作为其他任务的释放抖动使用，初始为截止时间
+    acoral_u32 response;///<最近一次分析得到的响应时间，不可调度时为ACORAL_RTA_UNSCHED
+    acoral_u32 cpu;///<所在cpu
+    acoral_u32 prio;///<优先级，数值越小优先级越高
+    acoral_u32 seq;///<放置顺序，资源绑定到最先放置的使用者所在cpu
+    acoral_rta_use_t *use;///<资源使用表
+    acoral_u32 use_num;///<资源使用数量
+    acoral_u8 skip;///<不参与分析，如尚未准入的任务
+    acoral_u8 mark;///<分析时内部使用
+    acoral_u32 nl;///<全局资源临界区总长度，分析时内部缓存
+    acoral_u32 wcrt_saved;///<增量分析前的wcrt，分析失败时恢复
+}acoral_rta_task_t;
+
+/**
+ * @brief 某个cpu上时间确定性任务的时间表
+ *
+ */
+typedef struct{
+    acoral_u32 h_period;///<超周期
+    acoral_u32 slot_num;///<时间段数量
+    const acoral_u32 *start;///<各时间段起始时刻，从小到大
+    const acoral_u32 *len;///<各时间段长度
+}acoral_rta_timed_t;
+
+/**
+ * @brief 任务集
+ *
+ */
+typedef struct{
+    acoral_rta_task_t *task;///<任务表
+    acoral_u32 task_num;///<任务数量
+    acoral_rta_res_t *res;///<资源表
+    acoral_u32 res_num;///<资源数量
+    const acoral_rta_timed_t *timed;///<各cpu时间表，可为NULL
+    acoral_u32 cpu_num;///<cpu数量，不超过ACORAL_RTA_MAX_CPU
+    acoral_u32 iter_max;///<单个不动点迭代的最大次数，超过时按不可调度处理，0为不限制
+}acoral_rta_set_t;
+
+acoral_u32 acoral_rta_response_time(acoral_rta_set_t *set, acoral_u32 index);
+acoral_bool acoral_rta_analyse(acoral_rta_set_t *set);
+acoral_bool acoral_rta_analyse_incr(acoral_rta_set_t *set, acoral_u32 index);
+void acoral_rta_bind_res(acoral_rta_set_t *set);
+acoral_u32 acoral_rta_cpu_load(acoral_rta_set_t *set, acoral_u32 cpu);
+void acoral_rta_assign_prio(acoral_rta_set_t *set, acoral_u32 prio_base, acoral_u32 prio_step);
+acoral_u32 acoral_rta_partition(acoral_rta_set_t *set);
+#endif
@@ -11,6 +11,8 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-11-11 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>响应时间分析移至rta库
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>增量响应时间分析，cpu负载改为整数
  */
 #include <admis_ctl.h>
 #include <mem.h>
@@ -21,7 +23,7 @@
 #include <cpu.h>
 #include <ipi.h>
 #include <str.h>
-#include <math.h>
+#include <rta.h>
 
 /**
  * @brief 资源数据缓存
@@ -47,20 +49,50 @@ extern acoral_u32 acoral_timed_h_period[CFG_MAX_CPU];
 #define CPU_LOAD_LAST 0
 ///cpu负载：现在状态
 #define CPU_LOAD_THIS 1
+///响应时间分析：最大任务数量
+#define ADMIS_RTA_MAX_TASK 32
+///响应时间分析：最大资源数量
+#define ADMIS_RTA_MAX_RES 16
+///响应时间分析：最大资源使用数量
+#define ADMIS_RTA_MAX_USE 64
+///响应时间分析：最大时间段数量
+#define ADMIS_RTA_MAX_SLOT 64
+///响应时间分析：单个不动点迭代的最大次数
+#define ADMIS_RTA_ITER_MAX 100
+///cpu负载单位：百万分之一
+#define CPU_LOAD_SCALE 1000000
 ///准入控制线程id
 acoral_id admis_ctl_task_id;
 ///准入控制数据表队列
 acoral_queue_t acoral_admis_ctl_queue;
 ///系统新加线程状态位
 acoral_u8 acoral_have_new_thread = 0;
-///cpu负载
-static acoral_fl cpu_load[2][CFG_MAX_CPU];
+///cpu负载（百万分之一）
+static acoral_u32 cpu_load[2][CFG_MAX_CPU];
 ///cpu负载列表（从小到大）
 static acoral_u8 cpu_load_list[CFG_MAX_CPU];
 ///周期任务数量
 static acoral_u8 task_cnt = 0;
 ///时间确定性任务总执行时间（一个超周期内）
 static acoral_u32 timed_time_sum[CFG_MAX_CPU];
+///响应时间分析：任务表
+static acoral_rta_task_t admis_rta_task[ADMIS_RTA_MAX_TASK];
+///响应时间分析：任务表对应的准入控制数据表
+static acoral_admis_ctl_data *admis_rta_ctl[ADMIS_RTA_MAX_TASK];
+///响应时间分析：资源表
+static acoral_rta_res_t admis_rta_res[ADMIS_RTA_MAX_RES];
+///响应时间分析：资源表对应的dpcp资源
+static acoral_dpcp_t *admis_rta_dpcp[ADMIS_RTA_MAX_RES];
+///响应时间分析：资源使用表
+static acoral_rta_use_t admis_rta_use[ADMIS_RTA_MAX_USE];
+///响应时间分析：时间表
+static acoral_rta_timed_t admis_rta_timed[CFG_MAX_CPU];
+///响应时间分析：时间段起始时刻
+static acoral_u32 admis_rta_slot_start[ADMIS_RTA_MAX_SLOT];
+///响应时间分析：时间段长度
+static acoral_u32 admis_rta_slot_len[ADMIS_RTA_MAX_SLOT];
+///响应时间分析：任务集
+static acoral_rta_set_t admis_rta = {admis_rta_task, 0, admis_rta_res, 0, admis_rta_timed, CFG_MAX_CPU, ADMIS_RTA_ITER_MAX};
 
 
 /**
@@ -91,10 +123,10 @@ void acoral_admis_ctl_change_res(acoral_admis_res_data *res_data)
  */
 static void cpu_load_list_update(void)
 {
-    acoral_fl cpu_load_tmp[CFG_MAX_CPU];
-    acoral_fl tmp_fl;
+    acoral_u32 cpu_load_tmp[CFG_MAX_CPU];
+    acoral_u32 tmp_u32;
     acoral_u8 tmp_u8;
-    acoral_memcpy(cpu_load_tmp, cpu_load[CPU_LOAD_THIS], sizeof(acoral_fl)*CFG_MAX_CPU);
+    acoral_memcpy(cpu_load_tmp, cpu_load[CPU_LOAD_THIS], sizeof(acoral_u32)*CFG_MAX_CPU);
     for(int i=0;i<CFG_MAX_CPU;i++)//计算表调度任务的负载
     {
         cpu_load_list[i] = i;
@@ -105,11 +137,11 @@ static void cpu_load_list_update(void)
         {
             if(cpu_load_tmp[i]>cpu_load_tmp[i+j])
             {
-                tmp_fl = cpu_load_tmp[i];
+                tmp_u32 = cpu_load_tmp[i];
                 tmp_u8 = cpu_load_list[i];
                 cpu_load_tmp[i] = cpu_load_tmp[i+j];
                 cpu_load_list[i] = cpu_load_list[i+j];
-                cpu_load_tmp[i+j] = tmp_fl;
+                cpu_load_tmp[i+j] = tmp_u32;
                 cpu_load_list[i+j] = tmp_u8;
             }
         }
@@ -120,14 +152,14 @@ static void cpu_load_list_update(void)
  * @brief 实时任务中全局资源临界区的资源利用率
  *
  * @param dpcp dpcp资源结构体指针的指针
- * @return acoral_fl 资源利用率
+ * @return acoral_u32 资源利用率（百万分之一）
  */
-static acoral_fl u_g_time(acoral_dpcp_t **dpcp)
+static acoral_u32 u_g_time(acoral_dpcp_t **dpcp)
 {
     acoral_list_t *ctl_head,*res_head,*ctl_tmp,*res_tmp;
     acoral_admis_ctl_data *ctl_data;
     acoral_admis_res_data *res_data;
-    acoral_fl ret = 0;
+    acoral_u32 ret = 0;
     ctl_head = &acoral_admis_ctl_queue.head;
     for(ctl_tmp=ctl_head->prev;ctl_tmp!=ctl_head;ctl_tmp=ctl_tmp->prev)
     {
@@ -138,7 +170,7 @@ static acoral_fl u_g_time(acoral_dpcp_t **dpcp)
             res_data = list_entry(res_tmp, acoral_admis_res_data, list);
             if(dpcp==res_data->dpcp)
             {
-                ret += (acoral_fl)(res_data->critical_cnt*res_data->length_max)/(acoral_fl)ctl_data->period_time;
+                ret += (acoral_u64)res_data->critical_cnt*res_data->length_max*CPU_LOAD_SCALE/ctl_data->period_time;
                 break;
             }
         }
@@ -147,412 +179,116 @@ static acoral_fl u_g_time(acoral_dpcp_t **dpcp)
 }
 
 /**
- * @brief 局部资源延迟
+ * @brief 由准入控制数据表构建响应时间分析用的任务集
  *
- * @param data 准入控制数据表指针
- * @return acoral_u32 延迟时间
+ * @return acoral_bool 是否构建成功，超出分析表容量时失败
  */
-static acoral_u32 latency_b_time(acoral_admis_ctl_data *data)
+static acoral_bool admis_rta_build(void)
 {
-    acoral_list_t *ctl_head,*res_head,*ctl_tmp,*res_tmp;
+    acoral_list_t *ctl_head,*res_head,*ctl_tmp,*res_tmp,*head,*tmp;
     acoral_admis_ctl_data *ctl_data;
     acoral_admis_res_data *res_data;
     admis_res_cache *res_cache;
-    acoral_u8 global_n = 0;
-    acoral_u32 local_l_max = 0;
-    res_head = &data->res_queue.head;
-    for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
-    {
-        res_data = list_entry(res_tmp, acoral_admis_res_data, list);
-        res_cache = (admis_res_cache *)(*res_data->dpcp)->data;
-        if(res_cache->type_cache==ACORAL_DPCP_GLOBAL)//轮询全局资源，计算获取全局资源次数
-            global_n += res_data->critical_cnt;
-    }
-    ctl_head = &acoral_admis_ctl_queue.head;
-    for(ctl_tmp=ctl_head->prev;ctl_tmp!=ctl_head;ctl_tmp=ctl_tmp->prev)
+    acoral_rta_task_t *task;
+    acoral_rta_use_t *use;
+    acoral_u32 r,slot=0,use_num=0;
+    admis_rta.task_num = 0;
+    admis_rta.res_num = 0;
+    for(int i=0;i<CFG_MAX_CPU;i++)//时间确定性任务时间表，每两个节点为起始时刻与长度
     {
-        ctl_data = list_entry(ctl_tmp, acoral_admis_ctl_data, list);
-        if(ctl_data->cpu==data->cpu&&ctl_data->prio>data->prio)
+        admis_rta_timed[i].h_period = acoral_timed_h_period[i];
+        admis_rta_timed[i].start = &admis_rta_slot_start[slot];
+        admis_rta_timed[i].len = &admis_rta_slot_len[slot];
+        admis_rta_timed[i].slot_num = 0;
+        head = &acoral_timed_time[i].head;
+        for(tmp=head->next;tmp!=head&&tmp->next!=head;tmp=tmp->next->next)
         {
-            res_head = &ctl_data->res_queue.head;
-            for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
-            {
-                res_data = list_entry(res_tmp, acoral_admis_res_data, list);
-                res_cache = (admis_res_cache *)(*res_data->dpcp)->data;
-                if(res_cache->type_cache==ACORAL_DPCP_LOCAL&&res_cache->ceiling_cache<data->prio)
-                {
-                    if(res_data->length_max>local_l_max)//计算此核局部资源使用最长临界区
-                        local_l_max = res_data->length_max;
-                }
-            }
+            if(slot>=ADMIS_RTA_MAX_SLOT)
+                return false;
+            admis_rta_slot_start[slot] = tmp->value;
+            admis_rta_slot_len[slot] = tmp->next->value;
+            admis_rta_timed[i].slot_num++;
+            slot++;
         }
-        else if(ctl_data->prio<=data->prio)
-            break;
     }
-    return (global_n+1)*local_l_max;
-}
-
-/**
- * @brief 非全局资源临界区延迟
- *
- * @param t 迭代延迟
- * @param data 准入控制数据表指针
- * @return acoral_u32 延迟时间
- */
-static acoral_u32 latency_ng_time(acoral_u32 t, acoral_admis_ctl_data *data)
-{
-    acoral_list_t *ctl_head,*res_head,*ctl_tmp,*res_tmp;
-    acoral_admis_ctl_data *ctl_data;
-    acoral_admis_res_data *res_data;
-    admis_res_cache *res_cache;
-    acoral_u32 c_ng = 0;
-    acoral_u32 ret = 0;
     ctl_head = &acoral_admis_ctl_queue.head;
     for(ctl_tmp=ctl_head->next;ctl_tmp!=ctl_head;ctl_tmp=ctl_tmp->next)
     {
         ctl_data = list_entry(ctl_tmp, acoral_admis_ctl_data, list);
-        if(ctl_data->cpu==data->cpu&&ctl_data->prio<data->prio)
-        {
-            c_ng = ctl_data->wcet;
-            res_head = &ctl_data->res_queue.head;
-            for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
-            {
-                res_data = list_entry(res_tmp, acoral_admis_res_data, list);
-                res_cache = (admis_res_cache *)(*res_data->dpcp)->data;
-                if(res_cache->type_cache == ACORAL_DPCP_GLOBAL)
-                {
-                    c_ng -= (res_data->critical_cnt*res_data->length_max);
-                }
-            }
-            ret += ceil((acoral_fl)(t + ctl_data->wcrt - c_ng)/(acoral_fl)ctl_data->period_time)*c_ng;
-        }
-        else if(ctl_data->prio>=data->prio)
-            break;
-    }
-    return ret;
-}
-
-/**
- * @brief
- *
- * @param t
- * @param cpu
- * @return acoral_u32
- */
-static acoral_u32 epsilon(acoral_u32 t, acoral_u32 cpu)
-{
-    acoral_list_t *head,*tmp;
-    acoral_u32 ret = 0;
-    head = &acoral_timed_time[cpu].head;
-    for(tmp=head->next;tmp!=head;tmp=tmp->next->next)
-    {
-        if(tmp->value<t)
-            ret += tmp->next->value;
-        else
-            break;
-    }
-    return ret;
-}
-/**
- * @brief 时间确定性任务抢占延迟
- *
- * @param t 迭代延迟
- * @param cpu 所在cpu
- * @return acoral_u32 延迟时间
- */
-static acoral_u32 latency_t_time(acoral_u32 t, acoral_u32 cpu)
-{
-    acoral_u32 latency_t_max = 0,latency_t_time = 0;
-    acoral_list_t *head,*tmp;
-    head = &acoral_timed_time[cpu].head;
-    for(tmp=head->next;tmp!=head;tmp=tmp->next->next)
-    {
-        latency_t_time = timed_time_sum[cpu]*floor((acoral_fl)(tmp->value+t)/(acoral_fl)acoral_timed_h_period[cpu])
-                + epsilon((tmp->value+t)%acoral_timed_h_period[cpu], cpu) - epsilon(tmp->value, cpu);
-        if(latency_t_time>latency_t_max)
-            latency_t_max = latency_t_time;
-    }
-    return latency_t_max;
-}
-
-/**
- * @brief 单次请求单个全局资源的延迟
- *
- * @param start 迭代开始延迟
- * @param cpu 所在cpu
- * @param data 准入控制数据表指针
- * @return acoral_u32 延迟时间
- */
-acoral_u32 h_g_time(acoral_u32 start, acoral_u32 cpu, acoral_admis_ctl_data *data)
-{
-    acoral_list_t *ctl_head,*res_head,*ctl_tmp,*res_tmp,*head,*tmp;
-    acoral_admis_ctl_data *ctl_data;
-    acoral_admis_res_data *res_data;
-    acoral_dpcp_t *dpcp_tmp;
-    acoral_u32 test_end = data->dl_time;
-    acoral_u32 h_g = start;
-    acoral_u32 h_g_temp = start;
-    acoral_u32 NL_higher = 0;
-    ctl_head = &acoral_admis_ctl_queue.head;
-    head = &acoral_dpcp_queue[ACORAL_DPCP_GLOBAL][cpu].head;
-    while(h_g <= test_end)
-    {
-        h_g_temp = start;
-        for(tmp=head->next;tmp!=head;tmp=tmp->next)//轮询该核全局资源
+        if(ctl_data->is_new)//未准入的任务不参与分析
+            continue;
+        if(admis_rta.task_num>=ADMIS_RTA_MAX_TASK)
+            return false;
+        admis_rta_ctl[admis_rta.task_num] = ctl_data;
+        task = &admis_rta_task[admis_rta.task_num++];
+        task->name = ctl_data->name;
+        task->period = ctl_data->period_time;
+        task->wcet = ctl_data->wcet;
+        task->dl = ctl_data->dl_time;
+        task->wcrt = ctl_data->wcrt;
+        task->response = ctl_data->wcrt;
+        task->cpu = ctl_data->cpu;
+        task->prio = ctl_data->prio;
+        task->seq = 0;
+        task->use = &admis_rta_use[use_num];
+        task->use_num = 0;
+        task->skip = 0;
+        res_head = &ctl_data->res_queue.head;
+        for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
         {
-            dpcp_tmp = list_entry(tmp, acoral_dpcp_t, list);
-            for(ctl_tmp=ctl_head->next;ctl_tmp!=ctl_head;ctl_tmp=ctl_tmp->next)//轮询任务
+            res_data = list_entry(res_tmp, acoral_admis_res_data, list);
+            for(r=0;r<admis_rta.res_num;r++)//dpcp资源映射为资源表下标
             {
-                ctl_data = list_entry(ctl_tmp, acoral_admis_ctl_data, list);
-                if(ctl_data->prio<data->prio)
-                {
-                    res_head = &ctl_data->res_queue.head;
-                    for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
-                    {
-                        res_data = list_entry(res_tmp, acoral_admis_res_data, list);
-                        if((*res_data->dpcp)==dpcp_tmp)
-                        {
-                            NL_higher = res_data->critical_cnt*res_data->length_max;
-                            h_g_temp += ceil((acoral_fl)(h_g + ctl_data->wcrt - NL_higher)/(acoral_fl)ctl_data->period_time)*NL_higher;
-                        }
-                    }
-                }
-                else
+                if(admis_rta_dpcp[r]==(*res_data->dpcp))
                     break;
             }
-        }
-        h_g_temp += latency_t_time(h_g, cpu);
-        if(h_g==h_g_temp)
-        {
-            return h_g;
-        }
-        else
-            h_g = h_g_temp;
-    }
-    return test_end + 100;
-}
-/**
- * @brief 请求全局资源的延迟
- *
- * @param t 迭代延迟
- * @param data 准入控制数据表指针
- * @return acoral_u32 延迟时间
- */
-acoral_u32 latency_g_time(acoral_u32 t, acoral_admis_ctl_data *data)
-{
-    acoral_list_t *ctl_head,*res_head,*ctl_tmp,*res_tmp,*head,*tmp,*tmp1;
-    acoral_admis_ctl_data *ctl_data;
-    acoral_admis_res_data *res_data;
-    admis_res_cache *res_cache;
-    acoral_dpcp_t *dpcp_tmp,*dpcp_tmp1;
-    acoral_u8 flag = 0;
-    acoral_u32 NL_other = 0,N_this = 0,L_this = 0;
-    acoral_u32 PD_g = 0,DD_g = 0;
-    acoral_u32 h_g_bound = 0;
-    acoral_u32 global_l_max = 0;
-    acoral_u32 ret = 0;
-    ctl_head = &acoral_admis_ctl_queue.head;
-    for(int i=0;i<CFG_MAX_CPU;i++)
-    {
-        head = &acoral_dpcp_queue[ACORAL_DPCP_GLOBAL][i].head;
-        if(data->cpu==i)
-        {
-            for(tmp=head->next;tmp!=head;tmp=tmp->next)//轮询该核全局资源
-            {
-                dpcp_tmp = list_entry(tmp, acoral_dpcp_t, list);
-                for(ctl_tmp=ctl_head->next;ctl_tmp!=ctl_head;ctl_tmp=ctl_tmp->next)//轮询任务
-                {
-                    ctl_data = list_entry(ctl_tmp, acoral_admis_ctl_data, list);
-                    if(ctl_data!=data)
-                    {
-                        res_head = &ctl_data->res_queue.head;
-                        for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
-                        {
-                            res_data = list_entry(res_tmp, acoral_admis_res_data, list);
-                            if((*res_data->dpcp)==dpcp_tmp)//找到使用该核全局资源的任务
-                            {
-                                NL_other = res_data->critical_cnt*res_data->length_max;
-                                ret += ceil((acoral_fl)(t + ctl_data->wcrt - NL_other)/(acoral_fl)ctl_data->period_time)*NL_other;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else
-        {
-            for(tmp=head->next;tmp!=head;tmp=tmp->next)//轮询该核全局资源
-            {
-                dpcp_tmp = list_entry(tmp, acoral_dpcp_t, list);
-                res_head = &data->res_queue.head;
-                for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
-                {
-                    res_data = list_entry(res_tmp, acoral_admis_res_data, list);
-                    if((*res_data->dpcp)==dpcp_tmp)//查看此任务是否使用该核全局资源
-                    {
-                        flag = 1;
-                    }
-                }
-            }
-            if(flag==0)//此任务不会使用该核全局资源
-                continue;
-            for(tmp=head->next;tmp!=head;tmp=tmp->next)//轮询该核全局资源
+            if(r==admis_rta.res_num)
             {
-                dpcp_tmp = list_entry(tmp, acoral_dpcp_t, list);
-                for(ctl_tmp=ctl_head->next;ctl_tmp!=ctl_head;ctl_tmp=ctl_tmp->next)
-                {
-                    ctl_data = list_entry(ctl_tmp, acoral_admis_ctl_data, list);
-                    if(ctl_data==data)//此任务
-                    {
-                        res_head = &ctl_data->res_queue.head;
-                        for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
-                        {
-                            res_data = list_entry(res_tmp, acoral_admis_res_data, list);
-                            if((*res_data->dpcp)==dpcp_tmp)//查看此任务是否使用该核全局资源
-                            {
-                                PD_g += res_data->critical_cnt*res_data->length_max;//NL_i
-                            }
-                        }
-                    }
-                    else//其他任务
-                    {
-                        res_head = &ctl_data->res_queue.head;
-                        for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
-                        {
-                            res_data = list_entry(res_tmp, acoral_admis_res_data, list);
-                            if((*res_data->dpcp)==dpcp_tmp)//找到使用该核全局资源的任务
-                            {
-                                NL_other = res_data->critical_cnt*res_data->length_max;//NL_other
-                                PD_g += ceil((acoral_fl)(t + ctl_data->wcrt - NL_other)/(acoral_fl)ctl_data->period_time)*NL_other;
-                            }
-                        }
-                    }
-                }
-            }
-            PD_g += latency_t_time(t, i);//PD_g计算完成
-            for(tmp=head->next;tmp!=head;tmp=tmp->next)//轮询该核全局资源
-            {
-                dpcp_tmp = list_entry(tmp, acoral_dpcp_t, list);
-                res_head = &data->res_queue.head;
-                for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
-                {
-                    res_data = list_entry(res_tmp, acoral_admis_res_data, list);
-                    if((*res_data->dpcp)==dpcp_tmp)//查看此任务是否使用该核全局资源
-                    {
-                        N_this = res_data->critical_cnt;
-                        L_this = res_data->length_max;
-                    }
-                }
-                for(tmp1=head->next;tmp1!=head;tmp1=tmp1->next)//轮询该核全局资源
-                {
-                    dpcp_tmp1 = list_entry(tmp1, acoral_dpcp_t, list);
-                    if(dpcp_tmp1->cpu==dpcp_tmp->cpu)
-                    {
-                        for(ctl_tmp=ctl_head->next;ctl_tmp!=ctl_head;ctl_tmp=ctl_tmp->next)
-                        {
-                            ctl_data = list_entry(ctl_tmp, acoral_admis_ctl_data, list);
-                            if(ctl_data->prio>data->prio)
-                            {
-                                res_head = &ctl_data->res_queue.head;
-                                for(res_tmp=res_head->next;res_tmp!=res_head;res_tmp=res_tmp->next)
-                                {
-                                    res_data = list_entry(res_tmp, acoral_admis_res_data, list);
-                                    res_cache = (admis_res_cache *)(*res_data->dpcp)->data;
-                                    if((*res_data->dpcp)==dpcp_tmp1&&res_cache->ceiling_cache<data->prio)//查看此任务是否使用该核全局资源
-                                    {
-                                        if(res_data->length_max>global_l_max)
-                                            global_l_max = res_data->length_max;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-                h_g_bound = h_g_time(L_this + global_l_max, i, data);
-                if(h_g_bound<=data->dl_time)
-                {
-                    DD_g += N_this*h_g_bound;
-                }
-                else
-                    return data->dl_time + 100;
+                if(r>=ADMIS_RTA_MAX_RES)
+                    return false;
+                res_cache = (admis_res_cache *)(*res_data->dpcp)->data;
+                admis_rta_dpcp[r] = (*res_data->dpcp);
+                admis_rta_res[r].name = NULL;
+                admis_rta_res[r].cpu = (*res_data->dpcp)->cpu==UNBIND_CPU?ACORAL_RTA_NO_CPU:(*res_data->dpcp)->cpu;
+                admis_rta_res[r].ceiling = res_cache->ceiling_cache;
+                admis_rta_res[r].global = res_cache->type_cache==ACORAL_DPCP_GLOBAL;
+                admis_rta_res[r].pinned = 1;
+                admis_rta.res_num++;
             }
-            if(PD_g<DD_g)
-                ret += PD_g;
-            else
-                ret += DD_g;
-        }
-    }
-    return ret;
-}
-
-/**
- * @brief 总延迟时间迭代
- *
- * @param data 准入控制数据表指针
- * @return acoral_u32 总延迟时间
- */
-static acoral_u32 response_time(acoral_admis_ctl_data *data)
-{
-    acoral_u32 test_end = data->dl_time;
-    acoral_u32 response = data->wcet;
-    acoral_u32 response_temp = data->wcet;
-    acoral_u32 latency_b = 0, latency_ng = 0, latency_t = 0, latency_g = 0;
-    while(response <= test_end)
-    {
-        response_temp = data->wcet;
-
-        latency_ng = latency_ng_time(response, data);
-        if(latency_ng > test_end)
-            return test_end + 100;
-        else
-            response_temp += latency_ng;
-        latency_t = latency_t_time(response, data->cpu);
-        if(latency_t > test_end)
-            return test_end + 100;
-        else
-            response_temp += latency_t;
-        latency_g = latency_g_time(response, data);
-        if(latency_g > test_end)
-            return test_end + 100;
-        else
-            response_temp += latency_g;
-        if(response==response_temp)
-        {
-            latency_b = latency_b_time(data);
-            if(latency_b > test_end)
-                return test_end + 100;
-            else
-                return response + latency_b;
+            if(use_num>=ADMIS_RTA_MAX_USE)
+                return false;
+            use = &admis_rta_use[use_num++];
+            use->res = r;
+            use->cnt = res_data->critical_cnt;
+            use->len = res_data->length_max;
+            task->use_num++;
         }
-        else
-            response = response_temp;
     }
-    return test_end + 100;
+    return true;
 }
 
 /**
- * @brief 可调度性分析
+ * @brief 可调度性分析，已准入任务的最坏响应时间为上次分析结果，只重新计算受新任务影响的任务
  *
+ * @param new_data 新加线程的准入控制数据表指针
  * @return acoral_bool 是否可行
  */
-static acoral_bool schedule_ansys()
+static acoral_bool schedule_ansys(acoral_admis_ctl_data *new_data)
 {
-    acoral_u32 response_bound;
-    acoral_list_t *ctl_head,*ctl_tmp;
-    acoral_admis_ctl_data *ctl_data;
-    ctl_head = &acoral_admis_ctl_queue.head;
-    for(ctl_tmp=ctl_head->next;ctl_tmp!=ctl_head;ctl_tmp=ctl_tmp->next)
+    acoral_u32 i;
+    if(!admis_rta_build())
+        return false;
+    for(i=0;i<admis_rta.task_num;i++)
     {
-        ctl_data = list_entry(ctl_tmp, acoral_admis_ctl_data, list);
-        if(ctl_data->is_new!=1)
-        {
-            response_bound = response_time(ctl_data);
-            if(response_bound<=ctl_data->dl_time)
-                ctl_data->wcrt = response_bound;
-            else
-                return false;
-        }
+        if(admis_rta_ctl[i]==new_data)
+            break;
     }
+    if(i==admis_rta.task_num)
+        return false;
+    if(!acoral_rta_analyse_incr(&admis_rta, i))
+        return false;
+    for(acoral_u32 i=0;i<admis_rta.task_num;i++)//全部可调度才更新最坏响应时间
+        admis_rta_ctl[i]->wcrt = admis_rta_task[i].wcrt;
     return true;
 }
 /**
@@ -713,7 +449,7 @@ void acoral_admis_ctl_task(void *args)
                 for(int i=0;i<CFG_MAX_CPU;i++)
                 {
                     ctl_data->cpu = cpu_load_list[i];//分配cpu
-                    cpu_load[CPU_LOAD_THIS][ctl_data->cpu] += (acoral_fl)ctl_data->wcet/(acoral_fl)ctl_data->period_time;//+Ca/Ta
+                    cpu_load[CPU_LOAD_THIS][ctl_data->cpu] += (acoral_u64)ctl_data->wcet*CPU_LOAD_SCALE/ctl_data->period_time;//+Ca/Ta
                     if(first_thread)
                     {
                         ctl_data->prio = FIRST_PRIO;
@@ -765,11 +501,11 @@ void acoral_admis_ctl_task(void *args)
                             res_cache->ceiling_cache = ctl_data->prio;
                         if(res_cache->type_cache == ACORAL_DPCP_GLOBAL)
                         {
-                            cpu_load[CPU_LOAD_THIS][ctl_data->cpu] -= (acoral_fl)(res_data->critical_cnt*res_data->length_max)/(acoral_fl)ctl_data->period_time;
+                            cpu_load[CPU_LOAD_THIS][ctl_data->cpu] -= (acoral_u64)res_data->critical_cnt*res_data->length_max*CPU_LOAD_SCALE/ctl_data->period_time;
                         }
                     }
                     ctl_data->is_new = 0;
-                    admis_ok = schedule_ansys();
+                    admis_ok = schedule_ansys(ctl_data);
                     ctl_data->is_new = 1;
                     if(admis_ok)//可行
                     {
@@ -1055,7 +791,7 @@ void acoral_admis_ctl_init(acoral_u32 cpu, acoral_u32 max_time_min)
             tmp->value -= tmp->prev->value;
             timed_time_sum[i] += tmp->value;
         }
-        cpu_load[CPU_LOAD_LAST][i] += (acoral_fl)timed_time_sum[i]/(acoral_fl)acoral_timed_h_period[i];
+        cpu_load[CPU_LOAD_LAST][i] += (acoral_u64)timed_time_sum[i]*CPU_LOAD_SCALE/acoral_timed_h_period[i];
         cpu_load[CPU_LOAD_THIS][i] = cpu_load[CPU_LOAD_LAST][i];
     }
 }
@@ -11,6 +11,19 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2023-09-09 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>工作线程池执行器，就绪节点进入各cpu双端队列并跨cpu窃取
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>按关键路径排名自动映射cpu与优先级
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>边缓冲区，生产者写入本次槽，消费者只读获取，按执行次数轮转
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>工作线程池流水执行，多个实例同时在途
+ *         <tr><td>v1.5 <td>胡博文 <td>2026-10-19 <td>实例端到端延迟直方图、截止期检查、节点响应时间与观测关键路径
+ *         <tr><td>v1.6 <td>胡博文 <td>2026-10-19 <td>事件触发释放实例，最小到达间隔与突发丢弃/排队
+ *         <tr><td>v1.7 <td>胡博文 <td>2026-10-19 <td>多速率节点，按超周期激活，跨速率边最新值/FIFO采样
+ *         <tr><td>v1.8 <td>胡博文 <td>2026-10-19 <td>触发参数按激活所在实例取；线程映射拒绝多速率dag
+ *         <tr><td>v1.9 <td>胡博文 <td>2026-10-19 <td>流水执行时缓冲槽个数不少于在途实例数
+ *         <tr><td>v1.10 <td>胡博文 <td>2026-10-19 <td>截止期为0时不做端到端检查
+ *         <tr><td>v1.11 <td>胡博文 <td>2026-10-19 <td>工作线程池按节点优先级取就绪节点
+ *         <tr><td>v1.12 <td>胡博文 <td>2026-10-19 <td>自动映射检测环，有环的dag不启动
+ *         <tr><td>v1.13 <td>胡博文 <td>2026-10-19 <td>创建时清空关键路径
  */
 #include <acoral.h>
 ///系统dag数据结构队列
@@ -28,6 +41,7 @@ typedef struct{
     acoral_ipc_t *post_ipc;///<要释放的信号量指针
     void (*dag_route)(void *args);///<dag执行函数
     void *dag_args;///<dag执行函数参数
+    acoral_dag_node *node;///<正在执行的系统节点，用于查找边缓冲区
 }dag_task_data_t;
 
 /**
@@ -51,9 +65,19 @@ static void dag_node_init(acoral_dag *dag, acoral_dag_user_node *user_node)
     node = acoral_malloc(sizeof(acoral_dag_node));
     node->in_degree = user_node->prev_count;
     node->route = user_node->route;
+    node->args = user_node->args;
     node->sem = acoral_sem_create(0);
     node->processor = user_node->processor;
     node->prio = user_node->prio;
+    node->name = user_node->name;
+    node->rate = user_node->rate>1?user_node->rate:1;
+#ifdef CFG_DAG_AUTO_MAP
+    node->wcet = user_node->wcet;
+    node->fixed = user_node->fixed;
+#endif
+    node->in_buf = NULL;
+    node->out_buf = NULL;
+    node->instance = 0;
     acoral_list_init(&node->list);
     acoral_lifo_queue_add(&dag->dag_node_queue, &node->list);
 }
@@ -100,6 +124,9 @@ static void dag_edge_init(acoral_dag *dag, acoral_dag_user_node *user_node)
     {
         edge = acoral_malloc(sizeof(acoral_dag_edge));
         edge->next_node = next_node;
+        edge->buf = NULL;
+        edge->next_in = NULL;
+        edge->next_out = NULL;
         if((void *)user_node->prev_route[i] == NULL)
         {
             prev_node = NULL;
@@ -142,6 +169,248 @@ static void dag_edge_create(acoral_dag *dag, acoral_dag_user *dag_user)
     }
 }
 
+/**
+ * @brief 一个系统dag的所有边缓冲区的创建，缓冲槽按cache行对齐，
+ *        不同cpu上的生产者与消费者同时访问相邻槽时不会伪共享
+ * 
+ * @param dag 系统dag
+ * @param dag_user 用户dag
+ */
+static void dag_buf_create(acoral_dag *dag, acoral_dag_user *dag_user)
+{
+    acoral_list_t *tmp,*head;
+    acoral_list_t *edge_tmp,*edge_head;
+    acoral_dag_user_buf *user_buf;
+    acoral_dag_edge *edge;
+    acoral_u32 addr;
+    head = &dag_user->dag_user_buf_queue.head;
+    edge_head = &dag->dag_edge_queue.head;
+    for(tmp=head->next;tmp!=head;tmp=tmp->next)
+    {
+        user_buf = list_entry(tmp,acoral_dag_user_buf,list);
+        for(edge_tmp=edge_head->next;edge_tmp!=edge_head;edge_tmp=edge_tmp->next)
+        {
+            edge = list_entry(edge_tmp,acoral_dag_edge,list);
+            if(edge->prev_node!=NULL&&
+               edge->prev_node->route==user_buf->prev_route&&
+               edge->next_node->route==user_buf->next_route)
+                break;
+        }
+        if(edge_tmp==edge_head)
+        {
+            acoral_printerr("Dag buffer declared on a missing edge\n");
+            continue;
+        }
+        if(edge->buf!=NULL)
+            continue;
+        edge->buf_size = user_buf->size;
+        edge->buf_depth = user_buf->depth>0?user_buf->depth:1;
+#ifdef CFG_DAG_POOL
+        if(edge->buf_depth<CFG_DAG_POOL_PIPELINE)//槽少于在途实例数时，后一实例的写入会覆盖前一实例还没读的数据
+        {
+            acoral_printerr("Dag buffer depth %d raised to CFG_DAG_POOL_PIPELINE\n",edge->buf_depth);
+            edge->buf_depth = CFG_DAG_POOL_PIPELINE;
+        }
+#endif
+        edge->buf_stride = (user_buf->size+ACORAL_CACHE_LINE_SIZE-1)&~(ACORAL_CACHE_LINE_SIZE-1);
+        addr = (acoral_u32)acoral_malloc(edge->buf_stride*edge->buf_depth+ACORAL_CACHE_LINE_SIZE-1);
+        if(addr==0)
+        {
+            acoral_printerr("No mem for dag buffer\n");
+            continue;
+        }
+        edge->buf = (void *)((addr+ACORAL_CACHE_LINE_SIZE-1)&~(ACORAL_CACHE_LINE_SIZE-1));
+        //挂到两端节点的缓冲区链上，执行时只遍历带缓冲区的边
+        edge->next_out = edge->prev_node->out_buf;
+        edge->prev_node->out_buf = edge;
+        edge->next_in = edge->next_node->in_buf;
+        edge->next_node->in_buf = edge;
+    }
+}
+
+/**
+ * @brief 节点执行完毕：切换到下一缓冲槽，并保证缓冲区写入先于后继就绪对其他cpu可见
+ *
+ * @param node 系统节点
+ */
+static inline void dag_node_done(acoral_dag_node *node)
+{
+    node->instance++;
+    acoral_dmb();
+}
+
+#ifdef CFG_DAG_AUTO_MAP
+/**
+ * @brief 节点参与映射的执行时间，未标注按1ms计，保证排名沿边严格递减
+ *
+ * @param node 系统节点
+ * @return acoral_time 执行时间(ms)
+ */
+static inline acoral_time dag_map_wcet(acoral_dag_node *node)
+{
+    return node->wcet>0?node->wcet:1;
+}
+
+/**
+ * @brief 计算所有节点的向上排名：rank = wcet + max(通信开销 + 后继rank)
+ *
+ * @param dag 系统dag
+ * @return acoral_err 成功返回KR_OK，松弛超过节点数轮仍在变化说明有环，返回KR_DAG_ERR_CYCLE
+ */
+static acoral_err dag_map_rank(acoral_dag *dag)
+{
+    acoral_list_t *tmp,*head;
+    acoral_dag_node *node;
+    acoral_dag_edge *edge;
+    acoral_time rank;
+    acoral_u8 changed;
+    acoral_u32 n=0,pass;
+    head=&dag->dag_node_queue.head;
+    for(tmp=head->next;tmp!=head;tmp=tmp->next)
+    {
+        node=list_entry(tmp,acoral_dag_node,list);
+        node->rank=dag_map_wcet(node);
+        n++;
+    }
+    //沿边松弛直到不再变化，无环时最长路径不超过n-1条边，第n轮起不再变化
+    head=&dag->dag_edge_queue.head;
+    for(pass=0;pass<=n;pass++)
+    {
+        changed=0;
+        for(tmp=head->next;tmp!=head;tmp=tmp->next)
+        {
+            edge=list_entry(tmp,acoral_dag_edge,list);
+            if(edge->prev_node==NULL)
+                continue;
+            rank=dag_map_wcet(edge->prev_node)+CFG_DAG_AUTO_MAP_COMM+edge->next_node->rank;
+            if(rank>edge->prev_node->rank)
+            {
+                edge->prev_node->rank=rank;
+                changed=1;
+            }
+        }
+        if(!changed)
+            return KR_OK;
+    }
+    return KR_DAG_ERR_CYCLE;
+}
+
+/**
+ * @brief 在cpu上已映射节点之间找最早能放下的空隙
+ *
+ * @param order 已映射节点数组
+ * @param num 已映射节点个数
+ * @param cpu 候选cpu
+ * @param ready 最早开始时刻(ms)
+ * @param wcet 执行时间(ms)
+ * @return acoral_time 开始时刻(ms)
+ */
+static acoral_time dag_map_slot(acoral_dag_node **order, acoral_u32 num, acoral_u32 cpu, acoral_time ready, acoral_time wcet)
+{
+    acoral_time start=ready;
+    acoral_dag_node *node;
+    acoral_u32 i;
+    for(i=0;i<num;i++)
+    {
+        node=order[i];
+        if(node->processor!=cpu)
+            continue;
+        if(start<node->finish&&node->finish-dag_map_wcet(node)<start+wcet)//重叠则推迟到该节点之后，重新检查
+        {
+            start=node->finish;
+            i=(acoral_u32)-1;
+        }
+    }
+    return start;
+}
+
+/**
+ * @brief 系统dag节点自动映射：按排名降序依次放到最早完成的cpu（插入式HEFT），
+ *        再按各cpu上的排名次序分配优先级；手动指定的cpu/优先级保留
+ *
+ * @param dag 系统dag
+ * @return acoral_err 成功或内存不足保留手动映射时返回KR_OK，图中有环返回KR_DAG_ERR_CYCLE
+ */
+static acoral_err dag_auto_map(acoral_dag *dag)
+{
+    acoral_list_t *tmp,*head,*edge_tmp,*edge_head;
+    acoral_dag_node *node;
+    acoral_dag_node **order;
+    acoral_dag_edge *edge;
+    acoral_u8 level[CFG_MAX_CPU]={0};
+    acoral_time ready,start,eft,best_eft,comm;
+    acoral_u32 n=0,i,j,cpu,best_cpu,prio;
+    head=&dag->dag_node_queue.head;
+    edge_head=&dag->dag_edge_queue.head;
+    dag->makespan=0;
+    for(tmp=head->next;tmp!=head;tmp=tmp->next)
+        n++;
+    if(n==0)
+        return KR_OK;
+    if(dag_map_rank(dag)!=KR_OK)
+        return KR_DAG_ERR_CYCLE;
+    order=(acoral_dag_node **)acoral_vol_malloc(n*sizeof(acoral_dag_node *));
+    if(order==NULL)
+    {
+        acoral_printerr("No mem for dag auto map, keep manual mapping\n");
+        return KR_OK;
+    }
+    //按排名降序插入排序，前驱排名一定大于后继，即为拓扑序
+    i=0;
+    for(tmp=head->next;tmp!=head;tmp=tmp->next)
+    {
+        node=list_entry(tmp,acoral_dag_node,list);
+        for(j=i;j>0&&order[j-1]->rank<node->rank;j--)
+            order[j]=order[j-1];
+        order[j]=node;
+        i++;
+    }
+    for(i=0;i<n;i++)
+    {
+        node=order[i];
+        if((node->fixed&ACORAL_DAG_FIX_CPU)&&node->processor>=CFG_MAX_CPU)
+            node->processor=0;
+        best_cpu=0;
+        best_eft=(acoral_time)-1;
+        for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+        {
+            if((node->fixed&ACORAL_DAG_FIX_CPU)&&cpu!=node->processor)
+                continue;
+            //所有前驱完成且数据到达的时刻
+            ready=0;
+            for(edge_tmp=edge_head->next;edge_tmp!=edge_head;edge_tmp=edge_tmp->next)
+            {
+                edge=list_entry(edge_tmp,acoral_dag_edge,list);
+                if(edge->next_node!=node||edge->prev_node==NULL)
+                    continue;
+                comm=edge->prev_node->processor!=cpu?CFG_DAG_AUTO_MAP_COMM:0;
+                if(edge->prev_node->finish+comm>ready)
+                    ready=edge->prev_node->finish+comm;
+            }
+            start=dag_map_slot(order,i,cpu,ready,dag_map_wcet(node));
+            eft=start+dag_map_wcet(node);
+            if(eft<best_eft)
+            {
+                best_eft=eft;
+                best_cpu=cpu;
+            }
+        }
+        node->processor=best_cpu;
+        node->finish=best_eft;
+        if(best_eft>dag->makespan)
+            dag->makespan=best_eft;
+        //同一cpu上排名越靠前优先级越高
+        prio=CFG_DAG_AUTO_MAP_PRIO+level[best_cpu]++;
+        if(prio>=ACORAL_DAEMON_PRIO)
+            prio=ACORAL_DAEMON_PRIO-1;
+        if(!(node->fixed&ACORAL_DAG_FIX_PRIO))
+            node->prio=prio;
+    }
+    acoral_vol_free(order);
+    return KR_OK;
+}
+#endif
+
 /**
  * @brief 系统dag初始化
  * 
@@ -154,8 +423,28 @@ static void acoral_dag_init(acoral_dag_user *dag_user)
     acoral_lifo_queue_init(&dag->dag_node_queue);
     acoral_lifo_queue_init(&dag->dag_edge_queue);
     dag->period_time = dag_user->period_time;
+#ifdef CFG_DAG_POOL
+    dag->burst = dag_user->burst;
+    dag->min_interval = acoral_us_to_cycles((acoral_u64)dag_user->min_interval*1000);
+    dag->timer = NULL;
+#endif
+#ifdef CFG_DAG_STAT
+    dag->deadline = dag_user->deadline>0?dag_user->deadline:dag_user->period_time;
+    dag->crit_path = NULL;//映射失败时统计输出据此跳过
+    dag->crit_len = 0;
+#endif
+    dag_user->dag = dag;
     dag_node_create(dag, dag_user);
     dag_edge_create(dag, dag_user);
+    dag_buf_create(dag, dag_user);
+#ifdef CFG_DAG_AUTO_MAP
+    if(dag_auto_map(dag)!=KR_OK)
+    {
+        acoral_printerr("Dag has a cycle, not started\n");
+        dag_user->dag=NULL;//不加入系统dag队列，不映射执行，查询接口返回KR_DAG_ERR_NULL
+        return;
+    }
+#endif
     acoral_list_init(&dag->list);
     acoral_lifo_queue_add(&acoral_dag_queue, &dag->list);
 }
@@ -194,6 +483,7 @@ void acoral_dag_task(void *args)
             acoral_sem_pends(data->pend_ipc[i]);//获取前置节点信号量
         }
         data->dag_route(data->dag_args);//该dag节点执行函数
+        dag_node_done(data->node);
         acoral_sem_posts(data->post_ipc);//释放该节点信号量
     }
     else
@@ -261,8 +551,25 @@ static void acoral_dag_to_thread()
     for(dag_tmp=dag_head->next;dag_tmp!=dag_head;dag_tmp=dag_tmp->next)
     {
         dag = list_entry(dag_tmp,acoral_dag,list);
+        if(dag->period_time == 0)
+        {
+            acoral_printerr("Event triggered dag needs CFG_DAG_POOL\n");
+            continue;
+        }
         node_head = &dag->dag_node_queue.head;
         edge_head = &dag->dag_edge_queue.head;
+        //信号量每次执行各post一次，前后节点只能同速率
+        for(node_tmp=node_head->next;node_tmp!=node_head;node_tmp=node_tmp->next)
+        {
+            dag_node = list_entry(node_tmp,acoral_dag_node,list);
+            if(dag_node->rate > 1)
+                break;
+        }
+        if(node_tmp != node_head)
+        {
+            acoral_printerr("Multi-rate dag needs CFG_DAG_POOL\n");
+            continue;
+        }
         for(node_tmp=node_head->next;node_tmp!=node_head;node_tmp=node_tmp->next)
         {
             edge_cnt = 0;
@@ -274,6 +581,7 @@ static void acoral_dag_to_thread()
             dag_task_data->post_ipc = dag_node->sem;
             dag_task_data->dag_route = dag_node->route;
             dag_task_data->dag_args = dag_node->args;
+            dag_task_data->node = dag_node;
             if(dag_node->in_degree > 0)
             {
                 //遍历系统边，找到后部节点为该节点的边，获取前驱结点信号量
@@ -309,6 +617,825 @@ static void acoral_dag_to_thread()
     }
 }
 
+#if defined(CFG_DAG_STAT)&&!defined(CFG_DAG_POOL)
+#error "CFG_DAG_STAT needs CFG_DAG_POOL"
+#endif
+#ifdef CFG_DAG_POOL
+#ifndef CFG_SOFT_TIMER
+#error "CFG_DAG_POOL needs CFG_SOFT_TIMER for periodic release"
+#endif
+#if (CFG_DAG_POOL_DEQUE_SIZE&(CFG_DAG_POOL_DEQUE_SIZE-1))
+#error "CFG_DAG_POOL_DEQUE_SIZE must be a power of 2"
+#endif
+///双端队列下标掩码
+#define DAG_DEQUE_MASK (CFG_DAG_POOL_DEQUE_SIZE-1)
+
+/**
+ * @brief 就绪令牌结构体，一个节点在一个实例中就绪
+ *
+ */
+typedef struct{
+    acoral_dag_node *node;///<就绪节点
+    acoral_u32 instance;///<实例序号
+}dag_token_t;
+
+/**
+ * @brief 就绪节点双端队列结构体，所有者在尾部压入弹出，其他cpu从头部窃取
+ *
+ */
+typedef struct{
+    dag_token_t buf[CFG_DAG_POOL_DEQUE_SIZE];///<就绪令牌环形缓冲
+    acoral_u32 head;///<头部（窃取端）计数
+    acoral_u32 tail;///<尾部（所有者端）计数
+#ifdef CFG_SMP
+    acoral_spinlock_t lock;///<队列自旋锁
+#endif
+}dag_deque_t;
+
+/**
+ * @brief dag工作线程结构体
+ *
+ */
+typedef struct{
+    acoral_list_t idle;///<空闲工作线程链表节点
+    acoral_id id;///<线程id
+    acoral_u8 cpu;///<所在cpu
+    dag_task_data_t data;///<线程私有数据，记录正在执行的节点
+}dag_worker_t;
+
+///各cpu就绪节点双端队列
+static dag_deque_t dag_deque[CFG_MAX_CPU];
+///工作线程
+static dag_worker_t dag_worker[CFG_MAX_CPU][CFG_DAG_POOL_WORKERS];
+///各cpu空闲工作线程链表
+static acoral_list_t dag_idle[CFG_MAX_CPU];
+#ifdef CFG_SMP
+///空闲工作线程链表自旋锁
+static acoral_spinlock_t dag_idle_lock;
+#endif
+
+/**
+ * @brief 就绪令牌按节点优先级插入所在cpu双端队列，尾部为优先级最高的节点
+ *        同优先级的插在最后，仍为后进先出
+ *
+ * @param cpu 队列所属cpu
+ * @param node 就绪节点
+ * @param instance 实例序号
+ */
+static void dag_deque_push(acoral_u32 cpu, acoral_dag_node *node, acoral_u32 instance)
+{
+    dag_deque_t *dq=&dag_deque[cpu];
+    acoral_u32 pos;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&dq->lock);
+#endif
+    //容量在映射时已检查，不会溢出
+    for(pos=dq->tail;pos!=dq->head&&dq->buf[(pos-1)&DAG_DEQUE_MASK].node->prio<node->prio;pos--)
+        dq->buf[pos&DAG_DEQUE_MASK]=dq->buf[(pos-1)&DAG_DEQUE_MASK];
+    dq->buf[pos&DAG_DEQUE_MASK].node=node;
+    dq->buf[pos&DAG_DEQUE_MASK].instance=instance;
+    dq->tail++;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&dq->lock);
+#endif
+    acoral_exit_critical();
+}
+
+/**
+ * @brief 从本cpu双端队列尾部弹出优先级最高的令牌，同优先级后进先出，刚就绪的后继缓存较热
+ *
+ * @param cpu 当前cpu
+ * @param token 弹出的令牌
+ * @return acoral_u8 1成功，队列空返回0
+ */
+static acoral_u8 dag_deque_pop(acoral_u32 cpu, dag_token_t *token)
+{
+    dag_deque_t *dq=&dag_deque[cpu];
+    acoral_u8 ret=0;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&dq->lock);
+#endif
+    if(dq->tail!=dq->head)
+    {
+        dq->tail--;
+        *token=dq->buf[dq->tail&DAG_DEQUE_MASK];
+        ret=1;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&dq->lock);
+#endif
+    acoral_exit_critical();
+    return ret;
+}
+
+/**
+ * @brief 从其他cpu双端队列头部窃取令牌，取走优先级最低的节点，紧急节点留给所有者
+ *
+ * @param cpu 当前cpu
+ * @param token 窃取到的令牌
+ * @return acoral_u8 1成功，全部为空返回0
+ */
+static acoral_u8 dag_deque_steal(acoral_u32 cpu, dag_token_t *token)
+{
+    dag_deque_t *dq;
+    acoral_u8 ret=0;
+    acoral_u32 i,victim;
+    for(i=1;i<CFG_MAX_CPU&&!ret;i++)
+    {
+        victim=(cpu+i)%CFG_MAX_CPU;
+        dq=&dag_deque[victim];
+        acoral_enter_critical();
+#ifdef CFG_SMP
+        acoral_spin_lock(&dq->lock);
+#endif
+        if(dq->tail!=dq->head)
+        {
+            *token=dq->buf[dq->head&DAG_DEQUE_MASK];
+            dq->head++;
+            ret=1;
+        }
+#ifdef CFG_SMP
+        acoral_spin_unlock(&dq->lock);
+#endif
+        acoral_exit_critical();
+    }
+    return ret;
+}
+
+/**
+ * @brief 唤醒一个空闲工作线程，优先唤醒节点所在cpu的，否则唤醒其他cpu的来窃取
+ *
+ * @param cpu 节点所在cpu
+ */
+static void dag_worker_wake(acoral_u32 cpu)
+{
+    dag_worker_t *worker=NULL;
+    acoral_u32 i,c;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&dag_idle_lock);
+#endif
+    for(i=0;i<CFG_MAX_CPU;i++)
+    {
+        c=(cpu+i)%CFG_MAX_CPU;
+        if(!acoral_list_empty(&dag_idle[c]))
+        {
+            worker=list_entry(dag_idle[c].next,dag_worker_t,idle);
+            acoral_list_del(&worker->idle);
+            break;
+        }
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&dag_idle_lock);
+#endif
+    acoral_exit_critical();
+    if(worker!=NULL)
+        acoral_rdy_thread_by_id(worker->id);//空闲工作线程已在持锁时挂起，状态一定为suspend
+}
+
+/**
+ * @brief 所有双端队列都为空时挂起工作线程
+ *
+ * @param worker 当前工作线程
+ */
+static void dag_worker_idle(dag_worker_t *worker)
+{
+    acoral_u32 i;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&dag_idle_lock);
+#endif
+    for(i=0;i<CFG_MAX_CPU;i++)
+    {
+        if(dag_deque[i].tail!=dag_deque[i].head)//压入节点后才会唤醒，持锁检查不会丢失唤醒
+            break;
+    }
+    if(i==CFG_MAX_CPU)
+    {
+        acoral_list_add_tail(&worker->idle,&dag_idle[worker->cpu]);
+        acoral_suspend_self();//临界区内只修改状态，退出临界区时才切换
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&dag_idle_lock);
+#endif
+    acoral_exit_critical();
+}
+
+/**
+ * @brief 节点所在cpu，越界时放到cpu0
+ *
+ * @param node 节点
+ * @return acoral_u32 cpu
+ */
+static inline acoral_u32 dag_node_cpu(acoral_dag_node *node)
+{
+    return node->processor<CFG_MAX_CPU?node->processor:0;
+}
+
+/**
+ * @brief 节点是否在实例中激活，节点周期为dag周期的rate倍，每个超周期内的激活模式相同
+ *
+ * @param node 节点
+ * @param k 实例序号
+ * @return acoral_u8 1激活，0不激活
+ */
+static inline acoral_u8 dag_node_active(acoral_dag_node *node, acoral_u32 k)
+{
+    return k%node->rate==0;
+}
+
+/**
+ * @brief 节点在实例中要等待的令牌个数（需持dag锁）。
+ *        本实例也激活的前驱必须先完成；不激活的前驱提供其最近一次激活的输出，该次激活还没完成时同样要等待；
+ *        本节点上一次激活还没完成时多等待一个自身令牌
+ *
+ * @param node 节点
+ * @param k 实例序号
+ * @return acoral_u16 令牌个数
+ */
+static acoral_u16 dag_node_wait(acoral_dag_node *node, acoral_u32 k)
+{
+    acoral_dag_node *pred;
+    acoral_u16 wait=0;
+    acoral_u32 i;
+    if(k>=node->rate&&node->finished<=k-node->rate)
+        wait++;
+    for(i=0;i<node->pred_num;i++)
+    {
+        pred=node->pred[i];
+        if(pred->finished<=k-k%pred->rate)
+            wait++;
+    }
+    return wait;
+}
+
+#ifdef CFG_DAG_STAT
+/**
+ * @brief 清空dag及其节点的统计（需持dag锁或dag未运行）
+ *
+ * @param dag 系统dag
+ */
+static void dag_stat_clear(acoral_dag *dag)
+{
+    acoral_list_t *tmp,*head;
+    acoral_dag_node *node;
+    acoral_u8 *p=(acoral_u8 *)&dag->stat;
+    acoral_u32 i;
+    for(i=0;i<sizeof(acoral_dag_stat_t);i++)
+        p[i]=0;
+    dag->crit_len=0;
+    head=&dag->dag_node_queue.head;
+    for(tmp=head->next;tmp!=head;tmp=tmp->next)
+    {
+        node=list_entry(tmp,acoral_dag_node,list);
+        p=(acoral_u8 *)&node->stat;
+        for(i=0;i<sizeof(acoral_dag_node_stat_t);i++)
+            p[i]=0;
+    }
+}
+
+/**
+ * @brief 记录节点一次执行的执行时间与响应时间（需持dag锁）
+ *
+ * @param node 系统节点
+ * @param slot 实例所在槽
+ */
+static void dag_stat_node(acoral_dag_node *node, acoral_u32 slot)
+{
+    acoral_dag_node_stat_t *stat=&node->stat;
+    acoral_u64 exec,response;
+    exec=acoral_cycles_to_ns(node->finish_ts[slot]-node->start_ts[slot]);
+    response=acoral_cycles_to_ns(node->finish_ts[slot]-node->dag->release_ts[slot]);
+    stat->runs++;
+    stat->exec_total+=exec;
+    if(exec>stat->exec_max)
+        stat->exec_max=exec;
+    if(response>stat->response_max)
+        stat->response_max=response;
+}
+
+/**
+ * @brief 实例完成：记录端到端延迟、检查截止期，并从最后完成的节点沿最晚完成的前驱回溯观测关键路径（需持dag锁）。
+ *        只考虑本实例中激活的节点
+ *
+ * @param dag 系统dag
+ * @param k 实例序号
+ */
+static void dag_stat_instance(acoral_dag *dag, acoral_u32 k)
+{
+    acoral_list_t *tmp,*head;
+    acoral_dag_node *node,*last=NULL;
+    acoral_dag_stat_t *stat=&dag->stat;
+    acoral_u64 latency,us;
+    acoral_u32 i,bucket,slot=k%CFG_DAG_POOL_PIPELINE;
+    acoral_u16 len=0;
+    head=&dag->dag_node_queue.head;
+    for(tmp=head->next;tmp!=head;tmp=tmp->next)//最后完成的激活节点没有晚于它完成的激活后继，即本实例的汇节点
+    {
+        node=list_entry(tmp,acoral_dag_node,list);
+        if(dag_node_active(node,k)&&(last==NULL||ACORAL_CLOCK_AFTER(node->finish_ts[slot],last->finish_ts[slot])))
+            last=node;
+    }
+    if(last==NULL)
+        return;
+    latency=acoral_cycles_to_ns(last->finish_ts[slot]-dag->release_ts[slot]);
+    stat->completions++;
+    stat->latency_total+=latency;
+    if(dag->deadline!=0&&latency>(acoral_u64)dag->deadline*1000000)//截止期为0不检查
+        stat->misses++;
+    us=latency/1000;
+    for(bucket=0;us>1&&bucket<CFG_DAG_STAT_HIST_NUM-1;bucket++)
+        us>>=1;
+    stat->hist[bucket]++;
+    //回溯关键路径：每一步取最晚完成的前驱，即限制本节点开始的前驱
+    for(node=last;node!=NULL;)
+    {
+        node->stat.critical++;
+        if(latency>stat->latency_max)
+            dag->crit_path[len++]=node;
+        for(i=0,last=NULL;i<node->pred_num;i++)
+        {
+            if(!dag_node_active(node->pred[i],k))
+                continue;
+            if(last==NULL||ACORAL_CLOCK_AFTER(node->pred[i]->finish_ts[slot],last->finish_ts[slot]))
+                last=node->pred[i];
+        }
+        node=last;
+    }
+    if(latency>stat->latency_max)
+    {
+        stat->latency_max=latency;
+        dag->crit_len=len;
+    }
+}
+#endif
+
+/**
+ * @brief 按实例顺序回收已完成的实例，多速率时后释放的实例可能先完成（需持dag锁）
+ *
+ * @param dag 系统dag
+ */
+static void dag_instance_retire(acoral_dag *dag)
+{
+    while(dag->complete<dag->release&&dag->remaining[dag->complete%CFG_DAG_POOL_PIPELINE]==0)
+    {
+#ifdef CFG_DAG_STAT
+        dag_stat_instance(dag,dag->complete);
+#endif
+        dag->complete++;
+    }
+}
+
+/**
+ * @brief 开始dag的一个实例，本实例激活且无需等待的节点进入就绪队列（需持dag锁，调用者保证在途实例未达上限）。
+ *        上一次激活中还没完成的节点多等待一个自身令牌，保证同一节点按实例顺序执行
+ *
+ * @param dag 系统dag
+ * @param arg 触发参数
+ * @param pushed 各cpu压入数量
+ */
+static void dag_instance_start(acoral_dag *dag, void *arg, acoral_u8 *pushed)
+{
+    acoral_list_t *tmp,*head;
+    acoral_dag_node *node;
+    acoral_u32 k,slot;
+    head=&dag->dag_node_queue.head;
+    k=dag->release++;
+    slot=k%CFG_DAG_POOL_PIPELINE;
+    dag->remaining[slot]=0;
+    dag->event_arg[slot]=arg;
+    dag->last_release=acoral_clock_cycles();
+#ifdef CFG_DAG_STAT
+    dag->release_ts[slot]=dag->last_release;
+    dag->stat.releases++;
+#endif
+    for(tmp=head->next;tmp!=head;tmp=tmp->next)
+    {
+        node=list_entry(tmp,acoral_dag_node,list);
+        if(!dag_node_active(node,k))
+            continue;
+        dag->remaining[slot]++;
+        node->pending[slot]=dag_node_wait(node,k);
+        if(node->pending[slot]==0)
+        {
+            dag_deque_push(dag_node_cpu(node),node,k);
+            pushed[dag_node_cpu(node)]++;
+        }
+    }
+    if(dag->remaining[slot]==0)//没有节点激活
+        dag_instance_retire(dag);
+}
+
+/**
+ * @brief 唤醒压入节点对应数量的工作线程
+ *
+ * @param pushed 各cpu压入数量
+ */
+static void dag_pushed_wake(acoral_u8 *pushed)
+{
+    acoral_u32 i;
+    for(i=0;i<CFG_MAX_CPU;i++)
+    {
+        while(pushed[i]--)
+            dag_worker_wake(i);
+    }
+}
+
+/**
+ * @brief 周期释放dag的一个实例，在途实例已达上限时跳过本次释放
+ *
+ * @param args 系统dag
+ */
+static void dag_pool_release(void *args)
+{
+    acoral_dag *dag=(acoral_dag *)args;
+    acoral_u8 pushed[CFG_MAX_CPU]={0};
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&dag->lock);
+#endif
+    if(dag->release-dag->complete>=CFG_DAG_POOL_PIPELINE)
+    {
+        dag->overrun++;
+#ifdef CFG_DAG_STAT
+        dag->stat.overruns++;
+#endif
+    }
+    else
+    {
+        dag_instance_start(dag,NULL,pushed);
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&dag->lock);
+#endif
+    acoral_exit_critical();
+    dag_pushed_wake(pushed);
+}
+
+/**
+ * @brief 距上次释放是否已满足最小到达间隔，不满足时启动定时器在间隔满足时再检查（需持dag锁）
+ *
+ * @param dag 系统dag
+ * @return acoral_u8 1满足，0不满足
+ */
+static acoral_u8 dag_event_guard(acoral_dag *dag)
+{
+    acoral_u64 elapsed;
+    if(dag->release==0||dag->min_interval==0)
+        return 1;
+    elapsed=acoral_clock_cycles()-dag->last_release;
+    if(elapsed>=dag->min_interval)
+        return 1;
+    acoral_soft_timer_reset(dag->timer,acoral_cycles_to_ms(dag->min_interval-elapsed)+1);
+    return 0;
+}
+
+/**
+ * @brief 依次释放排队的触发，直到队列空、在途实例已满或到达间隔不足（需持dag锁）
+ *
+ * @param dag 系统dag
+ * @param pushed 各cpu压入数量
+ */
+static void dag_event_drain(acoral_dag *dag, acoral_u8 *pushed)
+{
+    void *arg;
+    while(dag->event_num>0&&dag->release-dag->complete<CFG_DAG_POOL_PIPELINE)
+    {
+        if(!dag_event_guard(dag))
+            break;
+        arg=dag->event_queue[dag->event_head];
+        dag->event_head=(dag->event_head+1)%CFG_DAG_POOL_EVENT_QUEUE;
+        dag->event_num--;
+        dag_instance_start(dag,arg,pushed);
+    }
+}
+
+/**
+ * @brief 到达间隔定时器回调，释放排队的触发
+ *
+ * @param args 系统dag
+ */
+static void dag_event_timer(void *args)
+{
+    acoral_dag *dag=(acoral_dag *)args;
+    acoral_u8 pushed[CFG_MAX_CPU]={0};
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&dag->lock);
+#endif
+    dag_event_drain(dag,pushed);
+#ifdef CFG_SMP
+    acoral_spin_unlock(&dag->lock);
+#endif
+    acoral_exit_critical();
+    dag_pushed_wake(pushed);
+}
+
+/**
+ * @brief 令牌就绪：本cpu的第一个令牌留给当前工作线程直接执行，其余压入队列（需持dag锁）
+ *
+ * @param node 就绪节点
+ * @param instance 实例序号
+ * @param worker 当前工作线程
+ * @param next 留给当前工作线程的令牌
+ * @param pushed 各cpu压入数量
+ */
+static void dag_token_ready(acoral_dag_node *node, acoral_u32 instance, dag_worker_t *worker, dag_token_t *next, acoral_u8 *pushed)
+{
+    if(next->node==NULL&&dag_node_cpu(node)==worker->cpu)//不经过队列和唤醒
+    {
+        next->node=node;
+        next->instance=instance;
+        return;
+    }
+    dag_deque_push(dag_node_cpu(node),node,instance);
+    pushed[dag_node_cpu(node)]++;
+}
+
+/**
+ * @brief 执行一个令牌，并使本实例及本节点下次激活前的实例中前驱计数减为0的后继、以及下次激活中等待自身令牌的本节点就绪
+ *
+ * @param token 令牌，返回时为留给当前工作线程直接执行的令牌，没有则node为NULL
+ * @param worker 当前工作线程
+ */
+static void dag_node_run(dag_token_t *token, dag_worker_t *worker)
+{
+    acoral_dag_node *node=token->node;
+    acoral_dag *dag=node->dag;
+    acoral_dag_node *succ;
+    dag_token_t next={NULL,0};
+    acoral_u8 pushed[CFG_MAX_CPU]={0};
+    acoral_u32 i,m,end,k=token->instance,slot=k%CFG_DAG_POOL_PIPELINE;
+    worker->data.node=node;
+#ifdef CFG_DAG_STAT
+    node->start_ts[slot]=acoral_clock_cycles();
+#endif
+    node->route(node->args);//该dag节点执行函数
+#ifdef CFG_DAG_STAT
+    node->finish_ts[slot]=acoral_clock_cycles();
+#endif
+    dag_node_done(node);
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&dag->lock);
+#endif
+#ifdef CFG_DAG_STAT
+    dag_stat_node(node,slot);
+#endif
+    //本次输出被实例k到下次激活前已释放的实例中激活的后继使用
+    end=k+node->rate<dag->release?k+node->rate:dag->release;
+    for(m=k;m<end;m++)
+    {
+        for(i=0;i<node->succ_num;i++)
+        {
+            succ=node->succ[i];
+            if(dag_node_active(succ,m)&&--succ->pending[m%CFG_DAG_POOL_PIPELINE]==0)
+                dag_token_ready(succ,m,worker,&next,pushed);
+        }
+    }
+    node->finished=k+1;
+    m=k+node->rate;
+    if(dag->release>m&&--node->pending[m%CFG_DAG_POOL_PIPELINE]==0)//下次激活已释放，交出自身令牌
+        dag_token_ready(node,m,worker,&next,pushed);
+    if(--dag->remaining[slot]==0)
+    {
+        dag_instance_retire(dag);
+        dag_event_drain(dag,pushed);//在途实例有空位，释放排队的触发
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&dag->lock);
+#endif
+    acoral_exit_critical();
+    dag_pushed_wake(pushed);
+    *token=next;
+}
+
+/**
+ * @brief dag工作线程统一运行函数
+ *
+ * @param args 工作线程结构体
+ */
+static void dag_worker_task(void *args)
+{
+    dag_worker_t *worker=(dag_worker_t *)args;
+    dag_token_t token;
+    while(1)
+    {
+        if(!dag_deque_pop(worker->cpu,&token)&&!dag_deque_steal(worker->cpu,&token))
+        {
+            dag_worker_idle(worker);
+            continue;
+        }
+        while(token.node!=NULL)
+            dag_node_run(&token,worker);
+    }
+}
+
+/**
+ * @brief 最小公倍数
+ *
+ * @param a 数a
+ * @param b 数b
+ * @return acoral_u32 最小公倍数
+ */
+static acoral_u32 dag_lcm(acoral_u32 a, acoral_u32 b)
+{
+    acoral_u32 x=a,y=b,t;
+    while(y!=0)
+    {
+        t=x%y;
+        x=y;
+        y=t;
+    }
+    return a/x*b;
+}
+
+/**
+ * @brief 建立系统dag的前驱、后继数组，并计算超周期
+ *
+ * @param dag 系统dag
+ * @return acoral_err 错误检测
+ */
+static acoral_err dag_pool_link(acoral_dag *dag)
+{
+    acoral_list_t *node_tmp,*node_head;
+    acoral_list_t *edge_tmp,*edge_head;
+    acoral_dag_node *dag_node;
+    acoral_dag_edge *dag_edge;
+    node_head=&dag->dag_node_queue.head;
+    edge_head=&dag->dag_edge_queue.head;
+    dag->node_num=0;
+    dag->hyper=1;
+    for(node_tmp=node_head->next;node_tmp!=node_head;node_tmp=node_tmp->next)
+    {
+        dag_node=list_entry(node_tmp,acoral_dag_node,list);
+        dag_node->dag=dag;
+        dag_node->pred_num=0;
+        dag_node->succ_num=0;
+        dag_node->finished=0;
+        dag->node_num++;
+        dag->hyper=dag_lcm(dag->hyper,dag_node->rate);
+    }
+    //统计前驱与后继个数，NULL前驱表示源节点，不计入
+    for(edge_tmp=edge_head->next;edge_tmp!=edge_head;edge_tmp=edge_tmp->next)
+    {
+        dag_edge=list_entry(edge_tmp,acoral_dag_edge,list);
+        if(dag_edge->prev_node==NULL)
+            continue;
+        dag_edge->prev_node->succ_num++;
+        dag_edge->next_node->pred_num++;
+    }
+    for(node_tmp=node_head->next;node_tmp!=node_head;node_tmp=node_tmp->next)
+    {
+        dag_node=list_entry(node_tmp,acoral_dag_node,list);
+        dag_node->succ=NULL;
+        if(dag_node->succ_num>0)
+        {
+            dag_node->succ=(acoral_dag_node **)acoral_vol_malloc(dag_node->succ_num*sizeof(acoral_dag_node *));
+            if(dag_node->succ==NULL)
+                return KR_MEM_ERR_MALLOC;
+        }
+        dag_node->succ_num=0;//下面填充时重新计数
+        dag_node->pred=NULL;
+        if(dag_node->pred_num>0)
+        {
+            dag_node->pred=(acoral_dag_node **)acoral_vol_malloc(dag_node->pred_num*sizeof(acoral_dag_node *));
+            if(dag_node->pred==NULL)
+                return KR_MEM_ERR_MALLOC;
+        }
+        dag_node->pred_num=0;
+    }
+    for(edge_tmp=edge_head->next;edge_tmp!=edge_head;edge_tmp=edge_tmp->next)
+    {
+        dag_edge=list_entry(edge_tmp,acoral_dag_edge,list);
+        if(dag_edge->prev_node==NULL)
+            continue;
+        dag_edge->prev_node->succ[dag_edge->prev_node->succ_num++]=dag_edge->next_node;
+        dag_edge->next_node->pred[dag_edge->next_node->pred_num++]=dag_edge->prev_node;
+    }
+#ifdef CFG_DAG_STAT
+    dag->crit_len=0;
+    dag->crit_path=(acoral_dag_node **)acoral_vol_malloc(dag->node_num*sizeof(acoral_dag_node *));
+    if(dag->crit_path==NULL)
+        return KR_MEM_ERR_MALLOC;
+    dag_stat_clear(dag);
+#endif
+    dag->complete=0;
+    dag->release=0;
+    dag->overrun=0;
+    dag->event_head=0;
+    dag->event_num=0;
+    dag->dropped=0;
+    dag->last_release=0;
+#ifdef CFG_SMP
+    acoral_spin_init(&dag->lock);
+#endif
+    return KR_OK;
+}
+
+/**
+ * @brief 创建各cpu的工作线程
+ *
+ */
+static void dag_worker_create()
+{
+    acoral_comm_policy_data_t p_data;
+    dag_worker_t *worker;
+    acoral_u32 cpu,i;
+    for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+    {
+        dag_deque[cpu].head=0;
+        dag_deque[cpu].tail=0;
+#ifdef CFG_SMP
+        acoral_spin_init(&dag_deque[cpu].lock);
+#endif
+        acoral_list_init(&dag_idle[cpu]);
+    }
+#ifdef CFG_SMP
+    acoral_spin_init(&dag_idle_lock);
+#endif
+    for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+    {
+        for(i=0;i<CFG_DAG_POOL_WORKERS;i++)
+        {
+            worker=&dag_worker[cpu][i];
+            acoral_list_init(&worker->idle);
+            worker->cpu=cpu;
+            worker->data.node=NULL;
+            p_data.cpu=cpu;
+            p_data.prio=CFG_DAG_POOL_PRIO;
+            worker->id=acoral_create_thread(dag_worker_task,
+                                    CFG_DAG_POOL_STACK_SIZE,
+                                    worker,
+                                    "acoral_dag_worker",
+                                    NULL,
+                                    ACORAL_SCHED_POLICY_COMM,
+                                    &p_data,
+                                    &worker->data,
+                                    NULL);
+            if(worker->id<0)
+                acoral_printerr("Create dag worker fail\n");
+        }
+    }
+}
+
+/**
+ * @brief 系统dag到工作线程池的映射，每个dag只占用一个周期释放定时器
+ *
+ */
+static void acoral_dag_to_pool()
+{
+    acoral_list_t *dag_tmp,*dag_head;
+    acoral_dag *dag;
+    acoral_u32 total=0;
+    dag_worker_create();
+    dag_head = &acoral_dag_queue.head;
+    for(dag_tmp=dag_head->next;dag_tmp!=dag_head;dag_tmp=dag_tmp->next)
+    {
+        dag = list_entry(dag_tmp,acoral_dag,list);
+        if(dag_pool_link(dag)!=KR_OK)
+        {
+            acoral_printerr("No mem for dag successors\n");
+            continue;
+        }
+        total += dag->node_num*CFG_DAG_POOL_PIPELINE;
+        if(total > CFG_DAG_POOL_DEQUE_SIZE)//每个在途实例的每个节点同一时刻最多在队列中出现一次
+        {
+            acoral_printerr("Dag nodes exceed CFG_DAG_POOL_DEQUE_SIZE\n");
+            total -= dag->node_num*CFG_DAG_POOL_PIPELINE;
+            continue;
+        }
+        if(dag->node_num==0)
+            continue;
+        if(dag->period_time == 0)//事件触发，定时器只用于到达间隔
+        {
+            dag->timer = acoral_soft_timer_create(dag_event_timer,
+                                    dag,
+                                    1,
+                                    ACORAL_SOFT_TIMER_IN_TICK,
+                                    0);
+            if(dag->timer == NULL)
+                total -= dag->node_num*CFG_DAG_POOL_PIPELINE;
+            continue;
+        }
+        dag->timer = acoral_soft_timer_create(dag_pool_release,
+                                    dag,
+                                    dag->period_time,
+                                    ACORAL_SOFT_TIMER_PERIODIC|ACORAL_SOFT_TIMER_IN_TICK,
+                                    0);
+        if(dag->timer == NULL)
+        {
+            total -= dag->node_num*CFG_DAG_POOL_PIPELINE;
+            continue;
+        }
+        acoral_soft_timer_start(dag->timer);
+        dag_pool_release(dag);//与周期线程一致，映射后立即释放第一个实例
+    }
+}
+#endif
+
 /**
  * @brief 并行编程框架映射
  * 
@@ -322,8 +1449,13 @@ void dag_decode()
     dag_user_init();
     //用户节点映射到数据结构
     acoral_dag_create();
+#ifdef CFG_DAG_POOL
+    //数据结构映射到工作线程池
+    acoral_dag_to_pool();
+#else
     //数据结构映射到线程
     acoral_dag_to_thread();
+#endif
 }
 
 /**
@@ -347,5 +1479,377 @@ void dag_add_user(acoral_dag_user *dag_user)
 {
     acoral_list_init(&dag_user->list);
     acoral_lifo_queue_init(&dag_user->dag_user_node_queue);
+    acoral_lifo_queue_init(&dag_user->dag_user_buf_queue);
     acoral_lifo_queue_add(&acoral_dag_user_queue, &dag_user->list);
 }
+
+/**
+ * @brief 添加用户边缓冲区，须在dag_add_user之后调用
+ * 
+ * @param dag_user 用户dag
+ * @param user_buf 用户边缓冲区
+ */
+void dag_add_user_buf(acoral_dag_user *dag_user, acoral_dag_user_buf *user_buf)
+{
+    acoral_list_init(&user_buf->list);
+    acoral_lifo_queue_add(&dag_user->dag_user_buf_queue, &user_buf->list);
+}
+
+/**
+ * @brief 当前线程正在执行的系统节点
+ * 
+ * @return acoral_dag_node* 系统节点，不在dag节点中返回NULL
+ */
+static acoral_dag_node *dag_cur_node(void)
+{
+    dag_task_data_t *data = (dag_task_data_t *)acoral_cur_thread->data;
+    return data!=NULL?data->node:NULL;
+}
+
+/**
+ * @brief 获取当前节点到后继节点的边缓冲区中本次要写入的槽，只能在dag节点执行函数中调用
+ * 
+ * @param next_route 后继节点执行函数
+ * @return void* 缓冲槽地址，该边没有声明缓冲区返回NULL
+ */
+void *dag_out_buf(acoral_func_point next_route)
+{
+    acoral_dag_node *node = dag_cur_node();
+    acoral_dag_edge *edge;
+    if(node==NULL)
+        return NULL;
+    for(edge=node->out_buf;edge!=NULL;edge=edge->next_out)
+    {
+        if(edge->next_node->route==next_route)
+            return (acoral_u8 *)edge->buf+(node->instance%edge->buf_depth)*edge->buf_stride;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 查找前驱节点到当前节点的带缓冲区入边
+ * 
+ * @param prev_route 前驱节点执行函数
+ * @param node 返回当前节点
+ * @return acoral_dag_edge* 入边，没有返回NULL
+ */
+static acoral_dag_edge *dag_in_edge(acoral_func_point prev_route, acoral_dag_node **node)
+{
+    acoral_dag_edge *edge;
+    *node = dag_cur_node();
+    if(*node==NULL)
+        return NULL;
+    for(edge=(*node)->in_buf;edge!=NULL;edge=edge->next_in)
+    {
+        if(edge->prev_node->route==prev_route)
+            return edge;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 获取前驱节点到当前节点的边缓冲区中前驱的最新值，只能在dag节点执行函数中调用。
+ *        当前节点本次激活于实例k=instance*rate，读取前驱在实例k及以前最近一次激活的输出，
+ *        同速率时即同一实例的输出，快到慢时欠采样，慢到快时重复读取同一输出
+ * 
+ * @param prev_route 前驱节点执行函数
+ * @return const void* 只读缓冲槽地址，该边没有声明缓冲区返回NULL
+ */
+const void *dag_in_buf(acoral_func_point prev_route)
+{
+    acoral_dag_node *node;
+    acoral_dag_edge *edge = dag_in_edge(prev_route, &node);
+    acoral_u32 run;
+    if(edge==NULL)
+        return NULL;
+    run = node->instance*node->rate/edge->prev_node->rate;//前驱执行次数即其激活所在实例除以其rate
+    return (const acoral_u8 *)edge->buf+(run%edge->buf_depth)*edge->buf_stride;
+}
+
+/**
+ * @brief 前驱节点在当前节点上次激活之后、本次激活及以前产生的新输出个数，按FIFO读取时使用，只能在dag节点执行函数中调用。
+ *        快到慢时为速率比，慢到快时为0或1
+ * 
+ * @param prev_route 前驱节点执行函数
+ * @return acoral_u32 新输出个数，该边没有声明缓冲区返回0
+ */
+acoral_u32 dag_in_count(acoral_func_point prev_route)
+{
+    acoral_dag_node *node;
+    acoral_dag_edge *edge = dag_in_edge(prev_route, &node);
+    acoral_u32 k;
+    if(edge==NULL)
+        return 0;
+    k = node->instance*node->rate;
+    if(node->instance==0)
+        return 1;
+    return k/edge->prev_node->rate-(k-node->rate)/edge->prev_node->rate;
+}
+
+/**
+ * @brief 按FIFO顺序获取前驱节点的第index个新输出，只能在dag节点执行函数中调用
+ * 
+ * @param prev_route 前驱节点执行函数
+ * @param index 序号，0为最早的新输出
+ * @return const void* 只读缓冲槽地址，没有声明缓冲区或index不小于dag_in_count返回NULL
+ */
+const void *dag_in_fifo(acoral_func_point prev_route, acoral_u32 index)
+{
+    acoral_dag_node *node;
+    acoral_dag_edge *edge = dag_in_edge(prev_route, &node);
+    acoral_u32 k,first,last;
+    if(edge==NULL)
+        return NULL;
+    k = node->instance*node->rate;
+    last = k/edge->prev_node->rate;
+    first = node->instance==0?0:(k-node->rate)/edge->prev_node->rate+1;
+    if(first+index>last)
+        return NULL;
+    return (const acoral_u8 *)edge->buf+((first+index)%edge->buf_depth)*edge->buf_stride;
+}
+
+#ifdef CFG_DAG_POOL
+/**
+ * @brief 事件触发释放dag的一个实例，可在中断中调用。到达间隔不足或在途实例已满时按突发处理方式排队或丢弃
+ * 
+ * @param dag_user 用户dag
+ * @param arg 触发参数，本实例的节点通过dag_event_arg获取
+ * @return acoral_err 错误检测，丢弃返回KR_DAG_ERR_DROP
+ */
+acoral_err dag_trigger(acoral_dag_user *dag_user, void *arg)
+{
+    acoral_dag *dag;
+    acoral_u8 pushed[CFG_MAX_CPU]={0};
+    acoral_err err = KR_OK;
+    if(dag_user==NULL||dag_user->dag==NULL||dag_user->dag->timer==NULL)
+        return KR_DAG_ERR_NULL;
+    dag = dag_user->dag;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&dag->lock);
+#endif
+    if(dag->event_num==0&&dag->release-dag->complete<CFG_DAG_POOL_PIPELINE&&dag_event_guard(dag))
+    {
+        dag_instance_start(dag,arg,pushed);
+    }
+    else if(dag->burst==ACORAL_DAG_BURST_QUEUE&&dag->event_num<CFG_DAG_POOL_EVENT_QUEUE)
+    {
+        dag->event_queue[(dag->event_head+dag->event_num)%CFG_DAG_POOL_EVENT_QUEUE] = arg;
+        dag->event_num++;//间隔不足时定时器已启动，在途实例满时由实例完成释放
+    }
+    else
+    {
+        dag->dropped++;
+#ifdef CFG_DAG_STAT
+        dag->stat.drops++;
+#endif
+        err = KR_DAG_ERR_DROP;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&dag->lock);
+#endif
+    acoral_exit_critical();
+    dag_pushed_wake(pushed);
+    return err;
+}
+
+/**
+ * @brief 信号量触发桥接结构体
+ * 
+ */
+typedef struct{
+    acoral_dag_user *dag_user;///<触发的用户dag
+    acoral_ipc_t *sem;///<等待的信号量
+}dag_sem_bridge_t;
+
+/**
+ * @brief 信号量触发桥接线程，每获取一次信号量触发一个实例，触发参数为信号量指针
+ * 
+ * @param args 桥接结构体
+ */
+static void dag_sem_bridge(void *args)
+{
+    dag_sem_bridge_t *bridge = (dag_sem_bridge_t *)args;
+    while(1)
+    {
+        if(acoral_sem_pends(bridge->sem)==KR_OK)
+            dag_trigger(bridge->dag_user,bridge->sem);
+    }
+}
+
+/**
+ * @brief 每次信号量释放触发dag的一个实例，创建一个等待该信号量的桥接线程
+ * 
+ * @param dag_user 用户dag
+ * @param sem 信号量
+ * @param cpu 桥接线程所在cpu
+ * @param prio 桥接线程优先级
+ * @return acoral_id 桥接线程id，失败返回负数
+ */
+acoral_id dag_trigger_on_sem(acoral_dag_user *dag_user, acoral_ipc_t *sem, acoral_u32 cpu, acoral_u8 prio)
+{
+    acoral_comm_policy_data_t p_data;
+    dag_sem_bridge_t *bridge;
+    acoral_id id;
+    if(dag_user==NULL||sem==NULL)
+        return KR_DAG_ERR_NULL;
+    bridge = (dag_sem_bridge_t *)acoral_vol_malloc(sizeof(dag_sem_bridge_t));
+    if(bridge==NULL)
+        return KR_MEM_ERR_MALLOC;
+    bridge->dag_user = dag_user;
+    bridge->sem = sem;
+    p_data.cpu = cpu;
+    p_data.prio = prio;
+    id = acoral_create_thread(dag_sem_bridge,
+                            CFG_DAG_POOL_STACK_SIZE,
+                            bridge,
+                            "acoral_dag_trigger",
+                            NULL,
+                            ACORAL_SCHED_POLICY_COMM,
+                            &p_data,
+                            NULL,
+                            NULL);
+    if(id<0)
+        acoral_vol_free(bridge);
+    return id;
+}
+
+/**
+ * @brief 获取当前实例的触发参数，只能在工作线程池执行的dag节点执行函数中调用
+ * 
+ * @return void* 触发参数，周期释放的实例为NULL
+ */
+void *dag_event_arg(void)
+{
+    acoral_dag_node *node = dag_cur_node();
+    if(node==NULL)
+        return NULL;
+    return node->dag->event_arg[(node->instance*node->rate)%CFG_DAG_POOL_PIPELINE];//第instance次激活所在的实例为instance*rate
+}
+#endif
+
+#ifdef CFG_DAG_STAT
+/**
+ * @brief 获取dag实例统计
+ * 
+ * @param dag_user 用户dag
+ * @param stat 统计输出
+ * @return acoral_err 错误检测
+ */
+acoral_err dag_stat_get(acoral_dag_user *dag_user, acoral_dag_stat_t *stat)
+{
+    acoral_dag *dag;
+    if(dag_user==NULL||dag_user->dag==NULL||stat==NULL)
+        return KR_DAG_ERR_NULL;
+    dag = dag_user->dag;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&dag->lock);
+#endif
+    *stat = dag->stat;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&dag->lock);
+#endif
+    acoral_exit_critical();
+    if(stat->completions)
+        stat->latency_avg = stat->latency_total/stat->completions;
+    return KR_OK;
+}
+
+/**
+ * @brief 清空dag及其节点的统计
+ * 
+ * @param dag_user 用户dag
+ * @return acoral_err 错误检测
+ */
+acoral_err dag_stat_reset(acoral_dag_user *dag_user)
+{
+    acoral_dag *dag;
+    if(dag_user==NULL||dag_user->dag==NULL)
+        return KR_DAG_ERR_NULL;
+    dag = dag_user->dag;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&dag->lock);
+#endif
+    dag_stat_clear(dag);
+#ifdef CFG_SMP
+    acoral_spin_unlock(&dag->lock);
+#endif
+    acoral_exit_critical();
+    return KR_OK;
+}
+
+/**
+ * @brief 打印所有dag的实例统计、延迟直方图、节点统计与最大延迟实例的关键路径，时间单位us
+ * 
+ */
+void dag_stat_report(void)
+{
+    acoral_list_t *dag_tmp,*dag_head,*node_tmp,*node_head;
+    acoral_dag *dag;
+    acoral_dag_node *node;
+    acoral_dag_stat_t stat;
+    acoral_dag_node_stat_t node_stat;
+    acoral_dag_node *path[CFG_DAG_POOL_DEQUE_SIZE];
+    acoral_u16 len,i;
+    acoral_u32 index=0;
+    dag_head = &acoral_dag_queue.head;
+    for(dag_tmp=dag_head->next;dag_tmp!=dag_head;dag_tmp=dag_tmp->next,index++)
+    {
+        dag = list_entry(dag_tmp,acoral_dag,list);
+        if(dag->crit_path==NULL)
+            continue;
+        acoral_enter_critical();
+#ifdef CFG_SMP
+        acoral_spin_lock(&dag->lock);
+#endif
+        stat = dag->stat;
+        len = dag->crit_len;
+        for(i=0;i<len;i++)
+            path[i] = dag->crit_path[i];
+#ifdef CFG_SMP
+        acoral_spin_unlock(&dag->lock);
+#endif
+        acoral_exit_critical();
+        if(stat.completions)
+            stat.latency_avg = stat.latency_total/stat.completions;
+        acoral_print("dag %u: hyper %u release %u finish %u miss %u over %u lmax %u lavg %u",
+                     index,dag->hyper,stat.releases,stat.completions,stat.misses,stat.overruns,
+                     (acoral_u32)(stat.latency_max/1000),(acoral_u32)(stat.latency_avg/1000));
+        if(dag->deadline)
+            acoral_print(" deadline %u\r\n",dag->deadline*1000);
+        else
+            acoral_print(" deadline -\r\n");//事件触发且未给截止期，不统计超期
+        for(i=0;i<CFG_DAG_STAT_HIST_NUM;i++)
+        {
+            if(stat.hist[i])
+                acoral_print("  [%u,%u) %u\r\n",i?1u<<i:0,1u<<(i+1),stat.hist[i]);
+        }
+        acoral_print("  %-20s%4s%8s%9s%9s%9s%6s\r\n","node","cpu","runs","emax","eavg","rmax","crit");
+        node_head = &dag->dag_node_queue.head;
+        for(node_tmp=node_head->next;node_tmp!=node_head;node_tmp=node_tmp->next)
+        {
+            node = list_entry(node_tmp,acoral_dag_node,list);
+            acoral_enter_critical();
+#ifdef CFG_SMP
+            acoral_spin_lock(&dag->lock);
+#endif
+            node_stat = node->stat;
+#ifdef CFG_SMP
+            acoral_spin_unlock(&dag->lock);
+#endif
+            acoral_exit_critical();
+            acoral_print("  %-20s%4u%8u%9u%9u%9u%6u\r\n",
+                         node->name?node->name:"-",node->processor,node_stat.runs,
+                         (acoral_u32)(node_stat.exec_max/1000),
+                         (acoral_u32)(node_stat.runs?node_stat.exec_total/node_stat.runs/1000:0),
+                         (acoral_u32)(node_stat.response_max/1000),node_stat.critical);
+        }
+        acoral_print("  critical path:");
+        for(i=len;i>0;i--)
+            acoral_print(" %s",path[i-1]->name?path[i-1]->name:"-");
+        acoral_print("\r\n");
+    }
+}
+#endif
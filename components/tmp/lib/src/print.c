@@ -12,10 +12,25 @@
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-09-21 <td>增加注释
  *         <tr><td>v2.0 <td>胡博文 <td>2023-10-28 <td>解决多核打印
+ *         <tr><td>v2.1 <td>胡博文 <td>2026-10-19 <td>先格式化到栈上再写入串口发送缓冲区，不再关中断等待串口
  */
 #include <print.h>
 #include <lsched.h>
 #include <spinlock.h>
+#ifdef CFG_UART_TX_RING
+#include "uart.h"
+///格式化缓冲区字节数，不超过该长度的一条打印整体写入串口发送缓冲区，不与其他cpu的打印交错
+#define PRINT_BUF_SIZE 128
+
+/**
+ * @brief 格式化缓冲区
+ * 
+ */
+typedef struct {
+    char8 buf[PRINT_BUF_SIZE];
+    s32 len;
+} print_buf_t;
+#endif
 typedef struct params_s {
     s32 len;
     s32 num1;
@@ -24,10 +39,34 @@ typedef struct params_s {
     s32 do_padding;
     s32 left_flag;
     s32 unsigned_flag;
+#ifdef CFG_UART_TX_RING
+    print_buf_t *out;
+#endif
 } params_t;
-#ifdef CFG_SMP
+#if defined(CFG_SMP) && !defined(CFG_UART_TX_RING)
 acoral_spinlock_t print_lock;
 #endif
+
+/**
+ * @brief 输出一个字符，使用发送缓冲区时先存入格式化缓冲区，满了再写入串口
+ * 
+ * @param par 格式参数
+ * @param c 字符
+ */
+static void print_putc(const struct params_s *par, char8 c)
+{
+#ifdef CFG_UART_TX_RING
+    print_buf_t *out = par->out;
+    out->buf[out->len++] = c;
+    if (out->len == PRINT_BUF_SIZE) {
+        acoral_uart_write(out->buf, out->len);
+        out->len = 0;
+    }
+#else
+    (void)par;
+    outbyte(c);
+#endif
+}
 /*---------------------------------------------------*/
 /* The purpose of this routine is to output data the */
 /* same as the standard printf function without the  */
@@ -50,7 +89,7 @@ static void padding( const s32 l_flag, const struct params_s *par)
         i=(par->len);
         for (; i<(par->num1); i++) {
 #ifdef STDOUT_BASEADDRESS
-            outbyte( par->pad_character);
+            print_putc(par, par->pad_character);
 #endif
         }
     }
@@ -75,7 +114,7 @@ static void outs(const charptr lp, struct params_s *par)
     while (((*LocalPtr) != (char8)0) && ((par->num2) != 0)) {
         (par->num2)--;
 #ifdef STDOUT_BASEADDRESS
-        outbyte(*LocalPtr);
+        print_putc(par, *LocalPtr);
 #endif
         LocalPtr += 1;
 }
@@ -135,7 +174,7 @@ static void outnum( const s32 n, const s32 base, struct params_s *par)
     padding( !(par->left_flag), par);
     while (&outbuf[i] >= outbuf) {
 #ifdef STDOUT_BASEADDRESS
-    outbyte( outbuf[i] );
+    print_putc(par, outbuf[i] );
 #endif
         i--;
 }
@@ -172,6 +211,10 @@ static s32 getnum( charptr* linep)
 
 void smp_print( const char8 *ctrl1, ...)
 {
+#ifdef CFG_UART_TX_RING
+    print_buf_t out;
+    out.len = 0;
+#else
 #ifdef CFG_SMP
     static int print_init = 0;
     if(print_init == 0)
@@ -183,6 +226,7 @@ void smp_print( const char8 *ctrl1, ...)
     acoral_enter_critical();
 #ifdef CFG_SMP
     acoral_spin_lock(&print_lock);
+#endif
 #endif
     s32 Check;
 #if defined (__aarch64__) || defined (__arch64__)
@@ -196,6 +240,9 @@ void smp_print( const char8 *ctrl1, ...)
     va_list argp;
     char8 *ctrl = (char8 *)ctrl1;
 
+#ifdef CFG_UART_TX_RING
+    par.out = &out;
+#endif
     va_start( argp, ctrl1);
 
     while ((ctrl != NULL) && (*ctrl != (char8)0)) {
@@ -204,7 +251,7 @@ void smp_print( const char8 *ctrl1, ...)
         /* format control is found.                    */
         if (*ctrl != '%') {
 #ifdef STDOUT_BASEADDRESS
-            outbyte(*ctrl);
+            print_putc(&par, *ctrl);
 #endif
             ctrl += 1;
             continue;
@@ -256,7 +303,7 @@ void smp_print( const char8 *ctrl1, ...)
         switch (tolower((s32)ch)) {
             case '%':
 #ifdef STDOUT_BASEADDRESS
-                outbyte( '%');
+                print_putc(&par, '%');
 #endif
                 Check = 1;
                 break;
@@ -325,7 +372,7 @@ void smp_print( const char8 *ctrl1, ...)
 
             case 'c':
 #ifdef STDOUT_BASEADDRESS
-                outbyte( va_arg( argp, s32));
+                print_putc(&par, va_arg( argp, s32));
 #endif
                 Check = 1;
                 break;
@@ -334,28 +381,28 @@ void smp_print( const char8 *ctrl1, ...)
                 switch (*ctrl) {
                     case 'a':
 #ifdef STDOUT_BASEADDRESS
-                        outbyte( ((char8)0x07));
+                        print_putc(&par, ((char8)0x07));
 #endif
                         break;
                     case 'h':
 #ifdef STDOUT_BASEADDRESS
-                        outbyte( ((char8)0x08));
+                        print_putc(&par, ((char8)0x08));
 #endif
                         break;
                     case 'r':
 #ifdef STDOUT_BASEADDRESS
-                        outbyte( ((char8)0x0D));
+                        print_putc(&par, ((char8)0x0D));
 #endif
                         break;
                     case 'n':
 #ifdef STDOUT_BASEADDRESS
-                        outbyte( ((char8)0x0D));
-                        outbyte( ((char8)0x0A));
+                        print_putc(&par, ((char8)0x0D));
+                        print_putc(&par, ((char8)0x0A));
 #endif
                         break;
                     default:
 #ifdef STDOUT_BASEADDRESS
-                        outbyte( *ctrl);
+                        print_putc(&par, *ctrl);
 #endif
                         break;
                 }
@@ -376,8 +423,14 @@ void smp_print( const char8 *ctrl1, ...)
         goto try_next;
     }
     va_end( argp);
+#ifdef CFG_UART_TX_RING
+    if (out.len > 0) {
+        acoral_uart_write(out.buf, out.len);
+    }
+#else
 #ifdef CFG_SMP
     acoral_spin_unlock(&print_lock);
 #endif
     acoral_exit_critical();
+#endif
 }
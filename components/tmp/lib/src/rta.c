@@ -0,0 +1,792 @@
+/**
+ * @file rta.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief component层lib库响应时间分析相关源文件，不依赖内核，可在主机端编译
+ * @version 1.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>从准入控制中抽出的响应时间分析
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>增量分析与迭代次数上限
+ */
+#include <rta.h>
+
+///分析标记：待重新计算
+#define RTA_MARK_DIRTY (1<<0)
+///分析标记：wcrt已保存
+#define RTA_MARK_SAVED (1<<1)
+
+/**
+ * @brief 计算干扰次数ceil((t+wcrt-nl)/period)，分子不为正时为0
+ *
+ * @param t 迭代延迟
+ * @param wcrt 干扰任务最坏响应时间
+ * @param nl 干扰量
+ * @param period 干扰任务周期
+ * @return acoral_u64 干扰次数
+ */
+static acoral_u64 rta_ceil(acoral_u32 t, acoral_u32 wcrt, acoral_u32 nl, acoral_u32 period)
+{
+    acoral_u64 num=(acoral_u64)t+wcrt;
+    if(num<=nl||period==0)
+        return 0;
+    num-=nl;
+    return (num+period-1)/period;
+}
+
+/**
+ * @brief 将64位延迟饱和到32位
+ *
+ * @param value 延迟
+ * @return acoral_u32 延迟，溢出时为ACORAL_RTA_UNSCHED
+ */
+static acoral_u32 rta_sat(acoral_u64 value)
+{
+    if(value>=ACORAL_RTA_UNSCHED)
+        return ACORAL_RTA_UNSCHED;
+    return (acoral_u32)value;
+}
+
+/**
+ * @brief 任务是否参与分析
+ *
+ * @param task 任务指针
+ * @return acoral_bool 是否参与
+ */
+static acoral_bool rta_active(acoral_rta_task_t *task)
+{
+    return (!task->skip)&&task->cpu!=ACORAL_RTA_NO_CPU;
+}
+
+/**
+ * @brief 查找任务对某资源的使用
+ *
+ * @param task 任务指针
+ * @param res 资源下标
+ * @return acoral_rta_use_t* 使用项，未使用时为NULL
+ */
+static acoral_rta_use_t *rta_use(acoral_rta_task_t *task, acoral_u32 res)
+{
+    acoral_u32 k;
+    for(k=0;k<task->use_num;k++)
+    {
+        if(task->use[k].res==res)
+            return &task->use[k];
+    }
+    return NULL;
+}
+
+/**
+ * @brief 资源是否为代理在某cpu上的全局资源
+ *
+ * @param set 任务集
+ * @param res 资源下标
+ * @param cpu cpu
+ * @return acoral_bool 是否
+ */
+static acoral_bool rta_global_on(acoral_rta_set_t *set, acoral_u32 res, acoral_u32 cpu)
+{
+    return set->res[res].global&&set->res[res].cpu==cpu;
+}
+
+/**
+ * @brief 分析前缓存各任务全局资源临界区总长度
+ *
+ * @param set 任务集
+ */
+static void rta_prepare(acoral_rta_set_t *set)
+{
+    acoral_rta_task_t *task;
+    acoral_u32 i,k;
+    for(i=0;i<set->task_num;i++)
+    {
+        task=&set->task[i];
+        task->nl=0;
+        for(k=0;k<task->use_num;k++)
+        {
+            if(set->res[task->use[k].res].global)
+                task->nl+=task->use[k].cnt*task->use[k].len;
+        }
+    }
+}
+
+/**
+ * @brief 局部资源延迟
+ *
+ * @param set 任务集
+ * @param index 任务下标
+ * @return acoral_u32 延迟时间
+ */
+static acoral_u32 rta_latency_b(acoral_rta_set_t *set, acoral_u32 index)
+{
+    acoral_rta_task_t *data=&set->task[index];
+    acoral_rta_task_t *task;
+    acoral_rta_res_t *res;
+    acoral_u32 i,k;
+    acoral_u64 global_n=0;
+    acoral_u32 local_l_max=0;
+    for(k=0;k<data->use_num;k++)//计算获取全局资源次数
+    {
+        if(set->res[data->use[k].res].global)
+            global_n+=data->use[k].cnt;
+    }
+    for(i=0;i<set->task_num;i++)//此核低优先级任务使用天花板高于本任务的局部资源的最长临界区
+    {
+        task=&set->task[i];
+        if(!rta_active(task)||task->cpu!=data->cpu||task->prio<=data->prio)
+            continue;
+        for(k=0;k<task->use_num;k++)
+        {
+            res=&set->res[task->use[k].res];
+            if(!res->global&&res->ceiling<data->prio&&task->use[k].len>local_l_max)
+                local_l_max=task->use[k].len;
+        }
+    }
+    return rta_sat((global_n+1)*local_l_max);
+}
+
+/**
+ * @brief 非全局资源临界区延迟，即本核高优先级任务的抢占
+ *
+ * @param set 任务集
+ * @param index 任务下标
+ * @param t 迭代延迟
+ * @return acoral_u32 延迟时间
+ */
+static acoral_u32 rta_latency_ng(acoral_rta_set_t *set, acoral_u32 index, acoral_u32 t)
+{
+    acoral_rta_task_t *data=&set->task[index];
+    acoral_rta_task_t *task;
+    acoral_u32 i;
+    acoral_u32 c_ng;
+    acoral_u64 ret=0;
+    for(i=0;i<set->task_num;i++)
+    {
+        task=&set->task[i];
+        if(!rta_active(task)||task->cpu!=data->cpu||task->prio>=data->prio)
+            continue;
+        c_ng=task->wcet>task->nl?task->wcet-task->nl:0;//全局资源临界区在资源代理所在cpu上执行
+        ret+=rta_ceil(t,task->wcrt,c_ng,task->period)*c_ng;
+    }
+    return rta_sat(ret);
+}
+
+/**
+ * @brief 时间表中起始时刻早于t的时间段总长度
+ *
+ * @param timed 时间表
+ * @param t 时刻
+ * @return acoral_u32 总长度
+ */
+static acoral_u32 rta_epsilon(const acoral_rta_timed_t *timed, acoral_u32 t)
+{
+    acoral_u32 k;
+    acoral_u32 ret=0;
+    for(k=0;k<timed->slot_num;k++)
+    {
+        if(timed->start[k]<t)
+            ret+=timed->len[k];
+        else
+            break;
+    }
+    return ret;
+}
+
+/**
+ * @brief 时间确定性任务抢占延迟
+ *
+ * @param set 任务集
+ * @param cpu 所在cpu
+ * @param t 迭代延迟
+ * @return acoral_u32 延迟时间
+ */
+static acoral_u32 rta_latency_t(acoral_rta_set_t *set, acoral_u32 cpu, acoral_u32 t)
+{
+    const acoral_rta_timed_t *timed;
+    acoral_u32 k,sum=0;
+    acoral_u64 end,latency,latency_max=0;
+    if(set->timed==NULL||cpu>=set->cpu_num)
+        return 0;
+    timed=&set->timed[cpu];
+    if(timed->slot_num==0||timed->h_period==0)
+        return 0;
+    for(k=0;k<timed->slot_num;k++)
+        sum+=timed->len[k];
+    for(k=0;k<timed->slot_num;k++)//从每个时间段起始处开始的窗口内最多的抢占量
+    {
+        end=(acoral_u64)timed->start[k]+t;
+        latency=(acoral_u64)sum*(end/timed->h_period)
+                +rta_epsilon(timed,(acoral_u32)(end%timed->h_period))-rta_epsilon(timed,timed->start[k]);
+        if(latency>latency_max)
+            latency_max=latency;
+    }
+    return rta_sat(latency_max);
+}
+
+/**
+ * @brief 单次请求某cpu上全局资源的延迟
+ *
+ * @param set 任务集
+ * @param index 任务下标
+ * @param start 迭代开始延迟
+ * @param cpu 资源代理所在cpu
+ * @return acoral_u32 延迟时间，超过截止时间时为ACORAL_RTA_UNSCHED
+ */
+static acoral_u32 rta_h_g(acoral_rta_set_t *set, acoral_u32 index, acoral_u32 start, acoral_u32 cpu)
+{
+    acoral_rta_task_t *data=&set->task[index];
+    acoral_rta_task_t *task;
+    acoral_rta_use_t *use;
+    acoral_u32 i,r,iter=0;
+    acoral_u32 h_g=start;
+    acoral_u64 h_g_temp;
+    while(h_g<=data->dl)
+    {
+        if(set->iter_max&&iter++>=set->iter_max)//迭代次数超限
+            return ACORAL_RTA_UNSCHED;
+        h_g_temp=start;
+        for(r=0;r<set->res_num;r++)//该核全局资源上高优先级任务的临界区
+        {
+            if(!rta_global_on(set,r,cpu))
+                continue;
+            for(i=0;i<set->task_num;i++)
+            {
+                task=&set->task[i];
+                if(!rta_active(task)||task->prio>=data->prio)
+                    continue;
+                use=rta_use(task,r);
+                if(use!=NULL)
+                    h_g_temp+=rta_ceil(h_g,task->wcrt,use->cnt*use->len,task->period)*use->cnt*use->len;
+            }
+        }
+        h_g_temp+=rta_latency_t(set,cpu,h_g);
+        if(h_g_temp==h_g)
+            return h_g;
+        h_g=rta_sat(h_g_temp);
+    }
+    return ACORAL_RTA_UNSCHED;
+}
+
+/**
+ * @brief 请求其他cpu上全局资源的直接延迟上界，与迭代延迟无关，在迭代前计算
+ *
+ * @param set 任务集
+ * @param index 任务下标
+ * @param dd_g 各cpu上的直接延迟上界
+ * @return acoral_u32 使用了全局资源的cpu掩码，某次请求超过截止时间时为ACORAL_RTA_UNSCHED
+ */
+static acoral_u32 rta_dd_g(acoral_rta_set_t *set, acoral_u32 index, acoral_u64 *dd_g)
+{
+    acoral_rta_task_t *data=&set->task[index];
+    acoral_rta_task_t *task;
+    acoral_rta_use_t *use,*use_this;
+    acoral_u32 c,r,i,k;
+    acoral_u32 h_g_bound,global_l_max;
+    acoral_u32 mask=0;
+    for(c=0;c<set->cpu_num&&c<ACORAL_RTA_MAX_CPU;c++)
+    {
+        if(c==data->cpu)
+            continue;
+        for(r=0;r<set->res_num;r++)//本任务是否使用该核全局资源
+        {
+            if(rta_global_on(set,r,c)&&rta_use(data,r)!=NULL)
+                break;
+        }
+        if(r==set->res_num)
+            continue;
+        global_l_max=0;
+        for(r=0;r<set->res_num;r++)//低优先级任务在该核全局资源上的最长临界区
+        {
+            if(!rta_global_on(set,r,c)||set->res[r].ceiling>=data->prio)
+                continue;
+            for(i=0;i<set->task_num;i++)
+            {
+                task=&set->task[i];
+                if(!rta_active(task)||task->prio<=data->prio)
+                    continue;
+                use=rta_use(task,r);
+                if(use!=NULL&&use->len>global_l_max)
+                    global_l_max=use->len;
+            }
+        }
+        dd_g[c]=0;
+        for(k=0;k<data->use_num;k++)//逐个请求的延迟上界
+        {
+            use_this=&data->use[k];
+            if(!rta_global_on(set,use_this->res,c))
+                continue;
+            h_g_bound=rta_h_g(set,index,use_this->len+global_l_max,c);
+            if(h_g_bound>data->dl)
+                return ACORAL_RTA_UNSCHED;
+            dd_g[c]+=(acoral_u64)use_this->cnt*h_g_bound;
+        }
+        mask|=1<<c;
+    }
+    return mask;
+}
+
+/**
+ * @brief 请求全局资源的延迟
+ *
+ * @param set 任务集
+ * @param index 任务下标
+ * @param t 迭代延迟
+ * @param mask 使用了全局资源的cpu掩码
+ * @param dd_g 各cpu上的直接延迟上界
+ * @return acoral_u32 延迟时间
+ */
+static acoral_u32 rta_latency_g(acoral_rta_set_t *set, acoral_u32 index, acoral_u32 t, acoral_u32 mask, const acoral_u64 *dd_g)
+{
+    acoral_rta_task_t *data=&set->task[index];
+    acoral_rta_task_t *task;
+    acoral_rta_use_t *use;
+    acoral_u32 c,r,i;
+    acoral_u32 nl;
+    acoral_u64 pd_g;
+    acoral_u64 ret=0;
+    for(c=0;c<set->cpu_num&&c<ACORAL_RTA_MAX_CPU;c++)
+    {
+        if(c!=data->cpu&&!(mask&(1<<c)))
+            continue;
+        pd_g=0;
+        for(r=0;r<set->res_num;r++)
+        {
+            if(!rta_global_on(set,r,c))
+                continue;
+            for(i=0;i<set->task_num;i++)
+            {
+                task=&set->task[i];
+                if(!rta_active(task))
+                    continue;
+                use=rta_use(task,r);
+                if(use==NULL)
+                    continue;
+                nl=use->cnt*use->len;
+                if(i!=index)
+                    pd_g+=rta_ceil(t,task->wcrt,nl,task->period)*nl;
+                else if(c!=data->cpu)
+                    pd_g+=nl;
+            }
+        }
+        if(c==data->cpu)//本核上的全局资源代理会抢占本任务
+        {
+            ret+=pd_g;
+            continue;
+        }
+        pd_g+=rta_latency_t(set,c,t);
+        ret+=pd_g<dd_g[c]?pd_g:dd_g[c];
+    }
+    return rta_sat(ret);
+}
+
+/**
+ * @brief 单个任务的响应时间迭代，需已调用rta_prepare
+ *
+ * @param set 任务集
+ * @param index 任务下标
+ * @return acoral_u32 响应时间，超过截止时间或迭代次数超限时为ACORAL_RTA_UNSCHED
+ */
+static acoral_u32 rta_response_time(acoral_rta_set_t *set, acoral_u32 index)
+{
+    acoral_rta_task_t *data=&set->task[index];
+    acoral_u32 test_end=data->dl;
+    acoral_u32 response=data->wcet;
+    acoral_u32 latency,mask,iter=0;
+    acoral_u64 response_temp;
+    acoral_u64 dd_g[ACORAL_RTA_MAX_CPU];
+    mask=rta_dd_g(set,index,dd_g);
+    if(mask==ACORAL_RTA_UNSCHED)
+        return ACORAL_RTA_UNSCHED;
+    while(response<=test_end)
+    {
+        if(set->iter_max&&iter++>=set->iter_max)//迭代次数超限
+            return ACORAL_RTA_UNSCHED;
+        response_temp=data->wcet;
+        latency=rta_latency_ng(set,index,response);
+        if(latency>test_end)
+            return ACORAL_RTA_UNSCHED;
+        response_temp+=latency;
+        latency=rta_latency_t(set,data->cpu,response);
+        if(latency>test_end)
+            return ACORAL_RTA_UNSCHED;
+        response_temp+=latency;
+        latency=rta_latency_g(set,index,response,mask,dd_g);
+        if(latency>test_end)
+            return ACORAL_RTA_UNSCHED;
+        response_temp+=latency;
+        if(response_temp==response)
+        {
+            latency=rta_latency_b(set,index);
+            if(latency>test_end||(acoral_u64)response+latency>test_end)
+                return ACORAL_RTA_UNSCHED;
+            return response+latency;
+        }
+        response=rta_sat(response_temp);
+    }
+    return ACORAL_RTA_UNSCHED;
+}
+
+/**
+ * @brief 单个任务的响应时间迭代
+ *
+ * @param set 任务集
+ * @param index 任务下标
+ * @return acoral_u32 响应时间，超过截止时间或迭代次数超限时为ACORAL_RTA_UNSCHED
+ */
+acoral_u32 acoral_rta_response_time(acoral_rta_set_t *set, acoral_u32 index)
+{
+    rta_prepare(set);
+    return rta_response_time(set,index);
+}
+
+/**
+ * @brief 任务集可调度性分析，按优先级从高到低逐个计算响应时间
+ *
+ * 可调度的任务更新wcrt，不可调度的任务保留原wcrt，结果均记录在response中
+ *
+ * @param set 任务集
+ * @return acoral_bool 是否全部可调度
+ */
+acoral_bool acoral_rta_analyse(acoral_rta_set_t *set)
+{
+    acoral_rta_task_t *task,*next;
+    acoral_u32 i;
+    acoral_bool ok=true;
+    rta_prepare(set);
+    for(i=0;i<set->task_num;i++)
+        set->task[i].mark=0;
+    while(1)
+    {
+        next=NULL;
+        for(i=0;i<set->task_num;i++)//选出未分析的最高优先级任务
+        {
+            task=&set->task[i];
+            if(task->mark||!rta_active(task))
+                continue;
+            if(next==NULL||task->prio<next->prio)
+                next=task;
+        }
+        if(next==NULL)
+            break;
+        next->mark=1;
+        next->response=rta_response_time(set,next-set->task);
+        if(next->response<=next->dl)
+            next->wcrt=next->response;
+        else
+            ok=false;
+    }
+    return ok;
+}
+
+/**
+ * @brief 源任务的参数或响应时间改变时，目标任务的响应时间是否可能改变
+ *
+ * @param set 任务集
+ * @param src 源任务指针
+ * @param dst 目标任务指针
+ * @return acoral_bool 是否受影响
+ */
+static acoral_bool rta_affects(acoral_rta_set_t *set, acoral_rta_task_t *src, acoral_rta_task_t *dst)
+{
+    acoral_rta_res_t *res;
+    acoral_u32 k,j;
+    if(dst->cpu==src->cpu&&(src->prio<dst->prio||src->use_num))//本核抢占、局部资源阻塞或本核资源代理
+        return true;
+    for(k=0;k<src->use_num;k++)
+    {
+        if(rta_use(dst,src->use[k].res)!=NULL)//共享资源，天花板与类型可能改变
+            return true;
+        res=&set->res[src->use[k].res];
+        if(!res->global)
+            continue;
+        if(res->cpu==dst->cpu)
+            return true;
+        for(j=0;j<dst->use_num;j++)//竞争同一cpu上的资源代理
+        {
+            if(rta_global_on(set,dst->use[j].res,res->cpu))
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 标记受某任务影响的任务待重新计算
+ *
+ * @param set 任务集
+ * @param src 源任务指针
+ */
+static void rta_mark_affected(acoral_rta_set_t *set, acoral_rta_task_t *src)
+{
+    acoral_rta_task_t *task;
+    acoral_u32 i;
+    for(i=0;i<set->task_num;i++)
+    {
+        task=&set->task[i];
+        if(task!=src&&rta_active(task)&&rta_affects(set,src,task))
+            task->mark|=RTA_MARK_DIRTY;
+    }
+}
+
+/**
+ * @brief 恢复增量分析中改变的wcrt
+ *
+ * @param set 任务集
+ */
+static void rta_restore(acoral_rta_set_t *set)
+{
+    acoral_u32 i;
+    for(i=0;i<set->task_num;i++)
+    {
+        if(set->task[i].mark&RTA_MARK_SAVED)
+            set->task[i].wcrt=set->task[i].wcrt_saved;
+    }
+}
+
+/**
+ * @brief 增量可调度性分析，某个任务加入（或cpu、优先级改变）后只重新计算受其影响的任务
+ *
+ * 其余任务的wcrt需为上一次分析的结果。按优先级从高到低重新计算待计算的任务，
+ * 响应时间改变时再标记受其影响的任务，直到不再变化。
+ * 不可调度时恢复全部wcrt并立即返回，未重新计算的任务response不变
+ *
+ * @param set 任务集
+ * @param index 加入的任务下标
+ * @return acoral_bool 是否全部可调度
+ */
+acoral_bool acoral_rta_analyse_incr(acoral_rta_set_t *set, acoral_u32 index)
+{
+    acoral_rta_task_t *task,*next;
+    acoral_rta_task_t *data=&set->task[index];
+    acoral_u32 i,k;
+    acoral_u32 budget=set->task_num*ACORAL_RTA_INCR_ROUND;
+    rta_prepare(set);
+    for(i=0;i<set->task_num;i++)
+        set->task[i].mark=0;
+    if(!rta_active(data))
+        return true;
+    data->mark|=RTA_MARK_DIRTY;
+    rta_mark_affected(set,data);
+    for(k=0;k<data->use_num;k++)//共享资源的任务参数可能随资源类型改变
+    {
+        for(i=0;i<set->task_num;i++)
+        {
+            task=&set->task[i];
+            if(task!=data&&rta_active(task)&&rta_use(task,data->use[k].res)!=NULL)
+                rta_mark_affected(set,task);
+        }
+    }
+    while(1)
+    {
+        next=NULL;
+        for(i=0;i<set->task_num;i++)//选出待计算的最高优先级任务
+        {
+            task=&set->task[i];
+            if(!(task->mark&RTA_MARK_DIRTY))
+                continue;
+            if(next==NULL||task->prio<next->prio)
+                next=task;
+        }
+        if(next==NULL)
+            return true;
+        if(budget==0)//不收敛，按不可调度处理
+            break;
+        budget--;
+        next->mark&=~RTA_MARK_DIRTY;
+        next->response=rta_response_time(set,next-set->task);
+        if(next->response>next->dl)
+            break;
+        if(next->response!=next->wcrt)
+        {
+            if(!(next->mark&RTA_MARK_SAVED))
+            {
+                next->wcrt_saved=next->wcrt;
+                next->mark|=RTA_MARK_SAVED;
+            }
+            next->wcrt=next->response;
+            rta_mark_affected(set,next);
+        }
+    }
+    rta_restore(set);
+    return false;
+}
+
+/**
+ * @brief 根据任务放置情况绑定资源：资源代理在最先放置的使用者所在cpu，
+ * 被其他cpu上的任务使用时为全局资源，天花板为使用者中的最高优先级
+ *
+ * @param set 任务集
+ */
+void acoral_rta_bind_res(acoral_rta_set_t *set)
+{
+    acoral_rta_res_t *res;
+    acoral_rta_task_t *task,*first;
+    acoral_u32 r,i;
+    for(r=0;r<set->res_num;r++)
+    {
+        res=&set->res[r];
+        first=NULL;
+        res->global=0;
+        res->ceiling=ACORAL_RTA_UNSCHED;
+        for(i=0;i<set->task_num;i++)
+        {
+            task=&set->task[i];
+            if(!rta_active(task)||rta_use(task,r)==NULL)
+                continue;
+            if(first==NULL||task->seq<first->seq)
+                first=task;
+            if(task->prio<res->ceiling)
+                res->ceiling=task->prio;
+        }
+        if(!res->pinned)
+            res->cpu=first!=NULL?first->cpu:ACORAL_RTA_NO_CPU;
+        for(i=0;i<set->task_num;i++)
+        {
+            task=&set->task[i];
+            if(rta_active(task)&&rta_use(task,r)!=NULL&&task->cpu!=res->cpu)
+                res->global=1;
+        }
+    }
+}
+
+/**
+ * @brief cpu负载，包括时间确定性任务、本核任务的非全局部分与本核资源代理执行的全局临界区
+ *
+ * @param set 任务集
+ * @param cpu cpu
+ * @return acoral_u32 负载（百万分之一）
+ */
+acoral_u32 acoral_rta_cpu_load(acoral_rta_set_t *set, acoral_u32 cpu)
+{
+    acoral_rta_task_t *task;
+    acoral_u32 i,k,sum=0;
+    acoral_u64 load=0;
+    rta_prepare(set);
+    if(set->timed!=NULL&&cpu<set->cpu_num&&set->timed[cpu].h_period)
+    {
+        for(k=0;k<set->timed[cpu].slot_num;k++)
+            sum+=set->timed[cpu].len[k];
+        load+=(acoral_u64)sum*1000000/set->timed[cpu].h_period;
+    }
+    for(i=0;i<set->task_num;i++)
+    {
+        task=&set->task[i];
+        if(!rta_active(task)||task->period==0)
+            continue;
+        if(task->cpu==cpu)
+            load+=(acoral_u64)(task->wcet>task->nl?task->wcet-task->nl:0)*1000000/task->period;
+        for(k=0;k<task->use_num;k++)
+        {
+            if(rta_global_on(set,task->use[k].res,cpu))
+                load+=(acoral_u64)task->use[k].cnt*task->use[k].len*1000000/task->period;
+        }
+    }
+    return rta_sat(load);
+}
+
+/**
+ * @brief 按截止时间单调分配优先级，截止时间相同时周期短的优先
+ *
+ * @param set 任务集
+ * @param prio_base 最高优先级
+ * @param prio_step 相邻优先级间隔
+ */
+void acoral_rta_assign_prio(acoral_rta_set_t *set, acoral_u32 prio_base, acoral_u32 prio_step)
+{
+    acoral_rta_task_t *task,*next;
+    acoral_u32 i,rank;
+    for(i=0;i<set->task_num;i++)
+        set->task[i].mark=0;
+    for(rank=0;rank<set->task_num;rank++)
+    {
+        next=NULL;
+        for(i=0;i<set->task_num;i++)
+        {
+            task=&set->task[i];
+            if(task->mark)
+                continue;
+            if(next==NULL||task->dl<next->dl||(task->dl==next->dl&&task->period<next->period))
+                next=task;
+        }
+        next->mark=1;
+        next->prio=prio_base+rank*prio_step;
+    }
+}
+
+/**
+ * @brief 任务划分：按利用率从大到小依次放置，与准入控制一样优先尝试负载最小的cpu，
+ * 放置后增量分析整体可调度才接受
+ *
+ * @param set 任务集，任务需已分配优先级
+ * @return acoral_u32 无法放置的任务数量，这些任务的cpu为ACORAL_RTA_NO_CPU
+ */
+acoral_u32 acoral_rta_partition(acoral_rta_set_t *set)
+{
+    acoral_rta_task_t *task,*next;
+    acoral_u32 i,k,c,cpu,seq=0,fail=0;
+    acoral_u32 load,best_load;
+    acoral_u32 tried;
+    for(i=0;i<set->task_num;i++)
+    {
+        set->task[i].cpu=ACORAL_RTA_NO_CPU;
+        set->task[i].wcrt=set->task[i].dl;
+        set->task[i].skip=0;
+    }
+    while(1)
+    {
+        next=NULL;
+        for(i=0;i<set->task_num;i++)//未放置任务中利用率最大的
+        {
+            task=&set->task[i];
+            if(task->cpu!=ACORAL_RTA_NO_CPU||task->skip||task->period==0)
+                continue;
+            if(next==NULL||(acoral_u64)task->wcet*next->period>(acoral_u64)next->wcet*task->period)
+                next=task;
+        }
+        if(next==NULL)
+            break;
+        next->seq=seq++;
+        tried=0;
+        for(k=0;k<set->cpu_num;k++)//按负载从小到大尝试各cpu
+        {
+            cpu=ACORAL_RTA_NO_CPU;
+            best_load=0;
+            for(c=0;c<set->cpu_num&&c<32;c++)
+            {
+                if(tried&(1<<c))
+                    continue;
+                load=acoral_rta_cpu_load(set,c);
+                if(cpu==ACORAL_RTA_NO_CPU||load<best_load)
+                {
+                    cpu=c;
+                    best_load=load;
+                }
+            }
+            if(cpu==ACORAL_RTA_NO_CPU)
+                break;
+            tried|=1<<cpu;
+            next->cpu=cpu;
+            next->wcrt=next->dl;
+            acoral_rta_bind_res(set);
+            if(acoral_rta_analyse_incr(set,next-set->task))//失败时已恢复尝试前的响应时间
+                break;
+            next->cpu=ACORAL_RTA_NO_CPU;
+        }
+        if(next->cpu==ACORAL_RTA_NO_CPU)//放不下，之后的分析中不考虑
+        {
+            next->skip=1;
+            next->response=ACORAL_RTA_UNSCHED;
+            fail++;
+            acoral_rta_bind_res(set);//恢复尝试前的资源绑定
+        }
+    }
+    for(i=0;i<set->task_num;i++)
+        set->task[i].skip=0;
+    acoral_rta_bind_res(set);
+    acoral_rta_analyse(set);
+    return fail;
+}
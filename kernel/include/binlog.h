@@ -0,0 +1,63 @@
+/**
+ * @file binlog.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层二进制日志头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>每cpu无锁二进制日志，格式化在主机端完成
+ */
+#ifndef KERNEL_BINLOG_H
+#define KERNEL_BINLOG_H
+#include <config.h>
+#include <type.h>
+#include <mem.h>
+
+///格式串所在段，链接脚本中不加载且地址从0开始，格式串的地址即格式串号
+#define ACORAL_BINLOG_SECTION ".acoral_log_fmt"
+///记录头字中参数个数的位移，低28位为格式串号
+#define ACORAL_BINLOG_NARGS_SHIFT 28
+///记录头字中格式串号的掩码
+#define ACORAL_BINLOG_FMT_MASK ((1u<<ACORAL_BINLOG_NARGS_SHIFT)-1)
+///记录头的字数：头字、时间戳低32位、时间戳高32位
+#define ACORAL_BINLOG_HEAD_WORDS 3
+
+#ifdef CFG_BINLOG
+#if CFG_BINLOG_MAX_ARGS > 15
+#error "CFG_BINLOG_MAX_ARGS must not exceed 15"
+#endif
+
+/**
+ * @brief 每cpu日志环形缓冲区，以字为单位，只由所在cpu写入，满时丢弃新记录
+ *
+ */
+typedef struct{
+    acoral_u32 word[CFG_BINLOG_RING_WORDS];///<记录，每条为头字、时间戳和参数
+    volatile acoral_u32 head;///<已发布的字数，只由所在cpu增加
+    volatile acoral_u32 tail;///<已读取的字数，只由读取者增加
+    volatile acoral_u32 dropped;///<因满被丢弃的记录数，只由所在cpu增加
+}__attribute__((aligned(ACORAL_CACHE_LINE_SIZE))) acoral_binlog_ring_t;
+
+void acoral_binlog_record(acoral_u32 fmt, acoral_u32 num, const acoral_u32 *args);
+acoral_u32 acoral_binlog_read(acoral_u32 cpu, acoral_u32 *buf, acoral_u32 words, acoral_u32 *lost);
+void acoral_binlog_init(void);
+
+/**
+ * @brief 记录一条日志，格式串放入不加载的段，只记录其地址和参数，参数只支持整数
+ *        支持的格式：%d %i %u %x %X %c %p %%，可带标志和宽度，由主机端工具tools/binlog格式化
+ */
+#define ACORAL_LOG(fmt,...) \
+    do{ \
+        static const char acoral_log_fmt_[] __attribute__((section(ACORAL_BINLOG_SECTION),used))=fmt; \
+        const acoral_u32 acoral_log_args_[]={0,##__VA_ARGS__}; \
+        acoral_binlog_record((acoral_u32)acoral_log_fmt_,sizeof(acoral_log_args_)/sizeof(acoral_u32)-1,&acoral_log_args_[1]); \
+    }while(0)
+#else
+#define ACORAL_LOG(fmt,...) do{}while(0)
+#endif
+#endif
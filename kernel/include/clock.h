@@ -0,0 +1,52 @@
+/**
+ * @file clock.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层64位单调高精度时钟相关头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>基于全局定时器的单调时钟
+ */
+#ifndef KERNEL_CLOCK_H
+#define KERNEL_CLOCK_H
+#include <config.h>
+#include <type.h>
+#include <hal.h>
+
+///时钟源频率(Hz)
+#define ACORAL_CLOCK_HZ HAL_CLOCK_HZ
+
+///时间戳比较：a是否晚于b，对计数回绕安全
+#define ACORAL_CLOCK_AFTER(a,b) ((acoral_64)((acoral_u64)(b)-(acoral_u64)(a))<0)
+///时间戳比较：a是否早于b，对计数回绕安全
+#define ACORAL_CLOCK_BEFORE(a,b) ACORAL_CLOCK_AFTER(b,a)
+///时间戳比较：a是否不早于b，对计数回绕安全
+#define ACORAL_CLOCK_AFTER_EQ(a,b) ((acoral_64)((acoral_u64)(a)-(acoral_u64)(b))>=0)
+///时间戳比较：a是否不晚于b，对计数回绕安全
+#define ACORAL_CLOCK_BEFORE_EQ(a,b) ACORAL_CLOCK_AFTER_EQ(b,a)
+
+/**
+ * @brief 定点换算因子，结果为(value*mult)>>shift
+ *
+ */
+typedef struct{
+    acoral_u32 mult;///<乘数
+    acoral_u32 shift;///<右移位数
+}acoral_clock_conv_t;
+
+void acoral_clock_init(void);
+acoral_u64 acoral_clock_cycles(void);
+acoral_u64 acoral_clock_ns(void);
+acoral_u64 acoral_clock_us(void);
+acoral_u64 acoral_clock_ms(void);
+acoral_u64 acoral_cycles_to_ns(acoral_u64 cycles);
+acoral_u64 acoral_cycles_to_us(acoral_u64 cycles);
+acoral_u64 acoral_cycles_to_ms(acoral_u64 cycles);
+acoral_u64 acoral_ns_to_cycles(acoral_u64 ns);
+acoral_u64 acoral_us_to_cycles(acoral_u64 us);
+#endif
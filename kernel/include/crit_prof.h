@@ -0,0 +1,53 @@
+/**
+ * @file crit_prof.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层临界区分析头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>最外层临界区时长、最长者调用地址、直方图与按调用地址的排行
+ */
+#ifndef KERNEL_CRIT_PROF_H
+#define KERNEL_CRIT_PROF_H
+#include <config.h>
+#include <type.h>
+
+#ifdef CFG_CRIT_PROF
+/**
+ * @brief 一个调用地址的临界区统计，时间单位为cycles
+ *
+ */
+typedef struct{
+    acoral_u32 addr;///<进入临界区的调用地址
+    acoral_u32 count;///<次数
+    acoral_u32 max;///<最长时长
+    acoral_u64 sum;///<时长总和
+}acoral_crit_prof_top_t;
+
+/**
+ * @brief 一个cpu的临界区统计，时间单位为cycles
+ *
+ */
+typedef struct{
+    acoral_u32 count;///<最外层临界区次数
+    acoral_u64 sum;///<时长总和
+    acoral_u32 max;///<最长时长
+    acoral_u32 max_enter;///<最长临界区进入处的调用地址
+    acoral_u32 max_exit;///<最长临界区退出处的调用地址
+    acoral_id max_thread;///<最长临界区所在线程，调度开始前为-1
+    acoral_u32 hist[CFG_CRIT_PROF_HIST_NUM];///<时长直方图，第0桶小于1us，第i桶为[2^(i-1),2^i)us，最后一桶含更长的
+    acoral_crit_prof_top_t top[CFG_CRIT_PROF_TOP_NUM];///<按调用地址统计，保留最长时长最大的几项，未按顺序排列
+}acoral_crit_prof_t;
+
+void acoral_crit_prof_enter(acoral_u32 addr);
+void acoral_crit_prof_exit(acoral_u32 addr);
+acoral_err acoral_crit_prof_get(acoral_u32 cpu, acoral_crit_prof_t *prof);
+void acoral_crit_prof_reset(void);
+void acoral_crit_prof_report(void);
+#endif
+#endif
@@ -11,6 +11,12 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-09-26 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>增加软件定时器与分派表错误
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>增加串口错误
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>增加统计错误
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>增加中断号错误
+ *         <tr><td>v1.5 <td>胡博文 <td>2026-10-19 <td>增加软件定时器状态错误
+ *         <tr><td>v1.6 <td>胡博文 <td>2026-10-19 <td>增加dag环错误
  */
 #ifndef KERNEL_ERROR_H
 #define KERNEL_ERROR_H
@@ -41,6 +47,17 @@ typedef enum {
     KR_IPC_ERR_TIMEOUT,///<线程通信错误：超时
     KR_IPC_ERR_THREAD,///<线程通信错误：无线程
     KR_IPC_ERR_CPU,///<线程通信错误：cpu错误
+    KR_TIMER_ERR_NULL,///<软件定时器错误：空指针
+    KR_TIMER_ERR_CPU,///<软件定时器错误：cpu错误
+    KR_TIMER_ERR_STATE,///<软件定时器错误：定时器已归还到池中
+    KR_POLICY_ERR_FULL,///<线程策略错误：表已满
+    KR_DAG_ERR_NULL,///<dag错误：空指针或未映射
+    KR_DAG_ERR_DROP,///<dag错误：触发被丢弃
+    KR_DAG_ERR_CYCLE,///<dag错误：图中存在环
+    KR_UART_ERR_INIT,///<串口错误：初始化失败
+    KR_STAT_ERR_NULL,///<统计错误：空指针
+    KR_STAT_ERR_CPU,///<统计错误：cpu号错误
+    KR_STAT_ERR_IRQ,///<统计错误：中断号错误
     KR_OK = 0///<OK
 }kernel_error_t;
 #endif
@@ -11,6 +11,7 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-08 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>可嵌套的本cpu关中断与恢复
  */
 #ifndef KERNEL_INT_H
 #define KERNEL_INT_H
@@ -25,6 +26,10 @@ extern XScuGic int_ctrl[CFG_MAX_CPU];
 #define acoral_intr_enable() HAL_INTR_ENABLE()
 ///重定义开关中断
 #define acoral_intr_disable() HAL_INTR_DISABLE()
+///重定义可嵌套关中断，返回关闭前的中断状态
+#define acoral_intr_save() HAL_INTR_SAVE()
+///重定义可嵌套恢复中断
+#define acoral_intr_restore_flags(flags) HAL_INTR_RESTORE_FLAGS(flags)
 ///重定义中断嵌套获取
 #define acoral_intr_nesting HAL_GET_INTR_NESTING()
 ///重定义增加中断嵌套
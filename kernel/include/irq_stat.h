@@ -0,0 +1,68 @@
+/**
+ * @file irq_stat.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层中断统计头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>各中断次数、服务时间、延迟直方图与各核嵌套深度统计
+ */
+#ifndef KERNEL_IRQ_STAT_H
+#define KERNEL_IRQ_STAT_H
+#include <config.h>
+#include <type.h>
+#include "xscugic.h"
+
+///统计的中断号个数
+#define ACORAL_IRQ_STAT_NUM XSCUGIC_MAX_NUM_INTR_INPUTS
+
+#ifdef CFG_IRQ_STAT
+/**
+ * @brief 中断延迟获取函数，在中断服务函数之前调用
+ *
+ * @param data 注册时的参数
+ * @return acoral_u32 中断源置位到此刻经过的时间(cycles)
+ */
+typedef acoral_u32 (*acoral_irq_latency_t)(void *data);
+
+/**
+ * @brief 一个中断的统计，时间单位为cycles
+ *
+ */
+typedef struct{
+    acoral_u32 count;///<服务次数
+    acoral_u32 min;///<最短服务时间，不含嵌套中断
+    acoral_u32 max;///<最长服务时间，不含嵌套中断
+    acoral_u64 sum;///<服务时间总和
+    acoral_u32 hist[CFG_IRQ_STAT_HIST_NUM];///<服务时间直方图，第0桶小于1us，第i桶为[2^(i-1),2^i)us，最后一桶含更长的
+    acoral_u32 lat_count;///<延迟采样次数，只有注册了延迟获取函数的中断才有
+    acoral_u32 lat_min;///<最短延迟
+    acoral_u32 lat_max;///<最长延迟
+    acoral_u64 lat_sum;///<延迟总和
+    acoral_u32 lat_hist[CFG_IRQ_STAT_HIST_NUM];///<延迟直方图，分桶同服务时间
+}acoral_irq_stat_t;
+
+/**
+ * @brief 一个cpu的中断嵌套统计
+ *
+ */
+typedef struct{
+    acoral_u32 max;///<最大嵌套深度
+    acoral_u32 depth[CFG_IRQ_STAT_NEST_MAX];///<第i项为在第i+1层进入中断服务函数的次数
+    acoral_u32 overflow;///<超过CFG_IRQ_STAT_NEST_MAX层的次数，这些中断不统计服务时间
+}acoral_irq_nest_stat_t;
+
+void acoral_irq_stat_enter(acoral_u32 irq);
+void acoral_irq_stat_exit(acoral_u32 irq);
+acoral_err acoral_irq_stat_latency_register(acoral_u32 irq, acoral_irq_latency_t latency, void *data);
+acoral_err acoral_irq_stat_get(acoral_u32 irq, acoral_irq_stat_t *stat);
+acoral_err acoral_irq_nest_get(acoral_u32 cpu, acoral_irq_nest_stat_t *stat);
+void acoral_irq_stat_reset(void);
+void acoral_irq_stat_report(void);
+#endif
+#endif
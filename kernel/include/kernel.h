@@ -11,6 +11,12 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-13 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>事件追踪头文件
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>紧凑编码帧与二进制日志头文件
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>cpu时间统计头文件
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>中断统计头文件
+ *         <tr><td>v1.5 <td>胡博文 <td>2026-10-19 <td>性能计数器统计头文件
+ *         <tr><td>v1.6 <td>胡博文 <td>2026-10-19 <td>临界区分析头文件
  */
 #ifndef KERNEL_H
 #define KERNEL_H
@@ -19,6 +25,7 @@
 #include <lsched.h>
 #include <int.h>
 #include <timer.h>
+#include <clock.h>
 #include <mem.h>
 #include <ipc.h>
 #include <policy.h>
@@ -32,6 +39,15 @@
 #include <bitops.h>
 #include <res_pool.h>
 #include <monitor.h>
+#include <stack_check.h>
+#include <soft_timer.h>
+#include <trace.h>
+#include <wire.h>
+#include <binlog.h>
+#include <usage.h>
+#include <irq_stat.h>
+#include <pmu.h>
+#include <crit_prof.h>
 
 #ifdef CFG_SMP
 #include <ipi.h>
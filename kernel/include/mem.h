@@ -11,6 +11,7 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-08 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>cache行大小与数据内存屏障
  */
 #ifndef KERNEL_MEM_H
 #define KERNEL_MEM_H
@@ -39,6 +40,11 @@
 #define acoral_vol_mem_scan() vol_mem_scan()
 #endif
 
+///重定义cache行字节数，多核共享的缓冲区按此对齐避免伪共享
+#define ACORAL_CACHE_LINE_SIZE HAL_CACHE_LINE_SIZE
+///重定义数据内存屏障
+#define acoral_dmb() HAL_DMB()
+
 void acoral_mem_sys_init(void);
 
 void buddy_scan(void);
@@ -5,6 +5,7 @@
 
 #define MONITOR_CMD_CREATE      0x01
 #define MONITOR_CMD_SWITCH      (MONITOR_CMD_CREATE << 1)
+
 //按对齐标准 不然会出问题
 //#pragma pack(8)
 
@@ -26,21 +27,13 @@ typedef struct {
     acoral_u32  cpu;
     acoral_u32  create_tick;
     acoral_char thread_name[32];
-
+#ifdef CFG_TRACE_WIRE_COMPACT
+    acoral_u32  task_id;    // 紧凑编码中代替tcb指针的线程号，每次创建分配新号
+#endif
 } thread_info;
 
 
 //#pragma pack()
-typedef struct {
-    acoral_u32 cpu;
-    acoral_u32 tick;
-    acoral_thread_t *from_tcb;
-    acoral_thread_t *to_tcb;
-//    acoral_char from_name[32];
-//    acoral_char to_name[32];
-} thread_switch_info; // 每个40 Byte
-
-
 typedef struct {
     acoral_u32 total_size;
     acoral_u32 st_idx;
@@ -52,23 +45,15 @@ typedef struct {
     thread_info threads[CFG_MAX_THREAD];  // 这个每次发送的数组长度都是该结构体的size字段
 } thread_info_set;       // 占用3kb以上大小
 
-
-typedef struct {
-    acoral_u32 total_size;
-    acoral_u32 threshold; //取一半
-    acoral_u32 st_idx;
-    acoral_u32 ed_idx;
-    acoral_u32 info_type;
-    acoral_u32 size;
-    acoral_u32 item_bsize;
-    acoral_u32 overflow;
-    thread_switch_info switch_infos[CFG_MAX_THREAD];   // 这个每次发送的数组长度都是该结构体的size字段
-} thread_switch_info_set; //占用7kb以上大小
+// 线程切换等事件由每cpu追踪缓冲区记录，见trace.h，原始帧类型3的负载为acoral_trace_rec_t
 
 void acoral_monitor_init(void);
 
 void acoral_tinfos_add(acoral_thread_t* thread);
-void acoral_tswinfos_add(acoral_thread_t* from, acoral_thread_t* to);
+
+#ifdef CFG_TRACE_WIRE_COMPACT
+acoral_u32 acoral_monitor_task_id_new(void);
+#endif
 
 void acoral_infos_send();
 #endif
@@ -11,6 +11,7 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-13 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>周期统计与截止期错失处理
  */
 #ifndef KERNEL_PERIOD_THRD_H
 #define KERNEL_PERIOD_THRD_H
@@ -25,4 +26,32 @@ typedef struct{
     acoral_time time;///<周期时间
 }acoral_period_policy_data_t;
 
+///截止期错失处理：丢弃本次释放，未完成的实例继续运行（默认）
+#define ACORAL_PERIOD_MISS_SKIP 0
+///截止期错失处理：中止未完成的实例，阻塞中的实例立即重新释放，运行中的实例在下个周期重新释放
+#define ACORAL_PERIOD_MISS_ABORT (1<<0)
+///截止期错失处理：就绪监督线程，可与以上方式组合
+#define ACORAL_PERIOD_MISS_NOTIFY (1<<1)
+
+/**
+ * @brief 周期线程统计结构体，时间单位均为ns
+ *
+ */
+typedef struct{
+    acoral_u32 releases;///<释放次数
+    acoral_u32 completions;///<完成次数
+    acoral_u32 misses;///<截止期（等于周期）错失的实例数
+    acoral_u32 overruns;///<释放时上一实例仍未完成的次数
+    acoral_u32 aborts;///<被中止的实例数
+    acoral_u64 response_max;///<最大响应时间
+    acoral_u64 response_avg;///<平均响应时间
+    acoral_u64 response_total;///<响应时间总和
+    acoral_u64 jitter_max;///<最大释放抖动，即实例开始执行时刻相对名义释放时刻的最大偏差
+}acoral_period_stat_t;
+
+acoral_err acoral_period_stat_get(acoral_id thread_id, acoral_period_stat_t *stat);
+acoral_err acoral_period_stat_reset(acoral_id thread_id);
+acoral_err acoral_period_set_miss_handler(acoral_id thread_id, acoral_u8 mode, acoral_id supervisor_id);
+void acoral_period_stat_report(void);
+
 #endif
@@ -0,0 +1,48 @@
+/**
+ * @file pmu.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层性能计数器统计头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>线程切换时累计PMU计数，溢出中断采样
+ */
+#ifndef KERNEL_PMU_H
+#define KERNEL_PMU_H
+#include <config.h>
+#include <type.h>
+#include <thread.h>
+
+#ifdef CFG_PMU
+#if CFG_PMU_EVENT_NUM > 6
+#error "CFG_PMU_EVENT_NUM must not exceed 6"
+#endif
+#if CFG_PMU_SAMPLE_COUNTER > CFG_PMU_EVENT_NUM
+#error "CFG_PMU_SAMPLE_COUNTER must not exceed CFG_PMU_EVENT_NUM"
+#endif
+
+///计数项个数，第0项为cycle
+#define ACORAL_PMU_COUNT_NUM (CFG_PMU_EVENT_NUM+1)
+
+/**
+ * @brief 一个线程的性能计数
+ *
+ */
+typedef struct{
+    acoral_u64 count[ACORAL_PMU_COUNT_NUM];///<累计计数，第0项为cycle，第i项为第i个事件，只统计cycle时事件项为0
+    acoral_u32 samples;///<采样次数
+}acoral_pmu_count_t;
+
+void acoral_pmu_cpu_init(void);
+void acoral_pmu_switch(acoral_thread_t *prev);
+acoral_u32 acoral_pmu_event_num(acoral_u32 cpu);
+acoral_u32 acoral_pmu_event(acoral_u32 idx);
+acoral_err acoral_pmu_thread_get(acoral_thread_t *thread, acoral_pmu_count_t *count);
+void acoral_pmu_report(void);
+#endif
+#endif
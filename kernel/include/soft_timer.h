@@ -0,0 +1,63 @@
+/**
+ * @file soft_timer.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层软件定时器相关头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>基于时间轮的软件定时器
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>增加空闲状态，防止重复删除
+ */
+#ifndef KERNEL_SOFT_TIMER_H
+#define KERNEL_SOFT_TIMER_H
+#include <config.h>
+#include <type.h>
+#include <list.h>
+
+///软件定时器标志：周期定时器，否则为单次定时器
+#define ACORAL_SOFT_TIMER_PERIODIC (1<<0)
+///软件定时器标志：回调在tick中断中执行，否则在所在cpu的定时器线程中执行
+#define ACORAL_SOFT_TIMER_IN_TICK (1<<1)
+
+///软件定时器状态：未启动
+#define ACORAL_SOFT_TIMER_STATE_IDLE 0
+///软件定时器状态：运行中
+#define ACORAL_SOFT_TIMER_STATE_ACTIVE 1
+///软件定时器状态：在定时器池空闲链表中
+#define ACORAL_SOFT_TIMER_STATE_FREE 2
+
+///软件定时器回调函数
+typedef void (*acoral_soft_timer_cb_t)(void *arg);
+
+/**
+ * @brief 软件定时器结构体
+ *
+ */
+typedef struct{
+    acoral_list_t list;///<时间轮槽链表节点，空闲时挂在空闲链表上
+    acoral_list_t pending;///<等待定时器线程执行的链表节点
+    acoral_time time;///<定时时间(ticks)
+    acoral_u32 rounds;///<到期前时间轮还需转过的圈数
+    acoral_soft_timer_cb_t callback;///<回调函数
+    void *arg;///<回调参数
+    acoral_u8 flag;///<定时器标志
+    acoral_u8 state;///<定时器状态
+    acoral_u8 cpu;///<回调执行所在cpu（定时器线程模式）
+    acoral_u32 overrun;///<回调未执行完又到期的次数
+}acoral_soft_timer_t;
+
+void acoral_soft_timer_sys_init(void);
+void acoral_soft_timer_thread_create(void);
+void acoral_soft_timer_deal(void);
+acoral_err acoral_soft_timer_init(acoral_soft_timer_t *timer, acoral_soft_timer_cb_t callback, void *arg, acoral_time time, acoral_u8 flag, acoral_u8 cpu);
+acoral_soft_timer_t *acoral_soft_timer_create(acoral_soft_timer_cb_t callback, void *arg, acoral_time time, acoral_u8 flag, acoral_u8 cpu);
+acoral_err acoral_soft_timer_delete(acoral_soft_timer_t *timer);
+acoral_err acoral_soft_timer_start(acoral_soft_timer_t *timer);
+acoral_err acoral_soft_timer_stop(acoral_soft_timer_t *timer);
+acoral_err acoral_soft_timer_reset(acoral_soft_timer_t *timer, acoral_time time);
+#endif
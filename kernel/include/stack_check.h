@@ -0,0 +1,44 @@
+/**
+ * @file stack_check.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层线程栈使用检测相关头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>栈涂色、高水位统计与推荐栈大小
+ */
+#ifndef KERNEL_STACK_CHECK_H
+#define KERNEL_STACK_CHECK_H
+#include <config.h>
+#include <type.h>
+#include <thread.h>
+
+///栈涂色值，未被使用过的栈空间保持该值
+#define ACORAL_STACK_MAGIC 0xa5a5a5a5
+///栈底保护区涂色值
+#define ACORAL_STACK_GUARD_MAGIC 0xdeadbeef
+#ifdef CFG_STACK_CHECK_GUARD
+///栈底保护区大小（字节）
+#define ACORAL_STACK_GUARD_SIZE 16
+#else
+///栈底保护区大小（字节）
+#define ACORAL_STACK_GUARD_SIZE 0
+#endif
+
+void acoral_stack_paint(acoral_thread_t *thread);
+acoral_u32 acoral_thread_stack_hwm(acoral_thread_t *thread);
+acoral_u32 acoral_thread_stack_hwm_by_id(acoral_id thread_id);
+acoral_u32 acoral_stack_recommend_size(acoral_u32 hwm);
+void acoral_stack_check_scan(void);
+void acoral_stack_check_idle(void);
+void acoral_stack_report(void);
+#ifdef CFG_STACK_CHECK_GUARD
+void acoral_stack_guard_check(acoral_thread_t *thread);
+void acoral_stack_overflow_hook(acoral_thread_t *thread);
+#endif
+#endif
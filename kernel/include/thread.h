@@ -12,6 +12,13 @@
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-14 <td>增加注释
  *         <tr><td>v1.1 <td>胡博文 <td>2022-09-26 <td>错误头文件相关改动
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>增加栈高水位字段
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>增加线程回收缓存
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>增加cpu时间统计字段
+ *         <tr><td>v1.5 <td>胡博文 <td>2026-10-19 <td>增加性能计数器统计字段
+ *         <tr><td>v1.6 <td>胡博文 <td>2026-10-19 <td>增加追踪线程号字段
+ *         <tr><td>v1.7 <td>胡博文 <td>2026-10-19 <td>导出全部线程队列删除计数
+ *         <tr><td>v1.8 <td>胡博文 <td>2026-10-19 <td>统计报告线程名字拷贝长度
  */
 #ifndef KERNEL_THREAD_H
 #define KERNEL_THREAD_H
@@ -28,6 +35,10 @@
 #define ACORAL_MAX_THREAD CFG_MAX_THREAD
 ///最小线程栈大小
 #define ACORAL_MIN_STACK_SIZE CFG_MIN_STACK_SIZE 
+#ifdef CFG_THREAD_RECYCLE
+///回收缓存最小栈等级大小，与伙伴系统最小块一致
+#define ACORAL_RECYCLE_BASE_SIZE 128
+#endif
 ///最低优先级
 #define ACORAL_MINI_PRIO  ACORAL_MAX_PRIO_NUM-1
 ///最高优先级
@@ -41,6 +52,8 @@
 #define ACORAL_DAEMON_PRIO ACORAL_MINI_PRIO-2
 ///时间确定性线程优先级
 #define ACORAL_TIMED_PRIO ACORAL_MAX_PRIO
+///统计报告中线程名字拷贝的长度（含结尾0），与报告名字列宽一致
+#define ACORAL_REPORT_NAME_LEN 20
 
 ///线程状态类型：基底
 #define ACORAL_THREAD_STATE_BASE  0
@@ -109,6 +122,26 @@ typedef struct{
     acoral_thread_hook_t hook;///<策略钩子函数
     void *private_data;///<私有数据
     void *data;///<其他数据
+#ifdef CFG_STACK_CHECK
+    acoral_u32 stack_hwm;///<栈使用高水位（字节）
+    acoral_u8 stack_scan_seq;///<栈扫描轮次标记
+#endif
+#ifdef CFG_THREAD_RECYCLE
+    acoral_u8 stack_alloc;///<栈由内核分配标志，只有这样的栈可以进入回收缓存
+#endif
+#ifdef CFG_CPU_USAGE
+    acoral_u64 run_cycles;///<累计运行时间(cycles)，不含中断，只由运行它的cpu更新
+    acoral_u64 run_mark;///<最近一次结算时的累计运行时间
+    acoral_u64 run_window;///<最近两次结算之间的运行时间(cycles)
+    acoral_u8 usage_kernel;///<内核服务线程标志，运行时间计入内核时间
+#endif
+#ifdef CFG_PMU
+    acoral_u64 pmu_count[CFG_PMU_EVENT_NUM+1];///<累计性能计数，第0项为cycle，第i项为第i个事件，只由运行它的cpu更新
+    acoral_u32 pmu_samples;///<采样计数器溢出时正在运行的次数
+#endif
+#ifdef CFG_TRACE_WIRE_COMPACT
+    acoral_u32 task_id;///<追踪线程号，每次创建分配新号，追踪记录中代替tcb指针
+#endif
 }acoral_thread_t;
 
 /**
@@ -122,6 +155,7 @@ typedef struct acoral_thread_prio_array{
 }acoral_thread_prio_array_t;
 
 extern acoral_queue_t acoral_threads_queue;
+extern acoral_u32 acoral_threads_queue_del_num;
 
 ///创建线程函数
 #define acoral_create_thread(route,stack_size,args,name,stack,policy,policy_data,data,hook) create_thread_by_policy(route,stack_size,args,name,stack,policy,policy_data,data,hook);
@@ -164,6 +198,11 @@ void acoral_set_thread_console(acoral_id id);
 acoral_thread_t *acoral_alloc_thread();
 acoral_err acoral_thread_init(acoral_thread_t *thread,void (*route)(void *args),void (*exit)(void),void *args);
 void acoral_thread_exit(void);
+#ifdef CFG_THREAD_RECYCLE
+acoral_thread_t *acoral_thread_recycle_get(acoral_u32 stack_size);
+acoral_bool acoral_thread_recycle_put(acoral_thread_t *thread);
+acoral_err acoral_thread_recycle_prewarm(acoral_u32 stack_size, acoral_u32 num);
+#endif
 void acoral_thread_sys_init(void);
 #endif
 
@@ -11,6 +11,7 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-12 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>增加回绕安全的ticks比较
  */
 #ifndef KERNEL_TIMER_H
 #define KERNEL_TIMER_H
@@ -22,6 +23,12 @@
 #define acoral_ticks acoral_get_ticks()
 ///计算time(ms)对应的ticks数量
 #define TIME_TO_TICKS(time) (time)*CFG_TICKS_PER_SEC/1000
+///ticks比较：a是否晚于b，对ticks回绕安全
+#define ACORAL_TICKS_AFTER(a,b) ((acoral_32)((acoral_time)(b)-(acoral_time)(a))<0)
+///ticks比较：a是否早于b，对ticks回绕安全
+#define ACORAL_TICKS_BEFORE(a,b) ACORAL_TICKS_AFTER(b,a)
+///ticks比较：a是否不早于b，对ticks回绕安全
+#define ACORAL_TICKS_AFTER_EQ(a,b) ((acoral_32)((acoral_time)(a)-(acoral_time)(b))>=0)
 
 void acoral_ticks_init(void);
 acoral_time acoral_get_ticks(void);
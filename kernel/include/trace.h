@@ -0,0 +1,111 @@
+/**
+ * @file trace.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层事件追踪头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>每cpu无锁追踪环形缓冲区
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>紧凑编码时线程参数记录为线程号
+ */
+#ifndef KERNEL_TRACE_H
+#define KERNEL_TRACE_H
+#include <config.h>
+#include <type.h>
+#include <mem.h>
+
+///追踪事件类型的高4位为类别，类别掩码第n位对应类别n
+#define ACORAL_TRACE_CLASS(type) (1u<<((type)>>4))
+
+///追踪类别：调度
+#define ACORAL_TRACE_CLASS_SCHED ACORAL_TRACE_CLASS(0x00)
+///追踪类别：中断
+#define ACORAL_TRACE_CLASS_IRQ ACORAL_TRACE_CLASS(0x10)
+///追踪类别：核间中断
+#define ACORAL_TRACE_CLASS_IPI ACORAL_TRACE_CLASS(0x20)
+///追踪类别：线程通信
+#define ACORAL_TRACE_CLASS_IPC ACORAL_TRACE_CLASS(0x30)
+
+///追踪事件：线程切换，arg0换出线程，arg1换入线程，arg2换出线程状态。线程参数见ACORAL_TRACE_THREAD
+#define ACORAL_TRACE_SWITCH 0x00
+///追踪事件：线程就绪，arg0线程，arg1优先级
+#define ACORAL_TRACE_WAKE 0x01
+///追踪事件：线程创建，arg0线程，arg1优先级，arg2所在cpu
+#define ACORAL_TRACE_CREATE 0x02
+///追踪事件：进入中断服务函数，arg0中断号
+#define ACORAL_TRACE_IRQ_ENTER 0x10
+///追踪事件：退出中断服务函数，arg0中断号
+#define ACORAL_TRACE_IRQ_EXIT 0x11
+///追踪事件：发送核间命令，arg0目标cpu，arg1命令，arg2线程id
+#define ACORAL_TRACE_IPI_SEND 0x20
+///追踪事件：处理核间命令，arg0命令，arg1线程id
+#define ACORAL_TRACE_IPI_RECV 0x21
+///追踪事件：线程阻塞在ipc上，arg0线程，arg1 ipc
+#define ACORAL_TRACE_IPC_BLOCK 0x30
+///追踪事件：线程离开ipc等待队列，arg0线程，arg1 ipc
+#define ACORAL_TRACE_IPC_UNBLOCK 0x31
+
+#ifdef CFG_TRACE
+///缓冲区满时覆盖最旧的记录
+#define ACORAL_TRACE_MODE_OVERWRITE 0
+///缓冲区满时停止记录，丢弃新记录
+#define ACORAL_TRACE_MODE_STOP 1
+
+/**
+ * @brief 追踪记录结构体
+ *
+ */
+typedef struct{
+    acoral_u64 ts;///<时间戳(cycles)，各cpu共用全局定时器
+    acoral_u16 type;///<事件类型
+    acoral_u16 cpu;///<产生事件的cpu
+    acoral_u32 arg0;///<事件参数0
+    acoral_u32 arg1;///<事件参数1
+    acoral_u32 arg2;///<事件参数2
+}acoral_trace_rec_t;
+
+/**
+ * @brief 每cpu追踪环形缓冲区，只由所在cpu写入，写入时只关本cpu中断而不加锁
+ *
+ */
+typedef struct{
+    acoral_trace_rec_t rec[CFG_TRACE_RING_SIZE];///<记录
+    volatile acoral_u32 head;///<已发布的记录总数，只由所在cpu增加
+    volatile acoral_u32 tail;///<已读取的记录总数，只由读取者增加
+    volatile acoral_u32 dropped;///<停止模式下因满被丢弃的记录数，只由所在cpu增加
+    volatile acoral_u32 overwritten;///<覆盖模式下未读取就被覆盖的记录数，只由读取者增加
+}__attribute__((aligned(ACORAL_CACHE_LINE_SIZE))) acoral_trace_ring_t;
+
+extern volatile acoral_u32 acoral_trace_mask;
+
+void acoral_trace_record(acoral_u16 type, acoral_u32 arg0, acoral_u32 arg1, acoral_u32 arg2);
+void acoral_trace_set_mask(acoral_u32 mask);
+acoral_u32 acoral_trace_get_mask(void);
+void acoral_trace_set_mode(acoral_u8 mode);
+void acoral_trace_reset(void);
+acoral_u32 acoral_trace_snapshot(acoral_u32 cpu, acoral_trace_rec_t *buf, acoral_u32 num, acoral_u32 *lost);
+acoral_u32 acoral_trace_read(acoral_u32 cpu, acoral_trace_rec_t *buf, acoral_u32 num, acoral_u32 *lost);
+
+#ifdef CFG_TRACE_WIRE_COMPACT
+///追踪参数中的线程：记录时就换成创建时分配的线程号，发送前tcb被回收再创建也不会对应到新线程
+#define ACORAL_TRACE_THREAD(thread) ((thread)->task_id)
+#else
+///追踪参数中的线程：记录tcb指针
+#define ACORAL_TRACE_THREAD(thread) (thread)
+#endif
+
+///记录一个追踪事件，所属类别未开启时只有一次掩码判断
+#define ACORAL_TRACE(type,arg0,arg1,arg2) \
+    do{ \
+        if(acoral_trace_mask&ACORAL_TRACE_CLASS(type)) \
+            acoral_trace_record((type),(acoral_u32)(arg0),(acoral_u32)(arg1),(acoral_u32)(arg2)); \
+    }while(0)
+#else
+#define ACORAL_TRACE(type,arg0,arg1,arg2) do{}while(0)
+#endif
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file usage.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层cpu时间统计头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>线程运行时间与各核空闲/中断/内核时间统计
+ */
+#ifndef KERNEL_USAGE_H
+#define KERNEL_USAGE_H
+#include <config.h>
+#include <type.h>
+#include <thread.h>
+
+#ifdef CFG_CPU_USAGE
+/**
+ * @brief 一个cpu的时间分类(cycles)
+ *
+ */
+typedef struct{
+    acoral_u64 thread;///<普通线程运行时间
+    acoral_u64 kernel;///<内核服务线程运行时间
+    acoral_u64 irq;///<中断服务时间，含嵌套中断
+    acoral_u64 idle;///<空闲线程运行时间
+}acoral_usage_time_t;
+
+/**
+ * @brief cpu时间统计
+ *
+ */
+typedef struct{
+    acoral_usage_time_t total;///<开始统计以来的累计时间，含查询时刻正在进行的部分
+    acoral_usage_time_t window;///<上一个完整统计窗口内的时间
+    acoral_u64 window_len;///<上一个统计窗口的长度(cycles)，0表示还没有完整窗口
+}acoral_usage_cpu_t;
+
+void acoral_usage_switch(acoral_thread_t *prev);
+void acoral_usage_irq_enter(void);
+void acoral_usage_irq_exit(void);
+void acoral_usage_tick(void);
+void acoral_usage_set_kernel_by_id(acoral_id thread_id);
+acoral_u64 acoral_usage_thread_cycles(acoral_thread_t *thread);
+acoral_u32 acoral_usage_thread_load(acoral_thread_t *thread);
+acoral_err acoral_usage_cpu_get(acoral_u32 cpu, acoral_usage_cpu_t *stat);
+acoral_u32 acoral_usage_cpu_load(acoral_u32 cpu);
+void acoral_usage_report(void);
+#endif
+#endif
@@ -0,0 +1,43 @@
+/**
+ * @file wire.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层串口紧凑编码帧头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>从monitor中拆出，供追踪与二进制日志共用
+ */
+#ifndef KERNEL_WIRE_H
+#define KERNEL_WIRE_H
+#include <config.h>
+#include <type.h>
+
+/*
+ * 紧凑编码帧：0xA5 0x5A | 类型u8 | 序号u8 | 负载长度u16 | 负载 | CRC16-CCITT u16
+ * 多字节均为小端，CRC覆盖类型到负载末尾，序号每帧加1，接收端据此发现丢帧
+ * 负载为protobuf编码，字段见components/acosim/src/acosim.proto
+ */
+///帧头第1字节
+#define ACORAL_WIRE_MAGIC0 0xA5
+///帧头第2字节
+#define ACORAL_WIRE_MAGIC1 0x5A
+///帧类型：AcoSimCore
+#define ACORAL_WIRE_CORE 1
+///帧类型：AcoSimTask
+#define ACORAL_WIRE_TASK 2
+///帧类型：AcoSimTraceBatch
+#define ACORAL_WIRE_EVENTS 3
+///帧类型：AcoSimLogBatch
+#define ACORAL_WIRE_LOG 4
+///负载最大字节数
+#define ACORAL_WIRE_PAYLOAD_MAX 256
+
+#ifdef CFG_WIRE
+void acoral_wire_send(acoral_u8 type, const acoral_u8 *payload, acoral_u32 len);
+#endif
+#endif
@@ -0,0 +1,243 @@
+/**
+ * @file binlog.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层二进制日志源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>每cpu无锁二进制日志，格式化在主机端完成
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>发送线程计入内核时间
+ */
+#include <acoral.h>
+#include "pb_encode.h"
+
+#ifdef CFG_BINLOG
+#if (CFG_BINLOG_RING_WORDS&(CFG_BINLOG_RING_WORDS-1))
+#error "CFG_BINLOG_RING_WORDS must be power of 2"
+#endif
+
+///发送线程每次读取的字数，至少容纳一条最长的记录
+#define BINLOG_READ_WORDS 128
+///批量帧中records以外字段的最大字节数
+#define BINLOG_BATCH_HEAD 26
+///批量帧中records的最大字节数
+#define BINLOG_RECORDS_MAX (ACORAL_WIRE_PAYLOAD_MAX-BINLOG_BATCH_HEAD)
+///单条记录编码后的最大字节数：格式串号、时间差、参数个数、参数
+#define BINLOG_REC_MAX (5+10+1+5*CFG_BINLOG_MAX_ARGS)
+
+///各cpu日志环形缓冲区
+static acoral_binlog_ring_t binlog_ring[CFG_MAX_CPU];
+#ifdef CFG_SMP
+///读取者自旋锁，多个读取者互斥推进tail，写入者不使用
+static acoral_spinlock_t binlog_read_lock;
+#endif
+///发送线程的读取缓冲区
+static acoral_u32 binlog_buf[BINLOG_READ_WORDS];
+///发送线程的编码缓冲区
+static acoral_u8 binlog_records[BINLOG_RECORDS_MAX];
+///批量帧负载
+static acoral_u8 binlog_payload[ACORAL_WIRE_PAYLOAD_MAX];
+///各cpu上次发送时的丢失数
+static acoral_u32 binlog_lost[CFG_MAX_CPU];
+
+/**
+ * @brief 在本cpu的日志缓冲区中记录一条日志，可在中断和调度器中调用，通常经ACORAL_LOG调用
+ *
+ * @param fmt 格式串地址，即格式串号
+ * @param num 参数个数，超过CFG_BINLOG_MAX_ARGS的部分丢弃
+ * @param args 参数
+ */
+void acoral_binlog_record(acoral_u32 fmt, acoral_u32 num, const acoral_u32 *args)
+{
+    acoral_u32 cpu,flags,head,len,i;
+    acoral_u64 ts;
+    acoral_binlog_ring_t *ring;
+    if(num>CFG_BINLOG_MAX_ARGS)
+        num=CFG_BINLOG_MAX_ARGS;
+    len=ACORAL_BINLOG_HEAD_WORDS+num;
+    flags=acoral_intr_save();//只有本cpu写入，屏蔽本cpu的嵌套中断即可，不需要锁
+    cpu=acoral_current_cpu;
+    ring=&binlog_ring[cpu];
+    head=ring->head;
+    if(CFG_BINLOG_RING_WORDS-(head-ring->tail)<len)
+    {
+        ring->dropped++;
+        acoral_intr_restore_flags(flags);
+        return;
+    }
+    ts=acoral_clock_cycles();
+    ring->word[head&(CFG_BINLOG_RING_WORDS-1)]=(num<<ACORAL_BINLOG_NARGS_SHIFT)|(fmt&ACORAL_BINLOG_FMT_MASK);
+    ring->word[(head+1)&(CFG_BINLOG_RING_WORDS-1)]=(acoral_u32)ts;
+    ring->word[(head+2)&(CFG_BINLOG_RING_WORDS-1)]=(acoral_u32)(ts>>32);
+    for(i=0;i<num;i++)
+        ring->word[(head+ACORAL_BINLOG_HEAD_WORDS+i)&(CFG_BINLOG_RING_WORDS-1)]=args[i];
+    acoral_dmb();//记录内容先于head对读取者可见
+    ring->head=head+len;
+    acoral_intr_restore_flags(flags);
+}
+
+/**
+ * @brief 读取某cpu未读取的日志并推进读取位置，只复制完整的记录
+ *
+ * @param cpu cpu号
+ * @param buf 输出缓冲区
+ * @param words 输出缓冲区可容纳的字数
+ * @param lost 返回至今因满丢弃的记录数，可为NULL
+ * @return acoral_u32 读取的字数
+ */
+acoral_u32 acoral_binlog_read(acoral_u32 cpu, acoral_u32 *buf, acoral_u32 words, acoral_u32 *lost)
+{
+    acoral_binlog_ring_t *ring;
+    acoral_u32 head,tail,len,cnt,i;
+    if(cpu>=CFG_MAX_CPU||buf==NULL)
+        return 0;
+    ring=&binlog_ring[cpu];
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&binlog_read_lock);
+#endif
+    head=ring->head;
+    acoral_dmb();
+    tail=ring->tail;
+    cnt=0;
+    while(tail!=head)
+    {
+        len=ACORAL_BINLOG_HEAD_WORDS+(ring->word[tail&(CFG_BINLOG_RING_WORDS-1)]>>ACORAL_BINLOG_NARGS_SHIFT);
+        if(cnt+len>words)
+            break;
+        for(i=0;i<len;i++)
+            buf[cnt+i]=ring->word[(tail+i)&(CFG_BINLOG_RING_WORDS-1)];
+        cnt+=len;
+        tail+=len;
+    }
+    acoral_dmb();//复制完成后才释放空间给写入者
+    ring->tail=tail;
+    if(lost!=NULL)
+        *lost=ring->dropped;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&binlog_read_lock);
+#endif
+    acoral_exit_critical();
+    return cnt;
+}
+
+/**
+ * @brief 编码一条记录：格式串号、与上一记录的时间差、参数个数、参数，均为变长整数
+ *
+ * @param buf 输出，至少BINLOG_REC_MAX字节
+ * @param rec 记录
+ * @param prev 上一记录的时间戳
+ * @return acoral_u32 编码字节数
+ */
+static acoral_u32 binlog_rec_encode(acoral_u8 *buf, const acoral_u32 *rec, acoral_u64 prev)
+{
+    pb_ostream_t stream=pb_ostream_from_buffer(buf,BINLOG_REC_MAX);
+    acoral_u32 num=rec[0]>>ACORAL_BINLOG_NARGS_SHIFT,i;
+    acoral_u64 ts=((acoral_u64)rec[2]<<32)|rec[1];
+    pb_encode_varint(&stream,rec[0]&ACORAL_BINLOG_FMT_MASK);
+    pb_encode_varint(&stream,ts-prev);
+    pb_encode_varint(&stream,num);
+    for(i=0;i<num;i++)
+        pb_encode_varint(&stream,rec[ACORAL_BINLOG_HEAD_WORDS+i]);
+    return stream.bytes_written;
+}
+
+/**
+ * @brief 发送一个日志批量帧(AcoSimLogBatch)
+ *
+ * @param cpu cpu号
+ * @param base 第一条记录的时间戳
+ * @param lost 该cpu至今丢弃的记录数
+ * @param len binlog_records中记录的字节数
+ */
+static void binlog_batch_send(acoral_u32 cpu, acoral_u64 base, acoral_u32 lost, acoral_u32 len)
+{
+    pb_ostream_t stream=pb_ostream_from_buffer(binlog_payload,ACORAL_WIRE_PAYLOAD_MAX);
+    pb_encode_tag(&stream,PB_WT_VARINT,1);
+    pb_encode_varint(&stream,cpu);
+    pb_encode_tag(&stream,PB_WT_VARINT,2);
+    pb_encode_varint(&stream,base);
+    pb_encode_tag(&stream,PB_WT_VARINT,3);
+    pb_encode_varint(&stream,lost);
+    pb_encode_tag(&stream,PB_WT_STRING,4);
+    pb_encode_string(&stream,binlog_records,len);
+    acoral_wire_send(ACORAL_WIRE_LOG,binlog_payload,stream.bytes_written);
+}
+
+/**
+ * @brief 读出一个cpu的全部日志，按帧长上限分批发送，每批第一条记录的时间差为0
+ *
+ * @param cpu cpu号
+ */
+static void binlog_cpu_send(acoral_u32 cpu)
+{
+    acoral_u8 rec[BINLOG_REC_MAX];
+    acoral_u32 words,pos,n,len=0,lost=0,total=0;
+    acoral_u64 base=0,prev=0,ts;
+    //每周期最多读一个缓冲区的量，写入者一直写时也不会占住发送线程
+    while(total<CFG_BINLOG_RING_WORDS&&(words=acoral_binlog_read(cpu,binlog_buf,BINLOG_READ_WORDS,&lost))>0)
+    {
+        total+=words;
+        for(pos=0;pos<words;pos+=ACORAL_BINLOG_HEAD_WORDS+(binlog_buf[pos]>>ACORAL_BINLOG_NARGS_SHIFT))
+        {
+            ts=((acoral_u64)binlog_buf[pos+2]<<32)|binlog_buf[pos+1];
+            if(len==0)
+                base=prev=ts;
+            n=binlog_rec_encode(rec,&binlog_buf[pos],prev);
+            if(len+n>BINLOG_RECORDS_MAX)
+            {
+                binlog_batch_send(cpu,base,lost,len);
+                len=0;
+                base=prev=ts;
+                n=binlog_rec_encode(rec,&binlog_buf[pos],prev);
+            }
+            acoral_memcpy(&binlog_records[len],rec,n);
+            len+=n;
+            prev=ts;
+        }
+    }
+    if(len>0||lost!=binlog_lost[cpu])//没有新记录但丢弃数变化时也发送，让接收端知道丢失
+        binlog_batch_send(cpu,base,lost,len);
+    binlog_lost[cpu]=lost;
+}
+
+/**
+ * @brief 日志发送线程，周期地把各cpu的日志编码后发往串口
+ *
+ * @param args 未使用
+ */
+static void binlog_thread(void *args)
+{
+    acoral_u32 cpu;
+    for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+        binlog_cpu_send(cpu);
+}
+
+/**
+ * @brief 二进制日志初始化，创建低优先级的周期发送线程
+ *
+ */
+void acoral_binlog_init(void)
+{
+    acoral_period_policy_data_t p_data;
+    acoral_id id;
+#ifdef CFG_SMP
+    acoral_spin_init(&binlog_read_lock);
+#endif
+    p_data.cpu=0;
+    p_data.prio=CFG_BINLOG_PRIO;
+    p_data.time=CFG_BINLOG_PERIOD;
+    id=acoral_create_thread(binlog_thread,CFG_BINLOG_STACK_SIZE,NULL,"binlog",NULL,ACORAL_SCHED_POLICY_PERIOD,&p_data,NULL,NULL);
+    if(id<0)
+        acoral_printerr("Create binlog thread fail\n");
+#ifdef CFG_CPU_USAGE
+    else
+        acoral_usage_set_kernel_by_id(id);
+#endif
+}
+#endif
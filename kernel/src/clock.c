@@ -0,0 +1,177 @@
+/**
+ * @file clock.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层64位单调高精度时钟相关源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>基于全局定时器的单调时钟
+ */
+#include <config.h>
+#include <type.h>
+#include <hal.h>
+#include <clock.h>
+
+///周期数到纳秒的换算因子
+static acoral_clock_conv_t cyc2ns;
+///周期数到微秒的换算因子
+static acoral_clock_conv_t cyc2us;
+///周期数到毫秒的换算因子
+static acoral_clock_conv_t cyc2ms;
+///纳秒到周期数的换算因子
+static acoral_clock_conv_t ns2cyc;
+///微秒到周期数的换算因子
+static acoral_clock_conv_t us2cyc;
+
+/**
+ * @brief 计算from到to频率换算的定点因子，选取乘数不溢出32位时最大的移位以保证精度
+ *
+ * @param conv 换算因子
+ * @param from 源频率
+ * @param to 目标频率
+ */
+static void clock_calc_conv(acoral_clock_conv_t *conv, acoral_u32 from, acoral_u32 to)
+{
+    acoral_u64 mult=0;
+    acoral_u32 shift;
+    for(shift=63;shift>0;shift--)
+    {
+        if((acoral_u64)to>>(64-shift))//to左移后会溢出64位
+            continue;
+        mult=(((acoral_u64)to<<shift)+(from>>1))/from;
+        if((mult>>32)==0)
+            break;
+    }
+    conv->mult=(acoral_u32)mult;
+    conv->shift=shift;
+}
+
+/**
+ * @brief 定点换算，64位乘32位得到96位中间结果后右移，不会溢出
+ *
+ * @param value 被换算值
+ * @param conv 换算因子
+ * @return acoral_u64 换算结果
+ */
+static acoral_u64 clock_conv(acoral_u64 value, acoral_clock_conv_t *conv)
+{
+    acoral_u64 low=(acoral_u64)(acoral_u32)value*conv->mult;
+    acoral_u64 high=(value>>32)*conv->mult;
+    if(conv->shift>=32)
+        return (high+(low>>32))>>(conv->shift-32);
+    return (high<<(32-conv->shift))+(low>>conv->shift);
+}
+
+/**
+ * @brief 单调时钟初始化，在主核启动时调用一次
+ *
+ */
+void acoral_clock_init(void)
+{
+    HAL_CLOCK_INIT();
+    clock_calc_conv(&cyc2ns,ACORAL_CLOCK_HZ,1000000000);
+    clock_calc_conv(&cyc2us,ACORAL_CLOCK_HZ,1000000);
+    clock_calc_conv(&cyc2ms,ACORAL_CLOCK_HZ,1000);
+    clock_calc_conv(&ns2cyc,1000000000,ACORAL_CLOCK_HZ);
+    clock_calc_conv(&us2cyc,1000000,ACORAL_CLOCK_HZ);
+}
+
+/**
+ * @brief 获取时钟源计数值，两个核读到的是同一个计数器
+ *
+ * @return acoral_u64 周期数
+ */
+acoral_u64 acoral_clock_cycles(void)
+{
+    return HAL_CLOCK_READ();
+}
+
+/**
+ * @brief 获取单调时钟纳秒数
+ *
+ * @return acoral_u64 纳秒
+ */
+acoral_u64 acoral_clock_ns(void)
+{
+    return clock_conv(HAL_CLOCK_READ(),&cyc2ns);
+}
+
+/**
+ * @brief 获取单调时钟微秒数
+ *
+ * @return acoral_u64 微秒
+ */
+acoral_u64 acoral_clock_us(void)
+{
+    return clock_conv(HAL_CLOCK_READ(),&cyc2us);
+}
+
+/**
+ * @brief 获取单调时钟毫秒数，不会像32位ticks一样在49天后回绕
+ *
+ * @return acoral_u64 毫秒
+ */
+acoral_u64 acoral_clock_ms(void)
+{
+    return clock_conv(HAL_CLOCK_READ(),&cyc2ms);
+}
+
+/**
+ * @brief 周期数转换为纳秒
+ *
+ * @param cycles 周期数
+ * @return acoral_u64 纳秒
+ */
+acoral_u64 acoral_cycles_to_ns(acoral_u64 cycles)
+{
+    return clock_conv(cycles,&cyc2ns);
+}
+
+/**
+ * @brief 周期数转换为微秒
+ *
+ * @param cycles 周期数
+ * @return acoral_u64 微秒
+ */
+acoral_u64 acoral_cycles_to_us(acoral_u64 cycles)
+{
+    return clock_conv(cycles,&cyc2us);
+}
+
+/**
+ * @brief 周期数转换为毫秒
+ *
+ * @param cycles 周期数
+ * @return acoral_u64 毫秒
+ */
+acoral_u64 acoral_cycles_to_ms(acoral_u64 cycles)
+{
+    return clock_conv(cycles,&cyc2ms);
+}
+
+/**
+ * @brief 纳秒转换为周期数
+ *
+ * @param ns 纳秒
+ * @return acoral_u64 周期数
+ */
+acoral_u64 acoral_ns_to_cycles(acoral_u64 ns)
+{
+    return clock_conv(ns,&ns2cyc);
+}
+
+/**
+ * @brief 微秒转换为周期数
+ *
+ * @param us 微秒
+ * @return acoral_u64 周期数
+ */
+acoral_u64 acoral_us_to_cycles(acoral_u64 us)
+{
+    return clock_conv(us,&us2cyc);
+}
@@ -0,0 +1,231 @@
+/**
+ * @file crit_prof.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层临界区分析源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>最外层临界区时长、最长者调用地址、直方图与按调用地址的排行
+ */
+#include <acoral.h>
+
+#ifdef CFG_CRIT_PROF
+///每us的cycles数
+#define CRIT_PROF_CYCLES_PER_US (ACORAL_CLOCK_HZ/1000000)
+
+/**
+ * @brief 每cpu临界区分析状态，只由所在cpu在临界区内(已关中断)写入，写入前后各加一次序号，读取者序号变化时重读
+ *
+ */
+typedef struct{
+    volatile acoral_u32 seq;///<写入序号，奇数表示正在写入
+    acoral_u32 gen;///<统计所属的清零代数，与crit_prof_gen不同时统计作废
+    acoral_u8 active;///<正处于被计时的最外层临界区中
+    acoral_u64 start;///<最外层临界区进入时刻
+    acoral_u32 enter;///<最外层临界区进入处的调用地址
+    acoral_crit_prof_t prof;///<统计
+}__attribute__((aligned(ACORAL_CACHE_LINE_SIZE))) crit_prof_cpu_t;
+
+///各cpu临界区分析状态
+static crit_prof_cpu_t crit_prof_cpu[CFG_MAX_CPU];
+///清零代数，清零时增加，各cpu在下次进入临界区时清空自己的统计
+static volatile acoral_u32 crit_prof_gen;
+
+/**
+ * @brief 计算时长所在的直方图桶
+ *
+ * @param cycles 时长(cycles)
+ * @return acoral_u32 桶号
+ */
+static acoral_u32 crit_prof_bucket(acoral_u32 cycles)
+{
+    acoral_u32 us=cycles/CRIT_PROF_CYCLES_PER_US,b;
+    if(us==0)
+        return 0;
+    b=32-__builtin_clz(us);
+    return b<CFG_CRIT_PROF_HIST_NUM?b:CFG_CRIT_PROF_HIST_NUM-1;
+}
+
+/**
+ * @brief 按调用地址记录一次临界区，表满时替换最长时长最小且短于本次的一项
+ *
+ * @param prof 本cpu统计
+ * @param addr 进入处的调用地址
+ * @param cycles 时长
+ */
+static void crit_prof_top_add(acoral_crit_prof_t *prof, acoral_u32 addr, acoral_u32 cycles)
+{
+    acoral_crit_prof_top_t *top=prof->top,*min=NULL;
+    acoral_u32 i;
+    for(i=0;i<CFG_CRIT_PROF_TOP_NUM;i++)
+    {
+        if(top[i].count==0||top[i].addr==addr)
+            break;
+        if(min==NULL||top[i].max<min->max)
+            min=&top[i];
+    }
+    if(i==CFG_CRIT_PROF_TOP_NUM)
+    {
+        if(cycles<=min->max)
+            return;
+        top=min;
+        top->addr=addr;
+        top->count=0;
+        top->max=0;
+        top->sum=0;
+    }
+    else
+    {
+        top=&top[i];
+        top->addr=addr;
+    }
+    top->count++;
+    top->sum+=cycles;
+    if(cycles>top->max)
+        top->max=cycles;
+}
+
+/**
+ * @brief 进入最外层临界区时调用，此时已关中断
+ *
+ * @param addr 进入处的调用地址
+ */
+void acoral_crit_prof_enter(acoral_u32 addr)
+{
+    crit_prof_cpu_t *cc=&crit_prof_cpu[acoral_current_cpu];
+    acoral_u32 gen=crit_prof_gen;
+    if(cc->gen!=gen)//有清零请求，清空本cpu的统计
+    {
+        cc->seq++;
+        acoral_dmb();
+        acoral_memset(&cc->prof,0,sizeof(cc->prof));
+        cc->gen=gen;
+        acoral_dmb();
+        cc->seq++;
+    }
+    cc->enter=addr;
+    cc->active=1;
+    cc->start=acoral_clock_cycles();
+}
+
+/**
+ * @brief 退出最外层临界区时调用，此时尚未开中断
+ *
+ * @param addr 退出处的调用地址
+ */
+void acoral_crit_prof_exit(acoral_u32 addr)
+{
+    acoral_u64 now=acoral_clock_cycles();
+    crit_prof_cpu_t *cc=&crit_prof_cpu[acoral_current_cpu];
+    acoral_crit_prof_t *prof=&cc->prof;
+    acoral_thread_t *cur;
+    acoral_u32 cycles;
+    if(!cc->active)//不成对的退出
+        return;
+    cc->active=0;
+    cycles=(acoral_u32)(now-cc->start);
+    cc->seq++;
+    acoral_dmb();
+    prof->count++;
+    prof->sum+=cycles;
+    prof->hist[crit_prof_bucket(cycles)]++;
+    if(cycles>prof->max)
+    {
+        cur=acoral_cur_thread;
+        prof->max=cycles;
+        prof->max_enter=cc->enter;
+        prof->max_exit=addr;
+        prof->max_thread=cur!=NULL?cur->res.id:-1;
+    }
+    crit_prof_top_add(prof,cc->enter,cycles);
+    acoral_dmb();
+    cc->seq++;
+}
+
+/**
+ * @brief 获取一个cpu的临界区统计，可在任意cpu调用
+ *
+ * @param cpu cpu号
+ * @param prof 返回统计
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_crit_prof_get(acoral_u32 cpu, acoral_crit_prof_t *prof)
+{
+    crit_prof_cpu_t *cc;
+    acoral_u32 seq,gen;
+    if(prof==NULL)
+        return KR_STAT_ERR_NULL;
+    if(cpu>=CFG_MAX_CPU)
+        return KR_STAT_ERR_CPU;
+    cc=&crit_prof_cpu[cpu];
+    while(1)
+    {
+        seq=cc->seq;
+        acoral_dmb();
+        if(seq&1)
+            continue;
+        gen=cc->gen;
+        *prof=cc->prof;
+        acoral_dmb();
+        if(cc->seq==seq)
+            break;
+    }
+    if(gen!=crit_prof_gen)//清零后该cpu还没有进入临界区
+        acoral_memset(prof,0,sizeof(*prof));
+    return KR_OK;
+}
+
+/**
+ * @brief 清零所有临界区统计，各cpu在下一次进入临界区时清空自己的统计，在此之前读取结果为0
+ *
+ */
+void acoral_crit_prof_reset(void)
+{
+    crit_prof_gen++;
+    acoral_dmb();
+}
+
+/**
+ * @brief 打印各cpu的临界区统计、直方图与按最长时长排序的调用地址，地址可用addr2line对应到源码
+ *
+ */
+void acoral_crit_prof_report(void)
+{
+    static acoral_crit_prof_t prof;//不放在调用者栈上，shell栈较小
+    acoral_crit_prof_top_t t;
+    acoral_u32 cpu,i,j;
+    for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+    {
+        acoral_crit_prof_get(cpu,&prof);
+        acoral_print("cpu%u: count %u, avg %u ns, max %u ns in thread %d, enter 0x%08x exit 0x%08x\r\n",
+                     cpu,prof.count,
+                     prof.count?(acoral_u32)acoral_cycles_to_ns(prof.sum/prof.count):0,
+                     (acoral_u32)acoral_cycles_to_ns(prof.max),
+                     prof.max_thread,prof.max_enter,prof.max_exit);
+        acoral_print("  hist");
+        for(i=0;i<CFG_CRIT_PROF_HIST_NUM;i++)
+            acoral_print("%7u",prof.hist[i]);
+        acoral_print("\r\n");
+        for(i=1;i<CFG_CRIT_PROF_TOP_NUM;i++)//插入排序，表项不多
+        {
+            t=prof.top[i];
+            for(j=i;j>0&&prof.top[j-1].max<t.max;j--)
+                prof.top[j]=prof.top[j-1];
+            prof.top[j]=t;
+        }
+        acoral_print("  %-12s%10s%10s%10s\r\n","enter","count","avg_ns","max_ns");
+        for(i=0;i<CFG_CRIT_PROF_TOP_NUM&&prof.top[i].count!=0;i++)
+        {
+            acoral_print("  0x%08x%10u%10u%10u\r\n",prof.top[i].addr,prof.top[i].count,
+                         (acoral_u32)acoral_cycles_to_ns(prof.top[i].sum/prof.top[i].count),
+                         (acoral_u32)acoral_cycles_to_ns(prof.top[i].max));
+        }
+    }
+    acoral_print("hist column i counts [2^(i-1),2^i) us, last column includes longer\r\n");
+}
+#endif
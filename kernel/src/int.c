@@ -12,6 +12,9 @@
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-08 <td>增加注释
  *         <tr><td>v1.1 <td>文佳源 <td>2024-09-25 <td>增加注册中断服务函数和开关中断的接口
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>中断服务函数进出事件追踪
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>统计中断服务时间
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>各中断服务时间、延迟与嵌套统计
  */
 #include <type.h>
 #include <hal.h>
@@ -19,6 +22,9 @@
 #include <cpu.h>
 #include <int.h>
 #include <print.h>
+#include <trace.h>
+#include <usage.h>
+#include <irq_stat.h>
 #include "xscugic.h"
 
 ///中断系统控制结构体实例
@@ -46,7 +52,15 @@ void acoral_intr_handler( acoral_u32 ulICCIAR )
     if( ulInterruptID < XSCUGIC_MAX_NUM_INTR_INPUTS )
     {
         pxVectorEntry = &( pxVectorTable[ ulInterruptID ] );//获取该中断结构体
+#ifdef CFG_IRQ_STAT
+        acoral_irq_stat_enter(ulInterruptID);
+#endif
+        ACORAL_TRACE(ACORAL_TRACE_IRQ_ENTER,ulInterruptID,0,0);
         pxVectorEntry->Handler( pxVectorEntry->CallBackRef );//运行该中断服务函数
+        ACORAL_TRACE(ACORAL_TRACE_IRQ_EXIT,ulInterruptID,0,0);
+#ifdef CFG_IRQ_STAT
+        acoral_irq_stat_exit(ulInterruptID);
+#endif
     }
 }
 /**
@@ -130,9 +144,15 @@ void acoral_intr_sys_init(void)
 void acoral_intr_entry( acoral_u32 ulICCIAR )
 {
     acoral_intr_nesting_inc();	//增加中断嵌套计数
+#ifdef CFG_CPU_USAGE
+    acoral_usage_irq_enter();	//被打断的线程或外层中断记账
+#endif
     acoral_intr_enable();		//开启中断，允许重入
     acoral_intr_handler(ulICCIAR);
     acoral_intr_disable();		//关闭中断
+#ifdef CFG_CPU_USAGE
+    acoral_usage_irq_exit();	//中断服务时间记账
+#endif
     acoral_intr_nesting_dec();	//减少中断嵌套计数
     acoral_intr_exit();			//查看是否需要调度
 }
@@ -13,6 +13,8 @@
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-13 <td>增加注释
  *         <tr><td>v1.1 <td>胡博文 <td>2022-09-26 <td>错误头文件相关改动
  *         <tr><td>v1.2 <td>文佳源 <td>2025-02-26 <td>修改acoral_ipc_wait_queue_empty返回值类型bool->acoral_bool
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>等待队列阻塞/解除事件追踪
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>按ACORAL_TRACE_THREAD记录线程
  * 
  */
 #include <acoral.h>
@@ -102,6 +104,7 @@ void acoral_ipc_wait_queue_add(acoral_ipc_t *ipc, void *new)
 {
 	acoral_thread_t *thread = (acoral_thread_t *)new;
 	thread->ipc=ipc;
+    ACORAL_TRACE(ACORAL_TRACE_IPC_BLOCK,ACORAL_TRACE_THREAD(thread),ipc,0);
 #if CFG_IPC_QUEUE_MODE == CFG_FIFO_QUEUE
     acoral_fifo_queue_add(&ipc->wait_queue, &thread->pending);
 #else
@@ -122,6 +125,7 @@ void acoral_ipc_wait_queue_del(acoral_ipc_t *ipc, void *old)
 #else
     acoral_prio_queue_del(&ipc->wait_queue, &thread->pending);
 #endif
+    ACORAL_TRACE(ACORAL_TRACE_IPC_UNBLOCK,ACORAL_TRACE_THREAD(thread),ipc,0);
     thread->ipc=NULL;
 }
 
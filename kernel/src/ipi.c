@@ -11,6 +11,7 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-08 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>核间命令事件追踪
  */
 
 #include <type.h>
@@ -20,6 +21,7 @@
 #include <int.h>
 #include <thread.h>
 #include <admis_ctl.h>
+#include <trace.h>
 #include "xscugic.h"
 #ifdef CFG_SMP
 ///核间中断命令实例
@@ -109,7 +111,7 @@ void acoral_ipi_cmd_send(acoral_u32 cpu,acoral_u32 cmd,acoral_id thread_id,void
     cmd_data->cmd=cmd;
     cmd_data->thread_id=thread_id;
     cmd_data->data=data;
-    
+    ACORAL_TRACE(ACORAL_TRACE_IPI_SEND,cpu,cmd,thread_id);
     acoral_ipi_send(cpu);//发送核间中断
 }
 
@@ -129,6 +131,7 @@ void acoral_ipi_cmd_handler(void *CallBackRef)
     thread_id=cmd_data->thread_id;
     data=cmd_data->data;
     acoral_spin_unlock(&cmd_data->lock);//释放cmd数据结构锁
+    ACORAL_TRACE(ACORAL_TRACE_IPI_RECV,cmd,thread_id,0);
 
     switch(cmd)
     {
@@ -0,0 +1,341 @@
+/**
+ * @file irq_stat.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层中断统计源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>各中断次数、服务时间、延迟直方图与各核嵌套深度统计
+ */
+#include <acoral.h>
+
+#ifdef CFG_IRQ_STAT
+///每us的cycles数
+#define IRQ_STAT_CYCLES_PER_US (ACORAL_CLOCK_HZ/1000000)
+
+/**
+ * @brief 每cpu中断统计，统计字段只由所在cpu关中断写入，写入前后各加一次序号，读取者序号变化时重读
+ *
+ */
+typedef struct{
+    volatile acoral_u32 seq;///<写入序号，奇数表示正在写入
+    acoral_u32 gen;///<统计所属的清零代数，与irq_stat_gen不同时统计作废
+    acoral_irq_stat_t irq[ACORAL_IRQ_STAT_NUM];///<各中断统计
+    acoral_irq_nest_stat_t nest;///<嵌套统计
+    acoral_u64 start[CFG_IRQ_STAT_NEST_MAX];///<各层中断服务开始时刻
+    acoral_u64 child[CFG_IRQ_STAT_NEST_MAX];///<各层中断服务期间被嵌套中断占用的时间
+}__attribute__((aligned(ACORAL_CACHE_LINE_SIZE))) irq_stat_cpu_t;
+
+///各cpu中断统计
+static irq_stat_cpu_t irq_stat_cpu[CFG_MAX_CPU];
+///清零代数，清零时增加，各cpu在下次中断时清空自己的统计
+static volatile acoral_u32 irq_stat_gen;
+///各中断的延迟获取函数
+static acoral_irq_latency_t irq_latency[ACORAL_IRQ_STAT_NUM];
+///各中断延迟获取函数的参数
+static void *irq_latency_data[ACORAL_IRQ_STAT_NUM];
+
+/**
+ * @brief 计算时间所在的直方图桶
+ *
+ * @param cycles 时间(cycles)
+ * @return acoral_u32 桶号
+ */
+static acoral_u32 irq_stat_bucket(acoral_u32 cycles)
+{
+    acoral_u32 us=cycles/IRQ_STAT_CYCLES_PER_US,b;
+    if(us==0)
+        return 0;
+    b=32-__builtin_clz(us);
+    return b<CFG_IRQ_STAT_HIST_NUM?b:CFG_IRQ_STAT_HIST_NUM-1;
+}
+
+/**
+ * @brief 中断服务函数开始前调用，记录嵌套深度、延迟和开始时刻
+ *
+ * @param irq 中断号
+ */
+void acoral_irq_stat_enter(acoral_u32 irq)
+{
+    acoral_u32 flags,depth,lat,gen;
+    acoral_u64 now;
+    irq_stat_cpu_t *sc;
+    acoral_irq_stat_t *st;
+    flags=acoral_intr_save();
+    now=acoral_clock_cycles();
+    sc=&irq_stat_cpu[acoral_current_cpu];
+    depth=acoral_intr_nesting;
+    sc->seq++;
+    acoral_dmb();
+    gen=irq_stat_gen;
+    if(sc->gen!=gen)//有清零请求，清空本cpu的统计
+    {
+        acoral_memset(sc->irq,0,sizeof(sc->irq));
+        acoral_memset(&sc->nest,0,sizeof(sc->nest));
+        sc->gen=gen;
+    }
+    if(depth>sc->nest.max)
+        sc->nest.max=depth;
+    if(depth==0||depth>CFG_IRQ_STAT_NEST_MAX)
+        sc->nest.overflow++;
+    else
+    {
+        sc->nest.depth[depth-1]++;
+        sc->start[depth-1]=now;
+        sc->child[depth-1]=0;
+    }
+    if(irq<ACORAL_IRQ_STAT_NUM&&irq_latency[irq]!=NULL)
+    {
+        lat=irq_latency[irq](irq_latency_data[irq]);
+        st=&sc->irq[irq];
+        if(st->lat_count==0||lat<st->lat_min)
+            st->lat_min=lat;
+        if(lat>st->lat_max)
+            st->lat_max=lat;
+        st->lat_count++;
+        st->lat_sum+=lat;
+        st->lat_hist[irq_stat_bucket(lat)]++;
+    }
+    acoral_dmb();
+    sc->seq++;
+    acoral_intr_restore_flags(flags);
+}
+
+/**
+ * @brief 中断服务函数结束后调用，记录扣除嵌套中断后的服务时间
+ *
+ * @param irq 中断号
+ */
+void acoral_irq_stat_exit(acoral_u32 irq)
+{
+    acoral_u32 flags,depth,cycles;
+    acoral_u64 now,total;
+    irq_stat_cpu_t *sc;
+    acoral_irq_stat_t *st;
+    flags=acoral_intr_save();
+    now=acoral_clock_cycles();
+    sc=&irq_stat_cpu[acoral_current_cpu];
+    depth=acoral_intr_nesting;
+    if(irq>=ACORAL_IRQ_STAT_NUM||depth==0||depth>CFG_IRQ_STAT_NEST_MAX)
+    {
+        acoral_intr_restore_flags(flags);
+        return;
+    }
+    sc->seq++;
+    acoral_dmb();
+    total=now-sc->start[depth-1];
+    cycles=(acoral_u32)(total-sc->child[depth-1]);
+    if(depth>1)
+        sc->child[depth-2]+=total;//整段时间记到外层中断的嵌套时间中
+    st=&sc->irq[irq];
+    if(st->count==0||cycles<st->min)
+        st->min=cycles;
+    if(cycles>st->max)
+        st->max=cycles;
+    st->count++;
+    st->sum+=cycles;
+    st->hist[irq_stat_bucket(cycles)]++;
+    acoral_dmb();
+    sc->seq++;
+    acoral_intr_restore_flags(flags);
+}
+
+/**
+ * @brief 注册中断的延迟获取函数，只有中断源能给出置位时刻的中断才能统计延迟
+ *
+ * @param irq 中断号
+ * @param latency 延迟获取函数，为NULL时取消
+ * @param data 延迟获取函数的参数
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_irq_stat_latency_register(acoral_u32 irq, acoral_irq_latency_t latency, void *data)
+{
+    if(irq>=ACORAL_IRQ_STAT_NUM)
+        return KR_STAT_ERR_IRQ;
+    irq_latency[irq]=NULL;
+    acoral_dmb();
+    irq_latency_data[irq]=data;
+    acoral_dmb();//参数先于函数可见
+    irq_latency[irq]=latency;
+    return KR_OK;
+}
+
+/**
+ * @brief 读取某cpu的一个中断统计或嵌套统计，可在任意cpu调用
+ *
+ * @param cpu cpu号
+ * @param irq 中断号，为ACORAL_IRQ_STAT_NUM时读取嵌套统计
+ * @param stat 返回中断统计，irq为ACORAL_IRQ_STAT_NUM时不使用
+ * @param nest 返回嵌套统计，irq不为ACORAL_IRQ_STAT_NUM时不使用
+ */
+static void irq_stat_read(acoral_u32 cpu, acoral_u32 irq, acoral_irq_stat_t *stat, acoral_irq_nest_stat_t *nest)
+{
+    irq_stat_cpu_t *sc=&irq_stat_cpu[cpu];
+    acoral_u32 seq,gen;
+    while(1)
+    {
+        seq=sc->seq;
+        acoral_dmb();
+        if(seq&1)
+            continue;
+        gen=sc->gen;
+        if(irq<ACORAL_IRQ_STAT_NUM)
+            *stat=sc->irq[irq];
+        else
+            *nest=sc->nest;
+        acoral_dmb();
+        if(sc->seq==seq)
+            break;
+    }
+    if(gen!=irq_stat_gen)//清零后该cpu还没有中断
+    {
+        if(irq<ACORAL_IRQ_STAT_NUM)
+            acoral_memset(stat,0,sizeof(*stat));
+        else
+            acoral_memset(nest,0,sizeof(*nest));
+    }
+}
+
+/**
+ * @brief 获取一个中断在所有cpu上的合计统计
+ *
+ * @param irq 中断号
+ * @param stat 返回统计
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_irq_stat_get(acoral_u32 irq, acoral_irq_stat_t *stat)
+{
+    acoral_irq_stat_t one;
+    acoral_u32 cpu,i;
+    if(stat==NULL)
+        return KR_STAT_ERR_NULL;
+    if(irq>=ACORAL_IRQ_STAT_NUM)
+        return KR_STAT_ERR_IRQ;
+    acoral_memset(stat,0,sizeof(*stat));
+    for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+    {
+        irq_stat_read(cpu,irq,&one,NULL);
+        if(one.count!=0)
+        {
+            if(stat->count==0||one.min<stat->min)
+                stat->min=one.min;
+            if(one.max>stat->max)
+                stat->max=one.max;
+            stat->count+=one.count;
+            stat->sum+=one.sum;
+        }
+        if(one.lat_count!=0)
+        {
+            if(stat->lat_count==0||one.lat_min<stat->lat_min)
+                stat->lat_min=one.lat_min;
+            if(one.lat_max>stat->lat_max)
+                stat->lat_max=one.lat_max;
+            stat->lat_count+=one.lat_count;
+            stat->lat_sum+=one.lat_sum;
+        }
+        for(i=0;i<CFG_IRQ_STAT_HIST_NUM;i++)
+        {
+            stat->hist[i]+=one.hist[i];
+            stat->lat_hist[i]+=one.lat_hist[i];
+        }
+    }
+    return KR_OK;
+}
+
+/**
+ * @brief 获取一个cpu的中断嵌套统计
+ *
+ * @param cpu cpu号
+ * @param stat 返回统计
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_irq_nest_get(acoral_u32 cpu, acoral_irq_nest_stat_t *stat)
+{
+    if(stat==NULL)
+        return KR_STAT_ERR_NULL;
+    if(cpu>=CFG_MAX_CPU)
+        return KR_STAT_ERR_CPU;
+    irq_stat_read(cpu,ACORAL_IRQ_STAT_NUM,NULL,stat);
+    return KR_OK;
+}
+
+/**
+ * @brief 清零所有中断统计，各cpu在下一次中断时清空自己的统计，在此之前读取结果为0
+ *
+ */
+void acoral_irq_stat_reset(void)
+{
+    irq_stat_gen++;
+    acoral_dmb();
+}
+
+/**
+ * @brief 打印一行直方图的各桶，行名由调用者先打印
+ *
+ * @param hist 直方图
+ */
+static void irq_stat_hist_print(const acoral_u32 *hist)
+{
+    acoral_u32 i;
+    for(i=0;i<CFG_IRQ_STAT_HIST_NUM;i++)
+        acoral_print("%7u",hist[i]);
+    acoral_print("\r\n");
+}
+
+/**
+ * @brief 打印有过服务的中断的统计与直方图，以及各cpu的嵌套统计
+ *
+ */
+void acoral_irq_stat_report(void)
+{
+    acoral_irq_stat_t stat;
+    acoral_irq_nest_stat_t nest;
+    acoral_u32 irq,cpu,i;
+    acoral_print("%-6s%10s%10s%10s%10s%10s%10s%10s\r\n",
+                 "irq","count","min_ns","avg_ns","max_ns","lat_min","lat_avg","lat_max");
+    for(irq=0;irq<ACORAL_IRQ_STAT_NUM;irq++)
+    {
+        acoral_irq_stat_get(irq,&stat);
+        if(stat.count==0)
+            continue;
+        acoral_print("%-6u%10u%10u%10u%10u",irq,stat.count,
+                     (acoral_u32)acoral_cycles_to_ns(stat.min),
+                     (acoral_u32)acoral_cycles_to_ns(stat.sum/stat.count),
+                     (acoral_u32)acoral_cycles_to_ns(stat.max));
+        if(stat.lat_count!=0)
+            acoral_print("%10u%10u%10u\r\n",
+                         (acoral_u32)acoral_cycles_to_ns(stat.lat_min),
+                         (acoral_u32)acoral_cycles_to_ns(stat.lat_sum/stat.lat_count),
+                         (acoral_u32)acoral_cycles_to_ns(stat.lat_max));
+        else
+            acoral_print("%10s%10s%10s\r\n","-","-","-");
+    }
+    acoral_print("histogram, column i counts [2^(i-1),2^i) us, last column includes longer\r\n");
+    for(irq=0;irq<ACORAL_IRQ_STAT_NUM;irq++)
+    {
+        acoral_irq_stat_get(irq,&stat);
+        if(stat.count==0)
+            continue;
+        acoral_print("%-6u",irq);
+        irq_stat_hist_print(stat.hist);
+        if(stat.lat_count!=0)
+        {
+            acoral_print("%-6s","  lat");
+            irq_stat_hist_print(stat.lat_hist);
+        }
+    }
+    for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+    {
+        acoral_irq_nest_get(cpu,&nest);
+        acoral_print("cpu%u nesting max %u, overflow %u, entries by depth:",cpu,nest.max,nest.overflow);
+        for(i=0;i<CFG_IRQ_STAT_NEST_MAX;i++)
+            acoral_print(" %u",nest.depth[i]);
+        acoral_print("\r\n");
+    }
+}
+#endif
@@ -12,15 +12,27 @@
  * <table>
  * <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  * <tr><td>v1.0 <td>高久强 <td>2025-02-24 <td>内容
+ * <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>切换信息改用每cpu追踪缓冲区，线程信息加锁并按加入顺序取出
+ * <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>紧凑编码：差分时间戳、小线程号、变长整数、带序号和CRC的批量帧
+ * <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>经串口发送缓冲区发送，不再关中断等待串口
+ * <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>组帧移到wire.c，与二进制日志共用
+ * <tr><td>v1.5 <td>胡博文 <td>2026-10-19 <td>线程号在创建时写入tcb，追踪记录写入时即为线程号，发送时不再查表
+ * <tr><td>v1.6 <td>胡博文 <td>2026-10-19 <td>原始帧的数据头与数据拼在一起整体写入发送缓冲区
+ * <tr><td>v1.7 <td>胡博文 <td>2026-10-19 <td>原始帧按发送缓冲区满时的处理方式写入
  * </table>
  */
 #include "monitor.h"
 #include "lib.h"
-//#include "acosim.pb.h"
-//#include "pb_encode.h"
+#ifdef CFG_UART_TX_RING
+#include "uart.h"
+#endif
+#ifdef CFG_TRACE_WIRE_COMPACT
+#include "acosim.pb.h"
+#include "pb_encode.h"
+#endif
 
+#ifdef CFG_TRACE_THREADS_SWITCH_ENABLE
 acoral_spinlock_t tinfos_lock;
-acoral_spinlock_t tswinfos_lock;
 acoral_spinlock_t send_lock;
 
 thread_info_set tinfos_real = {
@@ -32,31 +44,46 @@ thread_info_set tinfos_real = {
         .item_bsize = sizeof(thread_info),
         .overflow = 0,
 };
-thread_switch_info_set tswinfos_real = {
-        .total_size = CFG_MAX_THREAD,
-        .threshold = CFG_MAX_THREAD/2,
-        .st_idx = 0,
-        .ed_idx = 0,
-        .info_type = MONITOR_CMD_SWITCH,
-        .size = 0,
-        .item_bsize = sizeof(thread_info),
-        .overflow = 0
-};
 
 thread_info_set *tinfos = &tinfos_real;
-thread_switch_info_set *tswinfos = &tswinfos_real;
+/* 发送线程使用的线程信息与追踪记录副本 */
+static thread_info tinfos_buf[CFG_MAX_THREAD];
+static acoral_trace_rec_t trace_buf[CFG_TRACE_RING_SIZE];
 
-#ifdef CFG_TRACE_THREADS_SWITCH_WITH_SIM_ENABLE
+#ifdef CFG_TRACE_WIRE_COMPACT
+#if CFG_TRACE_WIRE_BATCH > ACORAL_WIRE_PAYLOAD_MAX
+#error "CFG_TRACE_WIRE_BATCH must not exceed ACORAL_WIRE_PAYLOAD_MAX"
+#endif
+/* 单个事件编码的最大字节数：类型、时间差、3个参数 */
+#define MONITOR_WIRE_EVENT_MAX  32
+/* 批量帧中cpu、基准时间、丢失数和事件字段头的最大字节数 */
+#define MONITOR_WIRE_BATCH_HEAD 26
+/* 批量帧中事件的最大字节数 */
+#define MONITOR_WIRE_EVENTS_MAX (CFG_TRACE_WIRE_BATCH - MONITOR_WIRE_BATCH_HEAD)
+
+static acoral_u32 task_id_next = 1;     // 0表示未知线程
+static acoral_u32 wire_lost[CFG_MAX_CPU];
+static acoral_u8 wire_payload[CFG_TRACE_WIRE_BATCH];
+static acoral_u8 wire_events[MONITOR_WIRE_EVENTS_MAX];
+#elif defined(CFG_TRACE_THREADS_SWITCH_WITH_SIM_ENABLE)
 typedef struct {
     char title[4];
     acoral_u32 type;
     acoral_u32 length;
 } header_info;
 static header_info header;
+#ifdef CFG_UART_TX_RING
+/* 原始帧中最大的数据 */
+#define MONITOR_RAW_DATA_MAX (sizeof(thread_info) > sizeof(acoral_trace_rec_t) ? \
+                              (sizeof(thread_info) > sizeof(CPUcore_info) ? sizeof(thread_info) : sizeof(CPUcore_info)) : \
+                              (sizeof(acoral_trace_rec_t) > sizeof(CPUcore_info) ? sizeof(acoral_trace_rec_t) : sizeof(CPUcore_info)))
+/* 数据头与数据拼成的原始帧 */
+static acoral_u8 raw_frame[sizeof(header_info) + MONITOR_RAW_DATA_MAX];
+#endif
 #endif
 
 void acoral_monitor_init(void) {
-#ifdef CFG_TRACE_THREADS_SWITCH_WITH_SIM_ENABLE
+#if defined(CFG_TRACE_THREADS_SWITCH_WITH_SIM_ENABLE) && !defined(CFG_TRACE_WIRE_COMPACT)
     for (int i = 0; i < 4; i++) {
         header.title[i] = '+';
     }
@@ -65,7 +92,6 @@ void acoral_monitor_init(void) {
 #endif
     // 初始化自旋锁
     acoral_spin_init(&tinfos_lock);
-    acoral_spin_init(&tswinfos_lock);
     acoral_spin_init(&send_lock);
 //     初始化串口输出线程
     acoral_period_policy_data_t *period_policy_data = (acoral_period_policy_data_t *)acoral_vol_malloc(sizeof(acoral_period_policy_data_t));
@@ -85,14 +111,40 @@ void acoral_monitor_init(void) {
     // 暂时先不写
 }
 
+#ifdef CFG_TRACE_WIRE_COMPACT
+/**
+ * @brief 为新创建的线程分配线程号，在线程创建时写入tcb，追踪记录中的线程参数即为该号
+ * 
+ * @return acoral_u32 线程号，从1开始，tcb被回收再创建时分配新号
+ */
+acoral_u32 acoral_monitor_task_id_new(void) {
+    acoral_u32 id;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&tinfos_lock);
+#endif
+    id = task_id_next++;
+    if(task_id_next == 0) {     // 回绕时跳过0
+        task_id_next = 1;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&tinfos_lock);
+#endif
+    acoral_exit_critical();
+    return id;
+}
+#endif
+
 /**
  * @brief 添加线程信息
  * 
  * @param  thread           线程指针
  */
 void acoral_tinfos_add(acoral_thread_t* thread) {
-//    acoral_enter_critical();
-//    acoral_spin_lock(&tinfos_lock);
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&tinfos_lock);
+#endif
     // 插入数据操作
     tinfos -> threads[tinfos -> ed_idx].tcb_ptr = thread;
     tinfos -> threads[tinfos -> ed_idx].thread_policy = thread -> policy;
@@ -114,6 +166,9 @@ void acoral_tinfos_add(acoral_thread_t* thread) {
     tinfos -> threads[tinfos -> ed_idx].cpu = thread -> cpu;
     tinfos -> threads[tinfos -> ed_idx].create_tick = acoral_ticks;
     acoral_str_cpy(&((tinfos -> threads[tinfos -> ed_idx]).thread_name[0]), thread -> name);
+#ifdef CFG_TRACE_WIRE_COMPACT
+    tinfos -> threads[tinfos -> ed_idx].task_id = thread -> task_id;
+#endif
 
     if(tinfos -> ed_idx < tinfos-> total_size - 1 ) {
         tinfos -> ed_idx ++;
@@ -125,42 +180,207 @@ void acoral_tinfos_add(acoral_thread_t* thread) {
             tinfos -> size ++;
         }
     }
-//    acoral_spin_unlock(&tinfos_lock);
-//    acoral_exit_critical();
+#ifdef CFG_SMP
+    acoral_spin_unlock(&tinfos_lock);
+#endif
+    acoral_exit_critical();
+}
 
+/**
+ * @brief 按加入顺序取出线程信息并清空
+ * 
+ * @return acoral_u32 取出的线程信息个数
+ */
+static acoral_u32 acoral_tinfos_take(void) {
+    acoral_u32 num, idx;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&tinfos_lock);
+#endif
+    num = tinfos -> size;
+    idx = tinfos -> overflow > 0 ? tinfos -> ed_idx : 0;   // 回绕后最旧的条目在ed_idx
+    for(int i = 0; i < num; i++) {
+        tinfos_buf[i] = tinfos -> threads[idx];
+        idx = idx + 1 < tinfos -> total_size ? idx + 1 : 0;
+    }
+    tinfos -> size = 0;
+    tinfos -> st_idx = 0;
+    tinfos -> ed_idx = 0;
+    tinfos -> overflow = 0;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&tinfos_lock);
+#endif
+    acoral_exit_critical();
+    return num;
 }
 
+#ifdef CFG_TRACE_WIRE_COMPACT
+
 /**
- * @brief 线程切换信息添加
+ * @brief nanopb字符串字段编码回调
  * 
- * @param  from             被切换的线程指针
- * @param  to               要切换到的线程指针
+ * @param  stream           输出流
+ * @param  field            字段
+ * @param  arg              以0结尾的字符串
+ * @return bool 是否成功
  */
-void acoral_tswinfos_add(acoral_thread_t* from, acoral_thread_t* to) {
-//    acoral_enter_critical();
-//    acoral_spin_lock(&tswinfos_lock);
-    /* 填充任务切换信息 */
-    tswinfos -> switch_infos[tswinfos -> ed_idx].cpu = acoral_current_cpu;
-    tswinfos -> switch_infos[tswinfos -> ed_idx].tick = acoral_ticks;
-    tswinfos -> switch_infos[tswinfos -> ed_idx].from_tcb = from;
-    tswinfos -> switch_infos[tswinfos -> ed_idx].to_tcb = to;
-//    acoral_str_cpy(&(tswinfos -> switch_infos[tswinfos -> ed_idx].from_name[0]), from -> name);
-//    acoral_str_cpy(&(tswinfos -> switch_infos[tswinfos -> ed_idx].to_name[0]), to -> name);
-    if(tswinfos -> ed_idx < tswinfos -> total_size - 1 ) {
-        tswinfos -> ed_idx ++;
-        tswinfos -> size ++;
-    } else {
-        tswinfos -> ed_idx = 0;
-        tswinfos -> overflow ++;
-        tswinfos -> size ++;
+static bool monitor_pb_str(pb_ostream_t *stream, const pb_field_t *field, void * const *arg) {
+    const char *str = (const char *)*arg;
+    return pb_encode_tag_for_field(stream, field) &&
+           pb_encode_string(stream, (const pb_byte_t *)str, acoral_str_len(str));
+}
+
+/**
+ * @brief 事件的参数个数，线程参数在记录时已是线程号，见ACORAL_TRACE_THREAD
+ * 
+ * @param  type             事件类型
+ * @return acoral_u32 参数个数
+ */
+static acoral_u32 monitor_wire_args(acoral_u16 type) {
+    switch(type) {
+        case ACORAL_TRACE_SWITCH:
+        case ACORAL_TRACE_CREATE:
+            return 3;
+        case ACORAL_TRACE_WAKE:
+        case ACORAL_TRACE_IPC_BLOCK:
+        case ACORAL_TRACE_IPC_UNBLOCK:
+            return 2;
+        case ACORAL_TRACE_IRQ_ENTER:
+        case ACORAL_TRACE_IRQ_EXIT:
+            return 1;
+        case ACORAL_TRACE_IPI_RECV:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+/**
+ * @brief 编码一个事件：类型、与上一事件的时间差、参数，均为变长整数
+ * 
+ * @param  buf              输出，至少MONITOR_WIRE_EVENT_MAX字节
+ * @param  rec              追踪记录
+ * @param  prev             上一事件的时间戳
+ * @return acoral_u32 编码字节数
+ */
+static acoral_u32 monitor_event_encode(acoral_u8 *buf, acoral_trace_rec_t *rec, acoral_u64 prev) {
+    pb_ostream_t stream = pb_ostream_from_buffer(buf, MONITOR_WIRE_EVENT_MAX);
+    acoral_u32 arg[3] = {rec -> arg0, rec -> arg1, rec -> arg2};
+    acoral_u32 num = monitor_wire_args(rec -> type);
+    pb_encode_varint(&stream, rec -> type);
+    pb_encode_varint(&stream, rec -> ts - prev);
+    for(acoral_u32 i = 0; i < num; i++) {
+        pb_encode_varint(&stream, arg[i]);
     }
+    return stream.bytes_written;
+}
+
+/**
+ * @brief 发送一个事件批量帧(AcoSimTraceBatch)
+ * 
+ * @param  cpu              cpu号
+ * @param  base             第一个事件的时间戳
+ * @param  lost             该cpu至今丢失的记录数
+ * @param  len              wire_events中事件的字节数
+ */
+static void monitor_batch_send(acoral_u32 cpu, acoral_u64 base, acoral_u32 lost, acoral_u32 len) {
+    pb_ostream_t stream = pb_ostream_from_buffer(wire_payload, CFG_TRACE_WIRE_BATCH);
+    pb_encode_tag(&stream, PB_WT_VARINT, 1);
+    pb_encode_varint(&stream, cpu);
+    pb_encode_tag(&stream, PB_WT_VARINT, 2);
+    pb_encode_varint(&stream, base);
+    pb_encode_tag(&stream, PB_WT_VARINT, 3);
+    pb_encode_varint(&stream, lost);
+    pb_encode_tag(&stream, PB_WT_STRING, 4);
+    pb_encode_string(&stream, wire_events, len);
+    acoral_wire_send(ACORAL_WIRE_EVENTS, wire_payload, stream.bytes_written);
+}
 
-//    acoral_spin_unlock(&tswinfos_lock);
-//    acoral_exit_critical();
+/**
+ * @brief 把一个cpu读出的追踪记录按帧长上限分批发送，每批第一个事件的时间差为0
+ * 
+ * @param  cpu              cpu号
+ * @param  num              trace_buf中的记录数
+ * @param  lost             该cpu至今丢失的记录数
+ */
+static void monitor_events_send(acoral_u32 cpu, acoral_u32 num, acoral_u32 lost) {
+    acoral_u8 ev[MONITOR_WIRE_EVENT_MAX];
+    acoral_u32 len = 0, n;
+    acoral_u64 base = 0, prev = 0;
+    for(acoral_u32 i = 0; i < num; i++) {
+        if(len == 0) {
+            base = prev = trace_buf[i].ts;
+        }
+        n = monitor_event_encode(ev, &trace_buf[i], prev);
+        if(len + n > MONITOR_WIRE_EVENTS_MAX) {
+            monitor_batch_send(cpu, base, lost, len);
+            len = 0;
+            base = prev = trace_buf[i].ts;
+            n = monitor_event_encode(ev, &trace_buf[i], prev);
+        }
+        acoral_memcpy(&wire_events[len], ev, n);
+        len += n;
+        prev = trace_buf[i].ts;
+    }
+    // 没有新记录但丢失数变化时也发送，让接收端知道丢失
+    if(len > 0 || lost != wire_lost[cpu]) {
+        monitor_batch_send(cpu, base, lost, len);
+    }
+    wire_lost[cpu] = lost;
 }
 
+/**
+ * @brief 发送任务和切换信息
+ * 
+ */
+void acoral_infos_send() {
+    static acoral_u32 symbel = 0;
+    acoral_u32 print_num, lost;
+    pb_ostream_t stream;
 
-#ifdef CFG_TRACE_THREADS_SWITCH_WITH_SIM_ENABLE
+    // 发送核心的相关信息
+    if (symbel == 0) {
+        symbel = 1;
+        char name[] = "CPU 0";
+        AcoSimCore core = AcoSimCore_init_zero;
+        core.cpuFrequency = 666000000;
+        core.name.funcs.encode = monitor_pb_str;
+        core.name.arg = name;
+        for (int i = 0; i < CFG_MAX_CPU; i++) {
+            core.id = i;
+            name[4] = '0' + i;
+            stream = pb_ostream_from_buffer(wire_payload, CFG_TRACE_WIRE_BATCH);
+            if(pb_encode(&stream, AcoSimCore_fields, &core)) {
+                acoral_wire_send(ACORAL_WIRE_CORE, wire_payload, stream.bytes_written);
+            }
+        }
+    }
+    // 发送线程创建相关信息，线程号在创建时分配
+    print_num = acoral_tinfos_take();
+    for(int i = 0; i < print_num; i++) {
+        AcoSimTask task = AcoSimTask_init_zero;
+        task.taskId = tinfos_buf[i].task_id;
+        task.taskPolicy = tinfos_buf[i].thread_policy;
+        task.taskPrio = tinfos_buf[i].prio;
+        task.taskPeriod = tinfos_buf[i].period;
+        task.taskSuperCycle = tinfos_buf[i].supercycle;
+        task.taskCoreId = tinfos_buf[i].cpu;
+        task.taskCreateTick = tinfos_buf[i].create_tick;
+        task.taskName.funcs.encode = monitor_pb_str;
+        task.taskName.arg = &tinfos_buf[i].thread_name[0];
+        stream = pb_ostream_from_buffer(wire_payload, CFG_TRACE_WIRE_BATCH);
+        if(pb_encode(&stream, AcoSimTask_fields, &task)) {
+            acoral_wire_send(ACORAL_WIRE_TASK, wire_payload, stream.bytes_written);
+        }
+    }
+    // 发送各cpu的追踪记录
+    for(int cpu = 0; cpu < CFG_MAX_CPU; cpu++) {
+        print_num = acoral_trace_read(cpu, trace_buf, CFG_TRACE_RING_SIZE, &lost);
+        monitor_events_send(cpu, print_num, lost);
+    }
+}
+
+#elif defined(CFG_TRACE_THREADS_SWITCH_WITH_SIM_ENABLE)
 
 /**
  * @brief 发送字节数据
@@ -169,6 +389,23 @@ void acoral_tswinfos_add(acoral_thread_t* from, acoral_thread_t* to) {
  * @param  size             字节数
  */
 static void acoral_bytes_send(char * data, acoral_u32 size) {
+#ifdef CFG_UART_TX_RING
+    if(size > MONITOR_RAW_DATA_MAX) {
+        return;
+    }
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&send_lock);
+#endif
+    // 数据头与数据拼成一帧，与acoral_print一样按设置的处理方式等待或整体丢弃，接收端不会错位
+    acoral_memcpy(raw_frame, &header, sizeof(header));
+    acoral_memcpy(raw_frame + sizeof(header), data, size);
+    acoral_uart_write(raw_frame, sizeof(header) + size);
+#ifdef CFG_SMP
+    acoral_spin_unlock(&send_lock);
+#endif
+    acoral_exit_critical();
+#else
     acoral_enter_critical();
 #ifdef CFG_SMP
     acoral_spin_lock(&send_lock);
@@ -189,6 +426,7 @@ static void acoral_bytes_send(char * data, acoral_u32 size) {
     acoral_spin_unlock(&send_lock);
 #endif
    acoral_exit_critical();
+#endif
 }
 
 /**
@@ -198,27 +436,6 @@ static void acoral_bytes_send(char * data, acoral_u32 size) {
 void acoral_infos_send() {
     static acoral_u32 symbel = 0;
     acoral_u32 print_num;
-    thread_info_set *tinfos_tmp;
-    thread_switch_info_set *tswinfos_tmp;
-    tinfos_tmp = (thread_info_set *)acoral_vol_malloc(sizeof(thread_info_set));
-    tswinfos_tmp = (thread_switch_info_set *)acoral_vol_malloc(sizeof(thread_switch_info_set));
-
-
-    acoral_enter_critical();
-//    acoral_spin_lock(&tinfos_lock);
-//    acoral_spin_lock(&tswinfos_lock);
-    *tinfos_tmp = *tinfos;
-    *tswinfos_tmp = *tswinfos;
-    tinfos -> size = 0;
-    tinfos -> st_idx = 0;
-    tinfos -> ed_idx = 0;
-    tswinfos -> size = 0;
-    tswinfos -> st_idx = 0;
-    tswinfos -> ed_idx = 0;
-//    acoral_spin_unlock(&tswinfos_lock);
-//    acoral_spin_unlock(&tinfos_lock);
-    acoral_exit_critical();
-
 
     // 发送核心的相关信息
     if (symbel == 0) {
@@ -226,41 +443,31 @@ void acoral_infos_send() {
         header.type = 1;
         header.length = sizeof(CPUcore_info);
         CPUcore_info * CPUcore_info_tmp = (CPUcore_info *)acoral_vol_malloc(sizeof(CPUcore_info));
-        CPUcore_info_tmp -> id = 0;
         CPUcore_info_tmp -> cpuFrequency = 666000000;
-        acoral_str_cpy(&(CPUcore_info_tmp -> name[0]), "CPU 0");
-
-        acoral_bytes_send((char *)CPUcore_info_tmp, sizeof(CPUcore_info));
-        CPUcore_info_tmp -> id = 1;
-        acoral_str_cpy(&(CPUcore_info_tmp -> name[0]), "CPU 1");
-        acoral_bytes_send((char *)CPUcore_info_tmp, sizeof(CPUcore_info));
+        for (int i = 0; i < CFG_MAX_CPU; i++) {
+            CPUcore_info_tmp -> id = i;
+            acoral_str_cpy(&(CPUcore_info_tmp -> name[0]), i == 0 ? "CPU 0" : "CPU 1");
+            acoral_bytes_send((char *)CPUcore_info_tmp, sizeof(CPUcore_info));
+        }
         acoral_vol_free(CPUcore_info_tmp);
 
     }
     // 发送线程创建相关信息
-    if(tinfos_tmp -> size > 0) {
-        // 编码数据
-        header.type = 2;
-        header.length = sizeof(thread_info);
-        print_num = tinfos_tmp -> overflow > 0?  tinfos_tmp -> total_size:tinfos_tmp -> size;
-        for(int i = 0; i< print_num; i++) {
-            acoral_bytes_send((char *)(&(tinfos_tmp -> threads[i])) , sizeof(thread_info));
-        }
-        // 按字节发送数据
+    print_num = acoral_tinfos_take();
+    header.type = 2;
+    header.length = sizeof(thread_info);
+    for(int i = 0; i < print_num; i++) {
+        acoral_bytes_send((char *)(&tinfos_buf[i]), sizeof(thread_info));
     }
-    // 发送线程切换信息
-    if(tswinfos_tmp -> size > 0) {
-        // 编码数据
-        header.type = 3;
-        header.length = sizeof(thread_switch_info);
-        print_num = tswinfos_tmp -> overflow > 0?  tswinfos_tmp -> total_size:tswinfos_tmp -> size;
-        for(int i = 0; i< print_num; i++) {
-            acoral_bytes_send((char *)(&(tswinfos_tmp -> switch_infos[i])) , sizeof(thread_switch_info));
+    // 发送各cpu的追踪记录，每条记录的cpu字段标明来源
+    header.type = 3;
+    header.length = sizeof(acoral_trace_rec_t);
+    for(int cpu = 0; cpu < CFG_MAX_CPU; cpu++) {
+        print_num = acoral_trace_read(cpu, trace_buf, CFG_TRACE_RING_SIZE, NULL);
+        for(int i = 0; i < print_num; i++) {
+            acoral_bytes_send((char *)(&trace_buf[i]), sizeof(acoral_trace_rec_t));
         }
-        // 按字节发送数据
     }
-    acoral_vol_free(tinfos_tmp);
-    acoral_vol_free(tswinfos_tmp);
 }
 
 
@@ -278,93 +485,42 @@ void acoral_infos_send() {
 //    }
       acoral_print("monitor start");
 
-    acoral_u32 print_num;
-    thread_info_set *tinfos_tmp;
-    thread_switch_info_set *tswinfos_tmp;
-    tinfos_tmp = (thread_info_set *)acoral_vol_malloc(sizeof(thread_info_set));
-    tswinfos_tmp = (thread_switch_info_set *)acoral_vol_malloc(sizeof(thread_switch_info_set));
-
-
-    acoral_enter_critical();
-//    acoral_spin_lock(&tinfos_lock);
-//    acoral_spin_lock(&tswinfos_lock);
-    *tinfos_tmp = *tinfos;
-    *tswinfos_tmp = *tswinfos;
-    tinfos -> size = 0;
-    tinfos -> st_idx = 0;
-    tinfos -> ed_idx = 0;
-    tswinfos -> size = 0;
-    tswinfos -> st_idx = 0;
-    tswinfos -> ed_idx = 0;
-
-//    acoral_spin_unlock(&tswinfos_lock);
-//    acoral_spin_unlock(&tinfos_lock);
-    acoral_exit_critical();
-    acoral_print("指针大小: %d \r\n", sizeof(thread_switch_info_set));
-    if(tinfos_tmp -> size > 0) {
+    acoral_u32 print_num, lost;
+    print_num = acoral_tinfos_take();
+    if(print_num > 0) {
         acoral_print("打印线程创建信息 \r\n");
-        acoral_print("创建线程: %d 条目 \r\n", tinfos_tmp -> size);
-        print_num = tinfos_tmp -> overflow > 0?  tinfos_tmp -> total_size:tinfos_tmp -> size;
+        acoral_print("创建线程: %d 条目 \r\n", print_num);
         for(int i = 0; i< print_num; i++) {
-//            acoral_print(
-//                    "线程策略: %d, 优先级: %d, cpu: %d, 创建时间:%d 名称: %s \r\n",
-//                    tinfos_tmp -> threads[i].thread_policy,
-//                    tinfos_tmp -> threads[i].prio,
-//                    tinfos_tmp -> threads[i].cpu,
-//                    tinfos_tmp -> threads[i].create_tick,
-//                    &(tinfos_tmp -> threads[i].thread_name[0])
-//            );
             acoral_print(
                     "TCB: %x, 线程策略: %d, 优先级: %d, cpu: %d, 创建时间:%d 名称: %s \r\n",
-                    tinfos_tmp -> threads[i].tcb_ptr,
-                    tinfos_tmp -> threads[i].thread_policy,
-                    tinfos_tmp -> threads[i].prio,
-                    tinfos_tmp -> threads[i].cpu,
-                    tinfos_tmp -> threads[i].create_tick,
-                    &(tinfos_tmp -> threads[i].thread_name[0])
+                    tinfos_buf[i].tcb_ptr,
+                    tinfos_buf[i].thread_policy,
+                    tinfos_buf[i].prio,
+                    tinfos_buf[i].cpu,
+                    tinfos_buf[i].create_tick,
+                    &(tinfos_buf[i].thread_name[0])
             );
         }
 
     } else {
         acoral_print("没有线程创建信息 \r\n");
     }
-    if(tswinfos_tmp -> size > 0) {
-            acoral_print("打印线程切换信息 \r\n");
-            acoral_print("切换线程: %d 条目 \r\n", tswinfos_tmp -> size);
-            print_num = tswinfos_tmp -> overflow > 0?  tswinfos_tmp -> total_size:tswinfos_tmp -> size;
-            for(int i = 0; i< print_num; i++) {
-//                acoral_print(
-//                        "cpu: %d, 发生时间:%d, from: %s, to: %s \r\n",
-//                        tswinfos_tmp -> switch_infos[i].cpu,
-//                        tswinfos_tmp -> switch_infos[i].tick,
-//                        &(tswinfos_tmp -> switch_infos[i].from_name[0]),
-//                        &(tswinfos_tmp -> switch_infos[i].to_name[0])
-//                );
-                acoral_print(
-                            "cpu: %d, 发生时间:%d, from: %x, to: %x \r\n",
-                            tswinfos_tmp -> switch_infos[i].cpu,
-                            tswinfos_tmp -> switch_infos[i].tick,
-                            tswinfos_tmp -> switch_infos[i].from_tcb,
-                            tswinfos_tmp -> switch_infos[i].to_tcb
-                    );
-//                acoral_print(
-//                            "cpu: %d, 发生时间:%d, from: %x : %s, to: %x : %s \r\n",
-//                            tswinfos_tmp -> switch_infos[i].cpu,
-//                            tswinfos_tmp -> switch_infos[i].tick,
-//                            tswinfos_tmp -> switch_infos[i].from_tcb,
-//                            &(tswinfos_tmp -> switch_infos[i].from_name[0]),
-//                            tswinfos_tmp -> switch_infos[i].to_tcb,
-//                            &(tswinfos_tmp -> switch_infos[i].to_name[0])
-//                    );
-            }
-
-
-    } else {
-        acoral_print("没有打印线程切换信息 \r\n");
+    for(int cpu = 0; cpu < CFG_MAX_CPU; cpu++) {
+        print_num = acoral_trace_read(cpu, trace_buf, CFG_TRACE_RING_SIZE, &lost);
+        acoral_print("cpu %d 追踪记录: %d 条目, 丢失: %d \r\n", cpu, print_num, lost);
+        for(int i = 0; i< print_num; i++) {
+            acoral_print(
+                        "cycles: %x:%x, 事件: %x, arg: %x %x %x \r\n",
+                        (acoral_u32)(trace_buf[i].ts >> 32),
+                        (acoral_u32)trace_buf[i].ts,
+                        trace_buf[i].type,
+                        trace_buf[i].arg0,
+                        trace_buf[i].arg1,
+                        trace_buf[i].arg2
+                );
+        }
     }
-    acoral_vol_free(tinfos_tmp);
-    acoral_vol_free(tswinfos_tmp);
 }
 
 #endif
-
+#endif
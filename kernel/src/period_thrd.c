@@ -2,8 +2,8 @@
  * @file period_thrd.c
  * @author 胡博文 (@921576434@qq.com)
  * @brief kernel层周期线程策略相关源文件
- * @version 1.1
- * @date 2022-09-26
+ * @version 1.2
+ * @date 2026-10-19
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -12,6 +12,9 @@
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-13 <td>增加注释
  *         <tr><td>v1.1 <td>胡博文 <td>2022-09-26 <td>错误头文件相关改动
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>周期统计与截止期错失处理
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>统计报告先复制再打印
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>报告复制线程名字而不是指针
  */
 #include <type.h>
 #include <queue.h>
@@ -21,13 +24,21 @@
 #include <policy.h>
 #include <mem.h>
 #include <timer.h>
+#include <clock.h>
+#include <ipc.h>
+#include <res_pool.h>
 #include <period_thrd.h>
 #include <print.h>
+#include <str.h>
 #include <error.h>
 ///周期线程策略结构体实例
 acoral_sched_policy_t period_policy;
 ///周期线程队列
 acoral_queue_t period_time_queue;
+///延时队列
+extern acoral_queue_t time_delay_queue;
+///周期统计与实例状态锁
+static acoral_spinlock_t period_stat_lock;
 
 /**
  * @brief 周期线程私有数据结构体
@@ -37,8 +48,26 @@ typedef struct{
     acoral_time time;///<周期时间
     void (*route)(void *args);///<线程运行函数
     void *args;///<传递参数
+    acoral_u8 active;///<当前实例已释放且未完成
+    acoral_u8 missed;///<当前实例已记为截止期错失
+    acoral_u8 miss_mode;///<截止期错失处理方式
+    acoral_id supervisor_id;///<监督线程id
+    acoral_u64 period_cycles;///<周期对应的时钟周期数
+    acoral_u64 nominal_cycles;///<最近一次名义释放时刻
+    acoral_u64 release_cycles;///<当前实例的名义释放时刻
+    acoral_period_stat_t stat;///<统计数据
 }period_private_data_t;
 
+/**
+ * @brief 统计报告中的一个周期线程
+ *
+ */
+typedef struct{
+    acoral_char name[ACORAL_REPORT_NAME_LEN];///<名字，复制一份，打印时线程可能已被回收
+    acoral_id id;///<线程id
+    acoral_period_stat_t stat;///<统计数据
+}period_stat_entry_t;
+
 /**
  * @brief 周期队列添加节点
  * 
@@ -72,12 +101,106 @@ static void period_thread_reload(acoral_thread_t* thread)
     acoral_period_time_queue_add(thread);//添加进周期队列
 }
 /**
- * @brief 周期线程退出函数
+ * @brief 统计数据清零
+ *
+ * @param stat 统计数据
+ */
+static void period_stat_clear(acoral_period_stat_t *stat)
+{
+    stat->releases=0;
+    stat->completions=0;
+    stat->misses=0;
+    stat->overruns=0;
+    stat->aborts=0;
+    stat->response_max=0;
+    stat->response_avg=0;
+    stat->response_total=0;
+    stat->jitter_max=0;
+}
+
+/**
+ * @brief 使阻塞中的周期线程脱离延时队列和ipc等待队列，用于中止实例
+ *
+ * @param thread 线程tcb指针
+ */
+static void period_thread_unblock(acoral_thread_t *thread)
+{
+    acoral_ipc_t *ipc=thread->ipc;
+    if(!acoral_list_empty(&thread->delaying))
+        acoral_tick_queue_del(&time_delay_queue, &thread->delaying);
+    if(ipc!=NULL)
+    {
+#ifdef CFG_SMP
+        acoral_spin_lock(&ipc->lock);
+#endif
+        acoral_ipc_wait_queue_del(ipc, thread);
+#ifdef CFG_SMP
+        acoral_spin_unlock(&ipc->lock);
+#endif
+    }
+}
+
+/**
+ * @brief 周期线程实例入口，记录开始执行时刻后调用线程运行函数
+ *
+ * @param args 未使用
+ */
+static void period_thread_entry(void *args)
+{
+    acoral_thread_t *thread=acoral_cur_thread;
+    period_private_data_t *private_data=thread->private_data;
+    acoral_u64 start=acoral_clock_cycles();
+    acoral_u64 jitter;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&period_stat_lock);
+#endif
+    if(private_data->active&&ACORAL_CLOCK_AFTER(start,private_data->release_cycles))
+    {
+        jitter=acoral_cycles_to_ns(start-private_data->release_cycles);
+        if(jitter>private_data->stat.jitter_max)
+            private_data->stat.jitter_max=jitter;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&period_stat_lock);
+#endif
+    acoral_exit_critical();
+    private_data->route(private_data->args);
+}
+
+/**
+ * @brief 周期线程退出函数，记录实例完成
  * 
  */
 static void period_thread_exit()
 {
-    acoral_suspend_self();
+    acoral_thread_t *thread=acoral_cur_thread;
+    period_private_data_t *private_data=thread->private_data;
+    acoral_u64 now=acoral_clock_cycles();
+    acoral_u64 response;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&period_stat_lock);
+#endif
+    if(private_data->active)//被中止的实例不计入完成
+    {
+        private_data->active=0;
+        response=acoral_cycles_to_ns(now-private_data->release_cycles);
+        private_data->stat.completions++;
+        private_data->stat.response_total+=response;
+        if(response>private_data->stat.response_max)
+            private_data->stat.response_max=response;
+        if(!private_data->missed&&response>(acoral_u64)private_data->time*1000000)//完成时已超过截止期
+        {
+            private_data->missed=1;
+            private_data->stat.misses++;
+        }
+    }
+    acoral_suspend_self();//在锁内挂起，周期处理看到实例已完成时线程一定已挂起
+#ifdef CFG_SMP
+    acoral_spin_unlock(&period_stat_lock);
+#endif
+    acoral_exit_critical();
 }
 /**
  * @brief 周期线程初始化
@@ -116,10 +239,16 @@ static acoral_id period_policy_thread_init(acoral_thread_t *thread,void (*route)
         private_data->time=policy_data->time;
         private_data->route=route;
         private_data->args=args;
+        private_data->active=0;
+        private_data->missed=0;
+        private_data->miss_mode=ACORAL_PERIOD_MISS_SKIP;
+        private_data->supervisor_id=-1;
+        private_data->period_cycles=acoral_ns_to_cycles((acoral_u64)policy_data->time*1000000);
+        period_stat_clear(&private_data->stat);
         thread->private_data=private_data;
         thread->cpu_mask=-1;
     }
-    if((err = acoral_thread_init(thread,route,period_thread_exit,args))!=KR_OK)//通用线程初始化
+    if((err = acoral_thread_init(thread,period_thread_entry,period_thread_exit,NULL))!=KR_OK)//通用线程初始化
     {
         acoral_printerr("No thread stack:%s\n",thread->name);
         acoral_enter_critical();
@@ -128,7 +257,19 @@ static acoral_id period_policy_thread_init(acoral_thread_t *thread,void (*route)
         return err;
     }
     thread->data = data;
+    private_data=thread->private_data;
     acoral_enter_critical();
+    //第一个实例在创建时释放
+#ifdef CFG_SMP
+    acoral_spin_lock(&period_stat_lock);
+#endif
+    private_data->nominal_cycles=acoral_clock_cycles();
+    private_data->release_cycles=private_data->nominal_cycles;
+    private_data->active=1;
+    private_data->stat.releases++;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&period_stat_lock);
+#endif
     //装载周期线程
     period_thread_reload(thread);
     acoral_exit_critical();
@@ -161,6 +302,7 @@ static void period_time_deal()
     acoral_list_t *tmp,*tmp1,*head;
     acoral_thread_t * thread;
     period_private_data_t * private_data;
+    acoral_u8 release,abort,notify;
 #if (MEASURE_SCHED_PERIOD == 1)
     acoral_u8 is_valid_measure = 0;
     // #error "hihihi"
@@ -180,10 +322,49 @@ static void period_time_deal()
         tmp1 = tmp->next;
         acoral_period_queue_del(thread);//从队列中删除要被唤醒的线程
         tmp = tmp1;
-        if(thread->state&ACORAL_THREAD_STATE_SUSPEND)
+        release=0;
+        abort=0;
+        notify=0;
+#ifdef CFG_SMP
+        acoral_spin_lock(&period_stat_lock);
+#endif
+        private_data->nominal_cycles+=private_data->period_cycles;
+        if(private_data->active)//上一实例未完成，截止期错失
+        {
+            private_data->stat.overruns++;
+            if(!private_data->missed)
+            {
+                private_data->missed=1;
+                private_data->stat.misses++;
+            }
+            if(private_data->miss_mode&ACORAL_PERIOD_MISS_ABORT)
+            {
+                private_data->active=0;
+                private_data->stat.aborts++;
+                abort=1;
+            }
+            if(private_data->miss_mode&ACORAL_PERIOD_MISS_NOTIFY)
+                notify=1;
+        }
+        else if(thread->state&ACORAL_THREAD_STATE_SUSPEND)
+            release=1;
+        else//被中止的实例还未挂起，本次释放丢失
+            private_data->stat.overruns++;
+#ifdef CFG_SMP
+        acoral_spin_unlock(&period_stat_lock);
+#endif
+        if(abort)
+        {
+            if(thread->state&ACORAL_THREAD_STATE_SUSPEND)//阻塞中的实例直接重新释放
+            {
+                period_thread_unblock(thread);
+                release=1;
+            }
+            else//运行或就绪中的实例挂起，下个周期重新释放
+                acoral_suspend_thread(thread);
+        }
+        if(release)
         {
-//        	if(thread->ipc == NULL)//能让周期线程阻塞于ipc的时候不自动就绪
-//        	{
             //处理钩子函数
 #if (MEASURE_SCHED_PERIOD == 1)
             is_valid_measure = 1;
@@ -191,10 +372,21 @@ static void period_time_deal()
             if(thread->hook.deal_hook!=NULL)
                 thread->hook.deal_hook(thread);
 			thread->stack=(acoral_u32 *)((acoral_8 *)thread->stack_buttom+thread->stack_size-4);
-			HAL_STACK_INIT(&thread->stack,private_data->route,period_thread_exit,private_data->args);
+			HAL_STACK_INIT(&thread->stack,period_thread_entry,period_thread_exit,NULL);
+#ifdef CFG_SMP
+            acoral_spin_lock(&period_stat_lock);
+#endif
+            private_data->active=1;
+            private_data->missed=0;
+            private_data->release_cycles=private_data->nominal_cycles;
+            private_data->stat.releases++;
+#ifdef CFG_SMP
+            acoral_spin_unlock(&period_stat_lock);
+#endif
 			acoral_rdy_thread(thread);
-//        	}
         }
+        if(notify&&private_data->supervisor_id>=0)//通知监督线程
+            acoral_rdy_thread_by_id(private_data->supervisor_id);
         period_thread_reload(thread);//重装载被唤醒的线程
     }
 
@@ -215,6 +407,7 @@ static void period_time_deal()
 void period_policy_init(void)
 {
     acoral_tick_queue_init(&period_time_queue);//初始化周期队列
+    acoral_spin_init(&period_stat_lock);
     period_policy.type=ACORAL_SCHED_POLICY_PERIOD;
     period_policy.policy_thread_init=period_policy_thread_init;
     period_policy.policy_thread_release=period_policy_thread_release;
@@ -222,3 +415,158 @@ void period_policy_init(void)
     period_policy.name="period";
     acoral_register_sched_policy(&period_policy);//注册策略
 }
+
+/**
+ * @brief 根据id获取周期线程
+ *
+ * @param thread_id 线程id
+ * @return acoral_thread_t* 线程tcb指针，不是周期线程时为NULL
+ */
+static acoral_thread_t *period_thread_get(acoral_id thread_id)
+{
+    acoral_thread_t *thread=(acoral_thread_t *)acoral_get_res_by_id(thread_id);
+    if(thread==NULL||thread->policy!=ACORAL_SCHED_POLICY_PERIOD||thread->private_data==NULL)
+        return NULL;
+    return thread;
+}
+
+/**
+ * @brief 获取周期线程统计数据
+ *
+ * @param thread_id 线程id
+ * @param stat 统计数据输出
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_period_stat_get(acoral_id thread_id, acoral_period_stat_t *stat)
+{
+    acoral_thread_t *thread;
+    period_private_data_t *private_data;
+    if(stat==NULL)
+        return KR_POLICY_ERR_NULL;
+    thread=period_thread_get(thread_id);
+    if(thread==NULL)
+        return KR_POLICY_ERR_THREAD;
+    private_data=thread->private_data;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&period_stat_lock);
+#endif
+    *stat=private_data->stat;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&period_stat_lock);
+#endif
+    acoral_exit_critical();
+    if(stat->completions)
+        stat->response_avg=stat->response_total/stat->completions;
+    return KR_OK;
+}
+
+/**
+ * @brief 周期线程统计数据清零
+ *
+ * @param thread_id 线程id
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_period_stat_reset(acoral_id thread_id)
+{
+    acoral_thread_t *thread;
+    period_private_data_t *private_data;
+    thread=period_thread_get(thread_id);
+    if(thread==NULL)
+        return KR_POLICY_ERR_THREAD;
+    private_data=thread->private_data;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&period_stat_lock);
+#endif
+    period_stat_clear(&private_data->stat);
+#ifdef CFG_SMP
+    acoral_spin_unlock(&period_stat_lock);
+#endif
+    acoral_exit_critical();
+    return KR_OK;
+}
+
+/**
+ * @brief 设置周期线程截止期错失处理方式
+ *
+ * @param thread_id 线程id
+ * @param mode 处理方式，ACORAL_PERIOD_MISS_SKIP或ACORAL_PERIOD_MISS_ABORT，可或上ACORAL_PERIOD_MISS_NOTIFY
+ * @param supervisor_id 监督线程id，错失时被就绪，不通知时可为-1
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_period_set_miss_handler(acoral_id thread_id, acoral_u8 mode, acoral_id supervisor_id)
+{
+    acoral_thread_t *thread;
+    period_private_data_t *private_data;
+    thread=period_thread_get(thread_id);
+    if(thread==NULL)
+        return KR_POLICY_ERR_THREAD;
+    if((mode&ACORAL_PERIOD_MISS_NOTIFY)&&acoral_get_res_by_id(supervisor_id)==NULL)
+        return KR_POLICY_ERR_NULL;
+    private_data=thread->private_data;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&period_stat_lock);
+#endif
+    private_data->miss_mode=mode;
+    private_data->supervisor_id=supervisor_id;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&period_stat_lock);
+#endif
+    acoral_exit_critical();
+    return KR_OK;
+}
+
+/**
+ * @brief 打印全部周期线程的统计数据，时间单位为us
+ *
+ */
+void acoral_period_stat_report(void)
+{
+    static period_stat_entry_t entry[CFG_MAX_THREAD];//不放在调用者栈上，shell栈较小
+    acoral_list_t *tmp,*head;
+    acoral_thread_t *thread;
+    period_private_data_t *private_data;
+    acoral_period_stat_t *stat;
+    acoral_u32 num=0,i;
+    head=&acoral_threads_queue.head;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&acoral_threads_queue.lock);
+#endif
+    for(tmp=head->next;tmp!=head&&num<CFG_MAX_THREAD;tmp=tmp->next)//持锁时只复制，打印放到放锁之后
+    {
+        thread=list_entry(tmp,acoral_thread_t,global_list);
+        if(thread->policy!=ACORAL_SCHED_POLICY_PERIOD||thread->private_data==NULL)
+            continue;
+        private_data=thread->private_data;
+        acoral_str_lcpy(entry[num].name,thread->name,sizeof(entry[num].name));
+        entry[num].id=thread->res.id;
+#ifdef CFG_SMP
+        acoral_spin_lock(&period_stat_lock);
+#endif
+        entry[num].stat=private_data->stat;
+#ifdef CFG_SMP
+        acoral_spin_unlock(&period_stat_lock);
+#endif
+        num++;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&acoral_threads_queue.lock);
+#endif
+    acoral_exit_critical();
+    acoral_print("%-20s%6s%8s%8s%6s%6s%6s%9s%9s%9s\r\n",
+                 "name","id","release","finish","miss","over","abort","rmax","ravg","jitter");
+    for(i=0;i<num;i++)
+    {
+        stat=&entry[i].stat;
+        if(stat->completions)
+            stat->response_avg=stat->response_total/stat->completions;
+        acoral_print("%-20s%6d%8u%8u%6u%6u%6u%9u%9u%9u\r\n",
+                     entry[i].name,entry[i].id,stat->releases,stat->completions,
+                     stat->misses,stat->overruns,stat->aborts,
+                     (acoral_u32)(stat->response_max/1000),(acoral_u32)(stat->response_avg/1000),
+                     (acoral_u32)(stat->jitter_max/1000));
+    }
+}
@@ -0,0 +1,295 @@
+/**
+ * @file pmu.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层性能计数器统计源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>线程切换时累计PMU计数，溢出中断采样
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>读取时检查线程迁移；报告先复制再打印
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>报告复制线程名字而不是指针
+ */
+#include <acoral.h>
+
+#ifdef CFG_PMU
+///计数项在使能、溢出、中断寄存器中的位，第0项为cycle计数器
+#define PMU_BIT(i) ((i)==0?HAL_PMU_CYCLES_BIT:HAL_PMU_EVENT_BIT((i)-1))
+
+/**
+ * @brief 每cpu PMU状态，计数累加只由所在cpu关中断进行，前后各加一次序号，读取者序号变化时重读
+ *
+ */
+typedef struct{
+    volatile acoral_u32 seq;///<写入序号，奇数表示正在写入
+    acoral_u32 num;///<使用的事件个数，0表示只统计cycle
+    acoral_u32 sample;///<采样计数项
+    acoral_u32 last[ACORAL_PMU_COUNT_NUM];///<各计数项上次累加时的硬件计数值
+}__attribute__((aligned(ACORAL_CACHE_LINE_SIZE))) pmu_cpu_t;
+
+/**
+ * @brief 报告中的一个线程
+ *
+ */
+typedef struct{
+    acoral_char name[ACORAL_REPORT_NAME_LEN];///<名字，复制一份，打印时线程可能已被回收
+    acoral_id id;///<线程id
+    acoral_u32 cpu;///<所在cpu
+    acoral_pmu_count_t count;///<性能计数
+}pmu_entry_t;
+
+///各cpu PMU状态
+static pmu_cpu_t pmu_cpu[CFG_MAX_CPU];
+///配置的事件号
+static const acoral_u32 pmu_events[CFG_PMU_EVENT_NUM]=CFG_PMU_EVENTS;
+
+/**
+ * @brief 读取一个计数项的硬件计数值
+ *
+ * @param i 计数项
+ * @return acoral_u32 计数值
+ */
+static acoral_u32 pmu_counter_read(acoral_u32 i)
+{
+    return i==0?HAL_PMU_CYCLES_READ():HAL_PMU_EVENT_READ(i-1);
+}
+
+/**
+ * @brief 写入一个计数项的硬件计数值
+ *
+ * @param i 计数项
+ * @param value 计数值
+ */
+static void pmu_counter_write(acoral_u32 i, acoral_u32 value)
+{
+    if(i==0)
+        HAL_PMU_CYCLES_WRITE(value);
+    else
+        HAL_PMU_EVENT_WRITE(i-1,value);
+}
+
+/**
+ * @brief 把上次累加以来的计数累加到线程上，调用者关中断且处于写入中
+ *
+ * 计数器为32位，溢出中断保证两次累加之间不会绕回一圈以上
+ *
+ * @param pc 本cpu PMU状态
+ * @param thread 正在运行的线程
+ */
+static void pmu_flush(pmu_cpu_t *pc, acoral_thread_t *thread)
+{
+    acoral_u32 i,now;
+    for(i=0;i<=pc->num;i++)
+    {
+        now=pmu_counter_read(i);
+        if(thread!=NULL)
+            thread->pmu_count[i]+=now-pc->last[i];
+        pc->last[i]=now;
+    }
+}
+
+/**
+ * @brief 线程切换时累加计数，在切换上下文时调用
+ *
+ * @param prev 被换出的线程
+ */
+void acoral_pmu_switch(acoral_thread_t *prev)
+{
+    acoral_u32 flags=acoral_intr_save();
+    pmu_cpu_t *pc=&pmu_cpu[acoral_current_cpu];
+    pc->seq++;
+    acoral_dmb();
+    pmu_flush(pc,prev);
+    acoral_dmb();
+    pc->seq++;
+    acoral_intr_restore_flags(flags);
+}
+
+/**
+ * @brief PMU溢出中断服务函数，先累加计数，采样计数器溢出时给正在运行的线程记一次采样并重新装载
+ *
+ * @param data 未使用
+ */
+static void pmu_overflow_handler(void *data)
+{
+    acoral_u32 flags=acoral_intr_save();
+    pmu_cpu_t *pc=&pmu_cpu[acoral_current_cpu];
+    acoral_thread_t *cur=acoral_cur_thread;
+    acoral_u32 overflow=HAL_PMU_OVERFLOW_CLEAR();
+    pc->seq++;
+    acoral_dmb();
+    pmu_flush(pc,cur);
+    if(CFG_PMU_SAMPLE_PERIOD!=0&&(overflow&PMU_BIT(pc->sample)))
+    {
+        cur->pmu_samples++;
+        //累加与重新装载之间的少量计数会丢失
+        pc->last[pc->sample]=-(acoral_u32)CFG_PMU_SAMPLE_PERIOD;
+        pmu_counter_write(pc->sample,pc->last[pc->sample]);
+    }
+    acoral_dmb();
+    pc->seq++;
+    acoral_intr_restore_flags(flags);
+}
+
+/**
+ * @brief 本核PMU初始化，每个核启动调度前调用，硬件事件计数器不足时只统计cycle
+ *
+ */
+void acoral_pmu_cpu_init(void)
+{
+    acoral_u32 cpu=acoral_current_cpu;
+    pmu_cpu_t *pc=&pmu_cpu[cpu];
+    acoral_u32 i,mask=0;
+    if(HAL_PMU_INIT()>=CFG_PMU_EVENT_NUM)
+        pc->num=CFG_PMU_EVENT_NUM;
+    else
+        pc->num=0;
+    pc->sample=pc->num?CFG_PMU_SAMPLE_COUNTER:0;
+    for(i=0;i<pc->num;i++)
+        HAL_PMU_EVENT_SET(i,pmu_events[i]);
+    for(i=0;i<=pc->num;i++)
+    {
+        if(CFG_PMU_SAMPLE_PERIOD!=0&&i==pc->sample)
+            pmu_counter_write(i,-(acoral_u32)CFG_PMU_SAMPLE_PERIOD);
+        pc->last[i]=pmu_counter_read(i);
+        mask|=PMU_BIT(i);
+    }
+    //所有计数项都开溢出中断，保证32位计数器绕回前累加
+    acoral_intr_callback_register(cpu,HAL_PMU_IRQ(cpu),pmu_overflow_handler,NULL);
+    XScuGic_InterruptMaptoCpu(&int_ctrl[cpu],cpu,HAL_PMU_IRQ(cpu));
+    acoral_intr_enable_by_id(cpu,HAL_PMU_IRQ(cpu));
+    HAL_PMU_INTR_ENABLE(mask);
+    HAL_PMU_COUNTER_ENABLE(mask);
+    if(pc->num==0&&CFG_PMU_EVENT_NUM!=0)
+        acoral_print("cpu%d pmu: no event counters, cycles only\r\n",cpu);
+}
+
+/**
+ * @brief 获取cpu使用的事件个数
+ *
+ * @param cpu cpu号
+ * @return acoral_u32 事件个数，0表示只统计cycle
+ */
+acoral_u32 acoral_pmu_event_num(acoral_u32 cpu)
+{
+    if(cpu>=CFG_MAX_CPU)
+        return 0;
+    return pmu_cpu[cpu].num;
+}
+
+/**
+ * @brief 获取第idx个事件的事件号
+ *
+ * @param idx 事件序号，从1开始，与计数项对应
+ * @return acoral_u32 事件号，idx无效时为0
+ */
+acoral_u32 acoral_pmu_event(acoral_u32 idx)
+{
+    if(idx==0||idx>CFG_PMU_EVENT_NUM)
+        return 0;
+    return pmu_events[idx-1];
+}
+
+/**
+ * @brief 获取线程的累计性能计数
+ *
+ * PMU只能由本核读取，线程正在本核运行时包含到此刻的计数，正在其他核运行时只到上次切换或溢出。
+ * 线程的计数只由它所在cpu累加，序号按所在cpu检查；读取期间线程迁移到其他cpu时按新cpu重读
+ *
+ * @param thread 线程tcb指针
+ * @param count 返回计数
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_pmu_thread_get(acoral_thread_t *thread, acoral_pmu_count_t *count)
+{
+    acoral_u32 flags,seq,cpu,i;
+    pmu_cpu_t *pc;
+    if(thread==NULL||count==NULL)
+        return KR_STAT_ERR_NULL;
+    flags=acoral_intr_save();
+    if(thread==acoral_cur_thread)
+    {
+        pc=&pmu_cpu[acoral_current_cpu];
+        pc->seq++;
+        acoral_dmb();
+        pmu_flush(pc,thread);
+        acoral_dmb();
+        pc->seq++;
+    }
+    acoral_intr_restore_flags(flags);
+    while(1)
+    {
+        cpu=thread->cpu;
+        if(cpu>=CFG_MAX_CPU)
+            return KR_STAT_ERR_CPU;
+        pc=&pmu_cpu[cpu];
+        seq=pc->seq;
+        acoral_dmb();
+        if(seq&1)
+            continue;
+        for(i=0;i<ACORAL_PMU_COUNT_NUM;i++)
+            count->count[i]=thread->pmu_count[i];
+        count->samples=thread->pmu_samples;
+        acoral_dmb();
+        if(pc->seq==seq&&thread->cpu==cpu)//迁移后由新cpu累加，旧cpu的序号不能保证读取完整
+            break;
+    }
+    return KR_OK;
+}
+
+/**
+ * @brief 打印各线程的累计性能计数，单位为千次
+ *
+ */
+void acoral_pmu_report(void)
+{
+    static pmu_entry_t entry[CFG_MAX_THREAD];//不放在调用者栈上，shell栈较小
+    acoral_list_t *tmp,*head;
+    acoral_thread_t *thread;
+    acoral_u32 cpu,num=0,i,j;
+    for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+    {
+        acoral_print("cpu%u:",cpu);
+        if(pmu_cpu[cpu].num==0)
+            acoral_print(" cycles only");
+        for(i=1;i<=pmu_cpu[cpu].num;i++)
+            acoral_print(" ev%u=0x%02x",i,acoral_pmu_event(i));
+        acoral_print(", sample every %u of %s%u\r\n",CFG_PMU_SAMPLE_PERIOD,
+                     pmu_cpu[cpu].sample?"ev":"cycles",pmu_cpu[cpu].sample);
+    }
+    head=&acoral_threads_queue.head;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&acoral_threads_queue.lock);
+#endif
+    for(tmp=head->next;tmp!=head&&num<CFG_MAX_THREAD;tmp=tmp->next)//持锁时只复制，打印放到放锁之后
+    {
+        thread=list_entry(tmp,acoral_thread_t,global_list);
+        if(acoral_pmu_thread_get(thread,&entry[num].count)!=KR_OK)
+            continue;
+        acoral_str_lcpy(entry[num].name,thread->name,sizeof(entry[num].name));
+        entry[num].id=thread->res.id;
+        entry[num].cpu=thread->cpu;
+        num++;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&acoral_threads_queue.lock);
+#endif
+    acoral_exit_critical();
+    acoral_print("%-20s%6s%5s%12s","name","id","cpu","kcycles");
+    for(i=1;i<ACORAL_PMU_COUNT_NUM;i++)
+        acoral_print("%9s%u","kev",i);
+    acoral_print("%10s\r\n","samples");
+    for(j=0;j<num;j++)
+    {
+        acoral_print("%-20s%6d%5u%12u",entry[j].name,entry[j].id,entry[j].cpu,(acoral_u32)(entry[j].count.count[0]/1000));
+        for(i=1;i<ACORAL_PMU_COUNT_NUM;i++)
+            acoral_print("%10u",(acoral_u32)(entry[j].count.count[i]/1000));
+        acoral_print("%10u\r\n",entry[j].count.samples);
+    }
+}
+#endif
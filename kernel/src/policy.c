@@ -12,6 +12,9 @@
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-14 <td>增加注释
  *         <tr><td>v1.1 <td>胡博文 <td>2022-09-26 <td>错误头文件相关改动
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>优先从线程回收缓存创建线程
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>线程创建事件追踪，创建失败时不记录
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>策略初始化前分配追踪线程号
  */
 #include <type.h>
 #include <hal.h>
@@ -21,9 +24,11 @@
 #include <policy.h>
 #include <print.h>
 #include <error.h>
+#include <mem.h>
 #ifdef CFG_TRACE_THREADS_SWITCH_ENABLE
 #include <monitor.h>
 #endif
+#include <trace.h>
 ///策略队列
 acoral_queue_t policy_queue;
 
@@ -91,23 +96,34 @@ static acoral_id acoral_policy_thread_init(acoral_u32 policy_type,acoral_thread_
  */
 acoral_id create_thread_by_policy(void (*route)(void *args),acoral_u32 stack_size,void *args,acoral_char *name,void *stack,acoral_u32 policy_type,void *p_data,void *data, acoral_thread_hook_t *hook)
 {
-#ifdef CFG_TRACE_THREADS_SWITCH_ENABLE
     acoral_id ret_id;
+    acoral_thread_t *thread=NULL;
+    stack_size=stack_size&(~3);//四字节对齐
+#ifdef CFG_THREAD_RECYCLE
+    void *recycle_stack=NULL;
+    if(stack==NULL)
+        thread=acoral_thread_recycle_get(stack_size);//优先从回收缓存中取出tcb+栈
+    if(thread!=NULL)
+        recycle_stack=thread->stack_buttom;
 #endif
-    acoral_thread_t *thread;
-    thread=acoral_alloc_thread();//分配tcb内存块
-    if(NULL==thread)//分配失败
+    if(NULL==thread)
     {
-        acoral_printerr("Alloc thread:%s fail\n",name);
-        return KR_POLICY_ERR_THREAD;
+        thread=acoral_alloc_thread();//分配tcb内存块
+        if(NULL==thread)//分配失败
+        {
+            acoral_printerr("Alloc thread:%s fail\n",name);
+            return KR_POLICY_ERR_THREAD;
+        }
+        thread->stack_size=stack_size;//设置栈大小
+        if(stack!=NULL)
+            thread->stack_buttom=(acoral_u32 *)stack;//设置栈底
+        else
+            thread->stack_buttom=NULL;
+#ifdef CFG_THREAD_RECYCLE
+        thread->stack_alloc=0;
+#endif
     }
     thread->name=name;//线程名字
-    stack_size=stack_size&(~3);//四字节对齐
-    thread->stack_size=stack_size;//设置栈大小
-    if(stack!=NULL)
-        thread->stack_buttom=(acoral_u32 *)stack;//设置栈底
-    else
-        thread->stack_buttom=NULL;
     thread->policy=policy_type;//线程调度策略
     if(hook!=NULL)
     {
@@ -119,13 +135,22 @@ acoral_id create_thread_by_policy(void (*route)(void *args),acoral_u32 stack_siz
         thread->hook.deal_hook = NULL;
         thread->hook.release_hook = NULL;
     }
-#ifdef CFG_TRACE_THREADS_SWITCH_ENABLE
+#ifdef CFG_TRACE_WIRE_COMPACT
+    thread->task_id=acoral_monitor_task_id_new();//策略初始化后线程可能马上在其他cpu运行，先分配好追踪线程号
+#endif
     ret_id = acoral_policy_thread_init(policy_type,thread,route,args,p_data,data);//基于策略的线程初始化函数
-    acoral_tinfos_add(thread);
-    return ret_id;
-#else
-    return acoral_policy_thread_init(policy_type,thread,route,args,p_data,data);//基于策略的线程初始化函数
+#ifdef CFG_THREAD_RECYCLE
+    if(ret_id<0&&recycle_stack!=NULL)//初始化失败时tcb已被策略释放，栈需要单独释放
+        acoral_free(recycle_stack);
+#endif
+    if(ret_id>=0)
+    {
+        ACORAL_TRACE(ACORAL_TRACE_CREATE,ACORAL_TRACE_THREAD(thread),thread->prio,thread->cpu);
+#ifdef CFG_TRACE_THREADS_SWITCH_ENABLE
+        acoral_tinfos_add(thread);
 #endif
+    }
+    return ret_id;
 
 }
 
@@ -12,13 +12,26 @@
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-13 <td>增加注释
  *         <tr><td>v2.0 <td>胡博文 <td>2023-09-09 <td>临界区与调度锁配合，更改调度时机
+ *         <tr><td>v2.1 <td>胡博文 <td>2026-10-19 <td>切换时检查栈底保护区
+ *         <tr><td>v2.2 <td>胡博文 <td>2026-10-19 <td>切换事件写入每cpu追踪缓冲区
+ *         <tr><td>v2.3 <td>胡博文 <td>2026-10-19 <td>切换时统计线程运行时间
+ *         <tr><td>v2.4 <td>胡博文 <td>2026-10-19 <td>切换时累计线程性能计数
+ *         <tr><td>v2.5 <td>胡博文 <td>2026-10-19 <td>最外层临界区计时
+ *         <tr><td>v2.6 <td>胡博文 <td>2026-10-19 <td>切换事件按ACORAL_TRACE_THREAD记录线程
  */
 #include <type.h>
 #include <hal.h>
 #include <thread.h>
+#ifdef CFG_STACK_CHECK_GUARD
+#include <stack_check.h>
+#endif
 #include <cpu.h>
 #include <int.h>
 #include <lsched.h>
+#include <trace.h>
+#include <usage.h>
+#include <pmu.h>
+#include <crit_prof.h>
 ///需要调度标志
 acoral_u8 need_sched[CFG_MAX_CPU];
 ///调度锁
@@ -69,6 +82,10 @@ void acoral_enter_critical(void)
     if(!acoral_sched_is_lock)
         acoral_sched_lock();//调度锁上锁
     critical_nesting[cpu]++;
+#ifdef CFG_CRIT_PROF
+    if(critical_nesting[cpu]==1)
+        acoral_crit_prof_enter((acoral_u32)__builtin_return_address(0));//最外层进入，记录调用者
+#endif
 }
 
 /**
@@ -83,6 +100,9 @@ void acoral_exit_critical(void)
         critical_nesting[cpu]--;
     if(critical_nesting[cpu]==0)//完全退出临界区
     {
+#ifdef CFG_CRIT_PROF
+        acoral_crit_prof_exit((acoral_u32)__builtin_return_address(0));//开中断前计时结束
+#endif
         HAL_INTR_RESTORE();
         acoral_sched_unlock();//打开调度锁
     }
@@ -189,8 +209,12 @@ void acoral_switch_context()
     {
         if(prev->state==ACORAL_THREAD_STATE_EXIT)//prev线程是退出状态
         {
-#ifdef CFG_TRACE_THREADS_SWITCH_ENABLE
-            acoral_tswinfos_add(prev, next);
+            ACORAL_TRACE(ACORAL_TRACE_SWITCH,ACORAL_TRACE_THREAD(prev),ACORAL_TRACE_THREAD(next),prev->state);
+#ifdef CFG_CPU_USAGE
+            acoral_usage_switch(prev);//被换出线程的运行时间记账
+#endif
+#ifdef CFG_PMU
+            acoral_pmu_switch(prev);//被换出线程的性能计数累加
 #endif
             acoral_set_running_thread((void *)next);//设置next线程为running线程
             prev->state=ACORAL_THREAD_STATE_RELEASE;//设置prev线程状态release
@@ -210,8 +234,15 @@ void acoral_switch_context()
         }
         if(can_sched)
         {
-#ifdef CFG_TRACE_THREADS_SWITCH_ENABLE
-            acoral_tswinfos_add(prev, next);
+#ifdef CFG_STACK_CHECK_GUARD
+            acoral_stack_guard_check(prev);//检查被换出线程的栈底保护区
+#endif
+            ACORAL_TRACE(ACORAL_TRACE_SWITCH,ACORAL_TRACE_THREAD(prev),ACORAL_TRACE_THREAD(next),prev->state);
+#ifdef CFG_CPU_USAGE
+            acoral_usage_switch(prev);//被换出线程的运行时间记账
+#endif
+#ifdef CFG_PMU
+            acoral_pmu_switch(prev);//被换出线程的性能计数累加
 #endif
             acoral_set_running_thread((void *)next);//设置next线程为running线程
             if(prev->state&ACORAL_THREAD_STATE_RELOAD)//prev线程是重载状态
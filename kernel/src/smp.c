@@ -11,6 +11,10 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-11 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>idle线程周期扫描栈高水位
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>各核创建软件定时器线程
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>资源回收线程计入内核时间
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>各核启动前初始化性能计数器
  */
 #include <acoral.h>
 
@@ -84,7 +88,9 @@ __weak void idle(void *args)
 {
     while(1)
     {
-
+#ifdef CFG_STACK_CHECK
+        acoral_stack_check_idle();//周期扫描线程栈高水位
+#endif
     }
 }
 
@@ -213,6 +219,16 @@ static void acoral_core_cpu_start(void)
     daemon_id=acoral_create_thread(daem,DAEM_STACK_SIZE,NULL,"daemon",NULL,ACORAL_SCHED_POLICY_COMM,&p_data,NULL,NULL);
     if(daemon_id==-1)
         while(1);
+#ifdef CFG_CPU_USAGE
+    acoral_usage_set_kernel_by_id(daemon_id);
+#endif
+#ifdef CFG_SOFT_TIMER
+    //创建主核软件定时器线程
+    acoral_soft_timer_thread_create();
+#endif
+#ifdef CFG_PMU
+    acoral_pmu_cpu_init();//本核性能计数器初始化
+#endif
     acoral_start_os();
 }
 #ifdef CFG_SMP
@@ -230,6 +246,13 @@ static void acoral_follow_cpu_start(void)
     idle_follow_id=acoral_create_thread(idle_follow,128,NULL,"idle_follow",NULL,ACORAL_SCHED_POLICY_COMM,&p_data,NULL,NULL);
     if(idle_follow_id==-1)
         while(1);
+#ifdef CFG_SOFT_TIMER
+    //创建次核软件定时器线程
+    acoral_soft_timer_thread_create();
+#endif
+#ifdef CFG_PMU
+    acoral_pmu_cpu_init();//本核性能计数器初始化
+#endif
     acoral_start_os();
 }
 #endif
@@ -0,0 +1,426 @@
+/**
+ * @file soft_timer.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层软件定时器相关源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>基于时间轮的软件定时器
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>软件定时器线程计入内核时间
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>到期链表每次从表头取，不跨解锁保存节点
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>定时器线程持锁挂起，修复多核下丢失唤醒
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>池中定时器归还后置为空闲态，重复删除、启动、停止返回错误
+ */
+#include <config.h>
+#include <type.h>
+#include <hal.h>
+#include <list.h>
+#include <lsched.h>
+#include <thread.h>
+#include <policy.h>
+#include <comm_thrd.h>
+#include <timer.h>
+#include <error.h>
+#include <print.h>
+#include <soft_timer.h>
+#include <usage.h>
+#ifdef CFG_SOFT_TIMER
+///时间轮槽数量
+#define SOFT_TIMER_WHEEL_SIZE (1<<CFG_SOFT_TIMER_WHEEL_BITS)
+///时间轮槽掩码
+#define SOFT_TIMER_WHEEL_MASK (SOFT_TIMER_WHEEL_SIZE-1)
+
+///时间轮，每个槽挂着在该槽到期的定时器
+static acoral_list_t soft_timer_wheel[SOFT_TIMER_WHEEL_SIZE];
+///时间轮当前槽
+static acoral_u32 soft_timer_cursor;
+///定时器池
+static acoral_soft_timer_t soft_timer_pool[CFG_SOFT_TIMER_NUM];
+///定时器池空闲链表
+static acoral_list_t soft_timer_free;
+///各cpu等待定时器线程执行的定时器链表
+static acoral_list_t soft_timer_pending[CFG_MAX_CPU];
+///各cpu定时器线程id
+static acoral_id soft_timer_thread_id[CFG_MAX_CPU];
+#ifdef CFG_SMP
+///软件定时器自旋锁
+static acoral_spinlock_t soft_timer_lock;
+#endif
+
+/**
+ * @brief 定时器加入时间轮（需持锁）
+ *
+ * @param timer 定时器指针
+ * @param time 距离到期的ticks
+ */
+static void soft_timer_wheel_add(acoral_soft_timer_t *timer, acoral_time time)
+{
+    if(time==0)
+        time=1;
+    timer->rounds=(time-1)>>CFG_SOFT_TIMER_WHEEL_BITS;
+    acoral_list_add_tail(&timer->list, &soft_timer_wheel[(soft_timer_cursor+time)&SOFT_TIMER_WHEEL_MASK]);
+    timer->state=ACORAL_SOFT_TIMER_STATE_ACTIVE;
+}
+
+/**
+ * @brief 定时器移出时间轮（需持锁）
+ *
+ * @param timer 定时器指针
+ */
+static void soft_timer_wheel_del(acoral_soft_timer_t *timer)
+{
+    if(!acoral_list_empty(&timer->list))
+        acoral_list_del(&timer->list);
+    if(!acoral_list_empty(&timer->pending))//还没被定时器线程执行的也一并取消
+        acoral_list_del(&timer->pending);
+    timer->state=ACORAL_SOFT_TIMER_STATE_IDLE;
+}
+
+/**
+ * @brief 定时器线程，执行本cpu上到期定时器的回调
+ *
+ * @param args 回调参数
+ */
+static void soft_timer_thread(void *args)
+{
+    acoral_u32 cpu=acoral_current_cpu;
+    acoral_list_t *head=&soft_timer_pending[cpu];
+    acoral_soft_timer_t *timer;
+    acoral_soft_timer_cb_t callback;
+    void *arg;
+    while(1)
+    {
+        acoral_enter_critical();
+#ifdef CFG_SMP
+        acoral_spin_lock(&soft_timer_lock);
+#endif
+        if(acoral_list_empty(head))
+        {
+            //持锁时就置为挂起态，其他cpu在放锁后唤醒时能看到挂起态，不会丢失唤醒
+            acoral_suspend_self();
+#ifdef CFG_SMP
+            acoral_spin_unlock(&soft_timer_lock);
+#endif
+            acoral_exit_critical();
+            continue;
+        }
+        timer=list_entry(head->next,acoral_soft_timer_t,pending);
+        acoral_list_del(&timer->pending);
+        callback=timer->callback;
+        arg=timer->arg;
+#ifdef CFG_SMP
+        acoral_spin_unlock(&soft_timer_lock);
+#endif
+        acoral_exit_critical();
+        callback(arg);
+    }
+}
+
+/**
+ * @brief 软件定时器tick处理，在基石时钟中断中调用
+ *
+ */
+void acoral_soft_timer_deal(void)
+{
+    acoral_list_t *tmp,*tmp1,*head;
+    acoral_list_t expired;
+    acoral_soft_timer_t *timer;
+    acoral_u8 wake[CFG_MAX_CPU]={0};
+    acoral_u32 i;
+    acoral_list_init(&expired);
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&soft_timer_lock);
+#endif
+    soft_timer_cursor=(soft_timer_cursor+1)&SOFT_TIMER_WHEEL_MASK;
+    head=&soft_timer_wheel[soft_timer_cursor];
+    for(tmp=head->next;tmp!=head;)//只处理当前槽
+    {
+        tmp1=tmp->next;
+        timer=list_entry(tmp,acoral_soft_timer_t,list);
+        if(timer->rounds>0)
+        {
+            timer->rounds--;
+        }
+        else
+        {
+            acoral_list_del(&timer->list);
+            acoral_list_add_tail(&timer->list,&expired);//先移出，避免周期定时器重新加入本槽后被重复处理
+        }
+        tmp=tmp1;
+    }
+    //每次都从表头取，tick回调执行时会放开锁，其间定时器可能被停止、重启或删除，不能保存下一个节点
+    while(!acoral_list_empty(&expired))
+    {
+        timer=list_entry(expired.next,acoral_soft_timer_t,list);
+        acoral_list_del(&timer->list);
+        if(timer->flag&ACORAL_SOFT_TIMER_PERIODIC)
+            soft_timer_wheel_add(timer,timer->time);
+        else
+            timer->state=ACORAL_SOFT_TIMER_STATE_IDLE;
+        if(timer->flag&ACORAL_SOFT_TIMER_IN_TICK)
+        {
+#ifdef CFG_SMP
+            acoral_spin_unlock(&soft_timer_lock);
+#endif
+            timer->callback(timer->arg);//tick模式直接在中断中执行，回调须短小且不可阻塞
+#ifdef CFG_SMP
+            acoral_spin_lock(&soft_timer_lock);
+#endif
+        }
+        else if(acoral_list_empty(&timer->pending))
+        {
+            acoral_list_add_tail(&timer->pending,&soft_timer_pending[timer->cpu]);
+            wake[timer->cpu]=1;
+        }
+        else//上一次回调还没执行
+        {
+            timer->overrun++;
+        }
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&soft_timer_lock);
+#endif
+    acoral_exit_critical();
+    for(i=0;i<CFG_MAX_CPU;i++)
+    {
+        if(wake[i]&&soft_timer_thread_id[i]>=0)
+            acoral_rdy_thread_by_id(soft_timer_thread_id[i]);//唤醒对应cpu的定时器线程
+    }
+}
+
+/**
+ * @brief 初始化软件定时器
+ *
+ * @param timer 定时器指针
+ * @param callback 回调函数
+ * @param arg 回调参数
+ * @param time 定时时间(ms)
+ * @param flag 定时器标志
+ * @param cpu 定时器线程模式下回调执行所在cpu
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_soft_timer_init(acoral_soft_timer_t *timer, acoral_soft_timer_cb_t callback, void *arg, acoral_time time, acoral_u8 flag, acoral_u8 cpu)
+{
+    if(timer==NULL||callback==NULL)
+        return KR_TIMER_ERR_NULL;
+    if(cpu>=CFG_MAX_CPU)
+        return KR_TIMER_ERR_CPU;
+    acoral_list_init(&timer->list);
+    acoral_list_init(&timer->pending);
+    timer->time=TIME_TO_TICKS(time);
+    timer->rounds=0;
+    timer->callback=callback;
+    timer->arg=arg;
+    timer->flag=flag;
+    timer->state=ACORAL_SOFT_TIMER_STATE_IDLE;
+    timer->cpu=cpu;
+    timer->overrun=0;
+    return KR_OK;
+}
+
+/**
+ * @brief 从定时器池创建软件定时器，可在中断中调用
+ *
+ * @param callback 回调函数
+ * @param arg 回调参数
+ * @param time 定时时间(ms)
+ * @param flag 定时器标志
+ * @param cpu 定时器线程模式下回调执行所在cpu
+ * @return acoral_soft_timer_t* 定时器指针，失败返回NULL
+ */
+acoral_soft_timer_t *acoral_soft_timer_create(acoral_soft_timer_cb_t callback, void *arg, acoral_time time, acoral_u8 flag, acoral_u8 cpu)
+{
+    acoral_soft_timer_t *timer=NULL;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&soft_timer_lock);
+#endif
+    if(!acoral_list_empty(&soft_timer_free))
+    {
+        timer=list_entry(soft_timer_free.next,acoral_soft_timer_t,list);
+        acoral_list_del(&timer->list);
+        timer->state=ACORAL_SOFT_TIMER_STATE_IDLE;//初始化失败时仍可删除
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&soft_timer_lock);
+#endif
+    acoral_exit_critical();
+    if(timer==NULL)
+    {
+        acoral_printerr("No free soft timer\n");
+        return NULL;
+    }
+    if(acoral_soft_timer_init(timer,callback,arg,time,flag,cpu)!=KR_OK)
+    {
+        acoral_soft_timer_delete(timer);
+        return NULL;
+    }
+    return timer;
+}
+
+/**
+ * @brief 删除软件定时器，池中分配的定时器归还到池中
+ *
+ * @param timer 定时器指针
+ * @return acoral_err 错误检测，已归还到池中的定时器返回KR_TIMER_ERR_STATE
+ */
+acoral_err acoral_soft_timer_delete(acoral_soft_timer_t *timer)
+{
+    if(timer==NULL)
+        return KR_TIMER_ERR_NULL;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&soft_timer_lock);
+#endif
+    if(timer->state==ACORAL_SOFT_TIMER_STATE_FREE)//重复删除，再次加入空闲链表会破坏链表
+    {
+#ifdef CFG_SMP
+        acoral_spin_unlock(&soft_timer_lock);
+#endif
+        acoral_exit_critical();
+        return KR_TIMER_ERR_STATE;
+    }
+    soft_timer_wheel_del(timer);
+    if(timer>=soft_timer_pool&&timer<soft_timer_pool+CFG_SOFT_TIMER_NUM)
+    {
+        acoral_list_add(&timer->list,&soft_timer_free);
+        timer->state=ACORAL_SOFT_TIMER_STATE_FREE;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&soft_timer_lock);
+#endif
+    acoral_exit_critical();
+    return KR_OK;
+}
+
+/**
+ * @brief 启动软件定时器，已启动的定时器重新开始计时
+ *
+ * @param timer 定时器指针
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_soft_timer_start(acoral_soft_timer_t *timer)
+{
+    if(timer==NULL)
+        return KR_TIMER_ERR_NULL;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&soft_timer_lock);
+#endif
+    if(timer->state==ACORAL_SOFT_TIMER_STATE_FREE)
+    {
+#ifdef CFG_SMP
+        acoral_spin_unlock(&soft_timer_lock);
+#endif
+        acoral_exit_critical();
+        return KR_TIMER_ERR_STATE;
+    }
+    if(!acoral_list_empty(&timer->list))
+        acoral_list_del(&timer->list);
+    soft_timer_wheel_add(timer,timer->time);
+#ifdef CFG_SMP
+    acoral_spin_unlock(&soft_timer_lock);
+#endif
+    acoral_exit_critical();
+    return KR_OK;
+}
+
+/**
+ * @brief 停止软件定时器
+ *
+ * @param timer 定时器指针
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_soft_timer_stop(acoral_soft_timer_t *timer)
+{
+    if(timer==NULL)
+        return KR_TIMER_ERR_NULL;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&soft_timer_lock);
+#endif
+    if(timer->state==ACORAL_SOFT_TIMER_STATE_FREE)
+    {
+#ifdef CFG_SMP
+        acoral_spin_unlock(&soft_timer_lock);
+#endif
+        acoral_exit_critical();
+        return KR_TIMER_ERR_STATE;
+    }
+    soft_timer_wheel_del(timer);
+#ifdef CFG_SMP
+    acoral_spin_unlock(&soft_timer_lock);
+#endif
+    acoral_exit_critical();
+    return KR_OK;
+}
+
+/**
+ * @brief 修改定时时间并重新开始计时
+ *
+ * @param timer 定时器指针
+ * @param time 新的定时时间(ms)，为0时保持原定时时间
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_soft_timer_reset(acoral_soft_timer_t *timer, acoral_time time)
+{
+    if(timer==NULL)
+        return KR_TIMER_ERR_NULL;
+    if(time!=0)
+        timer->time=TIME_TO_TICKS(time);
+    return acoral_soft_timer_start(timer);
+}
+
+/**
+ * @brief 创建当前cpu的定时器线程，在各cpu启动时调用
+ *
+ */
+void acoral_soft_timer_thread_create(void)
+{
+    acoral_comm_policy_data_t p_data;
+    acoral_u32 cpu=acoral_current_cpu;
+    p_data.cpu=cpu;
+    p_data.prio=CFG_SOFT_TIMER_PRIO;
+    soft_timer_thread_id[cpu]=acoral_create_thread(soft_timer_thread,CFG_SOFT_TIMER_STACK_SIZE,NULL,"soft_timer",NULL,ACORAL_SCHED_POLICY_COMM,&p_data,NULL,NULL);
+    if(soft_timer_thread_id[cpu]<0)
+        acoral_printerr("Create soft timer thread fail\n");
+#ifdef CFG_CPU_USAGE
+    else
+        acoral_usage_set_kernel_by_id(soft_timer_thread_id[cpu]);
+#endif
+}
+
+/**
+ * @brief 软件定时器系统初始化
+ *
+ */
+void acoral_soft_timer_sys_init(void)
+{
+    acoral_u32 i;
+    for(i=0;i<SOFT_TIMER_WHEEL_SIZE;i++)
+        acoral_list_init(&soft_timer_wheel[i]);
+    soft_timer_cursor=0;
+    acoral_list_init(&soft_timer_free);
+    for(i=0;i<CFG_SOFT_TIMER_NUM;i++)
+    {
+        acoral_list_init(&soft_timer_pool[i].list);
+        acoral_list_init(&soft_timer_pool[i].pending);
+        soft_timer_pool[i].state=ACORAL_SOFT_TIMER_STATE_FREE;
+        acoral_list_add_tail(&soft_timer_pool[i].list,&soft_timer_free);
+    }
+    for(i=0;i<CFG_MAX_CPU;i++)
+    {
+        acoral_list_init(&soft_timer_pending[i]);
+        soft_timer_thread_id[i]=-1;
+    }
+#ifdef CFG_SMP
+    acoral_spin_init(&soft_timer_lock);
+#endif
+}
+#endif
@@ -0,0 +1,283 @@
+/**
+ * @file stack_check.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层线程栈使用检测相关源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>栈涂色、高水位统计与推荐栈大小
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>扫描从上次位置继续；报告先复制再打印
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>报告复制线程名字而不是指针
+ */
+#include <config.h>
+#include <type.h>
+#include <hal.h>
+#include <queue.h>
+#include <lsched.h>
+#include <thread.h>
+#include <timer.h>
+#include <mem.h>
+#include <res_pool.h>
+#include <stack_check.h>
+#include <print.h>
+#include <str.h>
+#ifdef CFG_STACK_CHECK
+///当前扫描轮次
+static acoral_u8 stack_scan_seq;
+
+/**
+ * @brief 报告中的一个线程
+ *
+ */
+typedef struct{
+    acoral_char name[ACORAL_REPORT_NAME_LEN];///<名字，复制一份，打印时线程可能已被回收
+    acoral_id id;///<线程id
+    acoral_u32 cpu;///<所在cpu
+    acoral_u32 size;///<栈大小
+    acoral_u32 hwm;///<栈高水位
+}stack_entry_t;
+
+/**
+ * @brief 计算栈已使用字节数
+ *
+ * @param buttom 栈底
+ * @param size 栈大小
+ * @return acoral_u32 从栈底起第一个被改写的字到栈顶的字节数
+ */
+static acoral_u32 stack_used_bytes(acoral_u32 *buttom, acoral_u32 size)
+{
+    acoral_u32 i;
+    acoral_u32 words=size>>2;
+    for(i=0;i<(ACORAL_STACK_GUARD_SIZE>>2)&&i<words;i++)
+    {
+        if(buttom[i]!=ACORAL_STACK_GUARD_MAGIC)//保护区被改写，栈已溢出
+            return size;
+    }
+    for(;i<words;i++)
+    {
+        if(buttom[i]!=ACORAL_STACK_MAGIC)
+            break;
+    }
+    return size-(i<<2);
+}
+
+/**
+ * @brief 栈涂色，在线程栈初始化前调用
+ *
+ * @param thread 线程tcb指针
+ */
+void acoral_stack_paint(acoral_thread_t *thread)
+{
+    acoral_u32 i;
+    acoral_u32 words=thread->stack_size>>2;
+    acoral_u32 *buttom=thread->stack_buttom;
+    for(i=0;i<(ACORAL_STACK_GUARD_SIZE>>2)&&i<words;i++)
+        buttom[i]=ACORAL_STACK_GUARD_MAGIC;
+    for(;i<words;i++)
+        buttom[i]=ACORAL_STACK_MAGIC;
+    thread->stack_hwm=0;
+    thread->stack_scan_seq=stack_scan_seq;
+}
+
+/**
+ * @brief 获取线程栈高水位
+ *
+ * @param thread 线程tcb指针
+ * @return acoral_u32 线程运行以来栈的最大使用字节数
+ */
+acoral_u32 acoral_thread_stack_hwm(acoral_thread_t *thread)
+{
+    acoral_u32 used;
+    if(thread==NULL||thread->stack_buttom==NULL)
+        return 0;
+    used=stack_used_bytes(thread->stack_buttom,thread->stack_size);
+    if(used>thread->stack_hwm)
+        thread->stack_hwm=used;
+    return thread->stack_hwm;
+}
+
+/**
+ * @brief 使用id来获取线程栈高水位
+ *
+ * @param thread_id 线程id
+ * @return acoral_u32 线程运行以来栈的最大使用字节数
+ */
+acoral_u32 acoral_thread_stack_hwm_by_id(acoral_id thread_id)
+{
+    acoral_thread_t *thread=(acoral_thread_t *)acoral_get_res_by_id(thread_id);
+    return acoral_thread_stack_hwm(thread);
+}
+
+/**
+ * @brief 根据高水位计算推荐栈大小
+ *
+ * @param hwm 栈高水位
+ * @return acoral_u32 推荐栈大小（含余量与保护区，8字节对齐）
+ */
+acoral_u32 acoral_stack_recommend_size(acoral_u32 hwm)
+{
+    acoral_u32 size;
+    size=hwm+hwm*CFG_STACK_CHECK_MARGIN/100+ACORAL_STACK_GUARD_SIZE;
+    size=(size+7)&(~7);
+    if(size<ACORAL_MIN_STACK_SIZE)
+        size=ACORAL_MIN_STACK_SIZE;
+    return size;
+}
+
+/**
+ * @brief 扫描全部线程栈，更新高水位
+ *
+ * 每次只在临界区内取出一个本轮未扫描的线程，栈内容的比较在临界区外进行，
+ * 不会因线程数量或栈大小而拉长关中断时间。下次从上一个线程之后继续找，
+ * 期间有线程被删除时上一个线程可能已不在队列中，才从队头重新找
+ */
+void acoral_stack_check_scan(void)
+{
+    acoral_list_t *tmp,*head,*pos;
+    acoral_thread_t *thread;
+    acoral_u32 *buttom=NULL;
+    acoral_u32 size=0;
+    acoral_u32 used,del_num=0;
+    head=&acoral_threads_queue.head;
+    pos=NULL;
+    stack_scan_seq++;
+    while(1)
+    {
+        thread=NULL;
+        acoral_enter_critical();
+#ifdef CFG_SMP
+        acoral_spin_lock(&acoral_threads_queue.lock);
+#endif
+        if(pos==NULL||del_num!=acoral_threads_queue_del_num)
+        {
+            pos=head;
+            del_num=acoral_threads_queue_del_num;
+        }
+        for(tmp=pos->next;tmp!=head;tmp=tmp->next)//找到本轮未扫描的线程
+        {
+            if(list_entry(tmp,acoral_thread_t,global_list)->stack_scan_seq!=stack_scan_seq)
+            {
+                thread=list_entry(tmp,acoral_thread_t,global_list);
+                thread->stack_scan_seq=stack_scan_seq;
+                buttom=thread->stack_buttom;
+                size=thread->stack_size;
+                pos=tmp;
+                break;
+            }
+        }
+#ifdef CFG_SMP
+        acoral_spin_unlock(&acoral_threads_queue.lock);
+#endif
+        acoral_exit_critical();
+        if(thread==NULL)//本轮扫描完成
+            break;
+        if(buttom==NULL)
+            continue;
+        used=stack_used_bytes(buttom,size);
+        acoral_enter_critical();
+        if(thread->stack_buttom==buttom&&used>thread->stack_hwm)//扫描期间线程未被回收才更新
+            thread->stack_hwm=used;
+        acoral_exit_critical();
+    }
+}
+
+/**
+ * @brief 空闲线程中调用的周期扫描
+ *
+ */
+void acoral_stack_check_idle(void)
+{
+    static acoral_time last_ticks=0;
+    acoral_time now=acoral_get_ticks();
+    if(now-last_ticks<TIME_TO_TICKS(CFG_STACK_CHECK_PERIOD))
+        return;
+    last_ticks=now;
+    acoral_stack_check_scan();
+}
+
+/**
+ * @brief 打印全部线程的栈使用情况与推荐栈大小
+ *
+ */
+void acoral_stack_report(void)
+{
+    static stack_entry_t entry[CFG_MAX_THREAD];//不放在调用者栈上，shell栈较小
+    acoral_list_t *tmp,*head;
+    acoral_thread_t *thread;
+    acoral_u32 rec,num=0,i;
+    acoral_u32 block_total=0;
+    acoral_u32 rec_block_total=0;
+    acoral_stack_check_scan();
+    head=&acoral_threads_queue.head;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&acoral_threads_queue.lock);
+#endif
+    for(tmp=head->next;tmp!=head&&num<CFG_MAX_THREAD;tmp=tmp->next)//持锁时只复制，打印放到放锁之后
+    {
+        thread=list_entry(tmp,acoral_thread_t,global_list);
+        if(thread->stack_buttom==NULL)
+            continue;
+        acoral_str_lcpy(entry[num].name,thread->name,sizeof(entry[num].name));
+        entry[num].id=thread->res.id;
+        entry[num].cpu=thread->cpu;
+        entry[num].size=thread->stack_size;
+        entry[num].hwm=thread->stack_hwm;
+        num++;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&acoral_threads_queue.lock);
+#endif
+    acoral_exit_critical();
+    acoral_print("%-20s%6s%5s%7s%7s%7s%7s%7s\r\n","name","id","cpu","size","used","rec","block","rblock");
+    for(i=0;i<num;i++)
+    {
+        rec=acoral_stack_recommend_size(entry[i].hwm);
+        block_total+=acoral_malloc_size(entry[i].size);
+        rec_block_total+=acoral_malloc_size(rec);
+        acoral_print("%-20s%6d%5u%7u%7u%7u%7u%7u\r\n",
+                     entry[i].name,entry[i].id,entry[i].cpu,entry[i].size,
+                     entry[i].hwm,rec,acoral_malloc_size(entry[i].size),acoral_malloc_size(rec));
+    }
+    acoral_print("stack block total:%u, recommended:%u\r\n",block_total,rec_block_total);
+}
+
+#ifdef CFG_STACK_CHECK_GUARD
+/**
+ * @brief 栈底保护区检查，在线程被切换出去时调用
+ *
+ * @param thread 线程tcb指针
+ */
+void acoral_stack_guard_check(acoral_thread_t *thread)
+{
+    acoral_u32 i;
+    acoral_u32 *buttom=thread->stack_buttom;
+    if(buttom==NULL)
+        return;
+    for(i=0;i<(ACORAL_STACK_GUARD_SIZE>>2);i++)
+    {
+        if(buttom[i]!=ACORAL_STACK_GUARD_MAGIC)
+        {
+            acoral_stack_overflow_hook(thread);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 栈溢出处理函数（弱定义）
+ *
+ * @param thread 栈溢出的线程tcb指针
+ */
+void __weak acoral_stack_overflow_hook(acoral_thread_t *thread)
+{
+    acoral_printerr("Stack overflow:%s\r\n",thread->name);
+    while(1);
+}
+#endif
+#endif
@@ -13,6 +13,14 @@
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-14 <td>增加注释
  *         <tr><td>v1.1 <td>胡博文 <td>2022-09-26 <td>错误头文件相关改动
  *         <tr><td>v2.0 <td>胡博文 <td>2023-09-09 <td>去除no_sched
+ *         <tr><td>v2.1 <td>胡博文 <td>2026-10-19 <td>线程创建时栈涂色
+ *         <tr><td>v2.2 <td>胡博文 <td>2026-10-19 <td>线程tcb+栈回收缓存
+ *         <tr><td>v2.3 <td>胡博文 <td>2026-10-19 <td>就绪事件追踪
+ *         <tr><td>v2.4 <td>胡博文 <td>2026-10-19 <td>初始化cpu时间统计字段
+ *         <tr><td>v2.5 <td>胡博文 <td>2026-10-19 <td>初始化性能计数器统计字段
+ *         <tr><td>v2.6 <td>胡博文 <td>2026-10-19 <td>回收缓存的检查、取放与计数在队列锁内完成
+ *         <tr><td>v2.7 <td>胡博文 <td>2026-10-19 <td>就绪事件按ACORAL_TRACE_THREAD记录线程
+ *         <tr><td>v2.8 <td>胡博文 <td>2026-10-19 <td>全部线程队列删除计数
  */
 #include <type.h>
 #include <hal.h>
@@ -30,16 +38,29 @@
 #include <policy.h>
 #include <list.h>
 #include <bitops.h>
+#include <trace.h>
+#ifdef CFG_STACK_CHECK
+#include <stack_check.h>
+#endif
 
 #include <print.h>
+#include <str.h>
 ///全部线程队列
 acoral_queue_t acoral_threads_queue;
+///全部线程队列删除次数，持队列锁修改；跨临界区保存遍历位置者据此判断位置是否仍有效
+acoral_u32 acoral_threads_queue_del_num;
 ///释放队列，即需要进行回收的线程队列
 acoral_queue_t acoral_release_queue;
 ///线程内存池api结构体实例
 acoral_res_api_t thread_api;
 ///线程内存池控制结构体实例
 acoral_pool_ctrl_t acoral_thread_pool_ctrl;
+#ifdef CFG_THREAD_RECYCLE
+///线程回收缓存队列，按栈大小等级存放tcb+栈
+acoral_queue_t acoral_thread_recycle_queue[CFG_THREAD_RECYCLE_CLASS_NUM];
+///线程回收缓存各等级数量
+acoral_u32 acoral_thread_recycle_num[CFG_THREAD_RECYCLE_CLASS_NUM];
+#endif
 
 /**********************************kill******************************************/
 
@@ -127,6 +148,7 @@ acoral_err acoral_rdy_thread(acoral_thread_t *thread)
     }
 #endif
     acoral_enter_critical();
+    ACORAL_TRACE(ACORAL_TRACE_WAKE,ACORAL_TRACE_THREAD(thread),thread->prio,0);
     acoral_sched_rdyqueue_add((void *)thread);//添加线程到就绪队列
     acoral_exit_critical();
     return KR_OK;
@@ -388,8 +410,21 @@ void acoral_release_thread(acoral_res_t *res)
 {
     acoral_thread_t *thread;
     thread=(acoral_thread_t *)res;
-    acoral_lifo_queue_del(&acoral_threads_queue, &thread->global_list);
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&acoral_threads_queue.lock);
+#endif
+    acoral_list_del(&thread->global_list);
+    acoral_threads_queue_del_num++;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&acoral_threads_queue.lock);
+#endif
+    acoral_exit_critical();
     acoral_policy_thread_release(thread);//基于策略回收线程
+#ifdef CFG_THREAD_RECYCLE
+    if(thread->stack_alloc&&acoral_thread_recycle_put(thread)==TRUE)
+        return;//tcb+栈进入回收缓存，不再释放
+#endif
     acoral_free((void *)thread->stack_buttom);//回收内存
     thread->stack_buttom = NULL;
     acoral_release_res((acoral_res_t *)thread);//回收res
@@ -544,12 +579,28 @@ acoral_err acoral_thread_init(acoral_thread_t *thread,void (*route)(void *args),
         if(thread->stack_buttom==NULL)
             return KR_THREAD_ERR_NO_STACK;
         thread->stack_size=stack_size;
+#ifdef CFG_THREAD_RECYCLE
+        thread->stack_alloc=1;
+#endif
     }
+#ifdef CFG_STACK_CHECK
+    acoral_stack_paint(thread);//栈涂色，用于高水位统计
+#endif
     thread->stack=(acoral_u32 *)((acoral_8 *)thread->stack_buttom+stack_size-4);
     HAL_STACK_INIT(&thread->stack,route,exit,args);//线程栈初始化
     thread->delay = 0;
     thread->time = 0;
     thread->ipc = NULL;
+#ifdef CFG_CPU_USAGE
+    thread->run_cycles=0;
+    thread->run_mark=0;
+    thread->run_window=0;
+    thread->usage_kernel=0;
+#endif
+#ifdef CFG_PMU
+    acoral_memset(thread->pmu_count,0,sizeof(thread->pmu_count));
+    thread->pmu_samples=0;
+#endif
     thread->preempt_type = ACORAL_PREEMPT_LOCAL;//设置线程作用范围
     //cpu_mask
     if(thread->cpu_mask==-1)
@@ -591,6 +642,158 @@ void acoral_thread_exit(void)
     acoral_kill_thread(acoral_cur_thread);
 }
 
+#ifdef CFG_THREAD_RECYCLE
+/**
+ * @brief 计算栈大小对应的回收缓存等级
+ *
+ * @param stack_size 栈大小
+ * @return acoral_32 等级，超出最大等级返回-1
+ */
+static acoral_32 acoral_thread_recycle_class(acoral_u32 stack_size)
+{
+    acoral_32 cls=0;
+    acoral_u32 size=ACORAL_RECYCLE_BASE_SIZE;
+    while(size<stack_size)
+    {
+        size<<=1;
+        cls++;
+    }
+    if(cls>=CFG_THREAD_RECYCLE_CLASS_NUM)
+        return -1;
+    return cls;
+}
+
+/**
+ * @brief 从回收缓存中取出tcb+栈
+ *
+ * @param stack_size 需要的栈大小
+ * @return acoral_thread_t* 线程tcb指针，栈已就绪；缓存为空返回NULL
+ */
+acoral_thread_t *acoral_thread_recycle_get(acoral_u32 stack_size)
+{
+    acoral_32 cls;
+    acoral_list_t *head;
+    acoral_thread_t *thread=NULL;
+    cls=acoral_thread_recycle_class(stack_size);
+    if(cls<0)
+        return NULL;
+    head=&acoral_thread_recycle_queue[cls].head;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&acoral_thread_recycle_queue[cls].lock);//检查、取出与计数需一起完成，不能只锁取出
+#endif
+    if(!acoral_list_empty(head))
+    {
+        thread=list_entry(head->next,acoral_thread_t,global_list);
+        acoral_list_del(head->next);
+        acoral_thread_recycle_num[cls]--;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&acoral_thread_recycle_queue[cls].lock);
+#endif
+    acoral_exit_critical();
+    return thread;
+}
+
+/**
+ * @brief 把tcb+栈放入回收缓存
+ *
+ * @param thread 线程tcb指针
+ * @return acoral_bool 放入成功返回TRUE，等级超出或缓存已满返回FALSE
+ */
+acoral_bool acoral_thread_recycle_put(acoral_thread_t *thread)
+{
+    acoral_32 cls;
+    cls=acoral_thread_recycle_class(thread->stack_size);
+    if(cls<0)
+        return FALSE;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&acoral_thread_recycle_queue[cls].lock);
+#endif
+    if(acoral_thread_recycle_num[cls]>=CFG_THREAD_RECYCLE_MAX)
+    {
+#ifdef CFG_SMP
+        acoral_spin_unlock(&acoral_thread_recycle_queue[cls].lock);
+#endif
+        acoral_exit_critical();
+        return FALSE;
+    }
+    thread->stack_size=ACORAL_RECYCLE_BASE_SIZE<<cls;//栈实际为该等级的伙伴块大小
+    acoral_list_add(&thread->global_list,&acoral_thread_recycle_queue[cls].head);//后进先出，最近放入的栈更可能还在cache中
+    acoral_thread_recycle_num[cls]++;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&acoral_thread_recycle_queue[cls].lock);
+#endif
+    acoral_exit_critical();
+    return TRUE;
+}
+
+/**
+ * @brief 预热回收缓存，提前分配tcb+栈
+ *
+ * @param stack_size 栈大小
+ * @param num 预热数量
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_thread_recycle_prewarm(acoral_u32 stack_size, acoral_u32 num)
+{
+    acoral_u32 i;
+    acoral_32 cls;
+    acoral_thread_t *thread;
+    cls=acoral_thread_recycle_class(stack_size);
+    if(cls<0)
+        return KR_THREAD_ERR_UNDEF;
+    for(i=0;i<num;i++)
+    {
+        thread=acoral_alloc_thread();
+        if(thread==NULL)
+            return KR_POLICY_ERR_THREAD;
+        thread->stack_size=ACORAL_RECYCLE_BASE_SIZE<<cls;
+        thread->stack_buttom=(acoral_u32 *)acoral_malloc(thread->stack_size);
+        if(thread->stack_buttom==NULL)
+        {
+            acoral_enter_critical();
+            acoral_release_res((acoral_res_t *)thread);
+            acoral_exit_critical();
+            return KR_THREAD_ERR_NO_STACK;
+        }
+        thread->stack_alloc=1;
+        thread->state=ACORAL_THREAD_STATE_RELEASE;
+        if(acoral_thread_recycle_put(thread)==FALSE)//该等级缓存已满
+        {
+            acoral_free((void *)thread->stack_buttom);
+            thread->stack_buttom=NULL;
+            acoral_enter_critical();
+            acoral_release_res((acoral_res_t *)thread);
+            acoral_exit_critical();
+            break;
+        }
+    }
+    return KR_OK;
+}
+
+/**
+ * @brief 线程回收缓存初始化，并按配置预热
+ *
+ */
+static void acoral_thread_recycle_init(void)
+{
+    acoral_u32 i;
+    acoral_u32 prewarm[CFG_THREAD_RECYCLE_CLASS_NUM]=CFG_THREAD_RECYCLE_PREWARM;
+    for(i=0;i<CFG_THREAD_RECYCLE_CLASS_NUM;i++)
+    {
+        acoral_lifo_queue_init(&acoral_thread_recycle_queue[i]);
+        acoral_thread_recycle_num[i]=0;
+    }
+    for(i=0;i<CFG_THREAD_RECYCLE_CLASS_NUM;i++)
+    {
+        if(prewarm[i]>0)
+            acoral_thread_recycle_prewarm(ACORAL_RECYCLE_BASE_SIZE<<i,prewarm[i]);
+    }
+}
+#endif
+
 /**
  * @brief 线程内存池初始化
  * 
@@ -618,6 +821,9 @@ static void acoral_sched_mechanism_init()
     acoral_thread_pool_init();
     acoral_sched_rdyqueue_init();
     acoral_fifo_queue_init(&acoral_threads_queue);
+#ifdef CFG_THREAD_RECYCLE
+    acoral_thread_recycle_init();
+#endif
 }
 
 /**
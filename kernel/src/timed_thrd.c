@@ -2,8 +2,8 @@
  * @file timed_thrd.c
  * @author 胡博文 (@921576434@qq.com)
  * @brief kernel层时间确定性线程策略相关源文件
- * @version 1.2
- * @date 2022-09-26
+ * @version 1.3
+ * @date 2026-10-19
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -13,6 +13,9 @@
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-27 <td>增加注释
  *         <tr><td>v1.1 <td>胡博文 <td>2022-09-20 <td>time_deal的bug，核0没有安排线程就都不运行了，改变head的检测返回
  *         <tr><td>v1.2 <td>胡博文 <td>2022-09-26 <td>错误头文件相关改动
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>分派表（循环执行）模式
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>分派表容量在检查时预留，插入不会失败；游标在锁内读取
+ *         <tr><td>v1.5 <td>胡博文 <td>2026-10-19 <td>第一个超周期与之后的一样从tick开始计时
  */
 #include <type.h>
 #include <cpu.h>
@@ -49,6 +52,40 @@ typedef struct{
     void *args;///<传递参数
 }timed_private_data_t;
 
+#ifdef CFG_TIMED_TABLE
+/**
+ * @brief 分派表表项
+ *
+ */
+typedef struct{
+    acoral_time time;///<超周期内的触发时刻(ticks)
+    acoral_thread_t *thread;///<线程tcb指针
+    acoral_u8 section;///<段序号，从1开始，0表示实例结束（下一实例开始）
+}timed_table_entry_t;
+
+/**
+ * @brief 每个cpu的分派表，按触发时刻排序，tick中只需比较游标处的表项
+ *
+ */
+typedef struct{
+    timed_table_entry_t entry[CFG_TIMED_TABLE_SIZE];///<表项
+    acoral_u32 num;///<表项数量
+    acoral_u32 reserved;///<已为创建中的线程预留、尚未插入的表项数量
+    acoral_u32 cursor;///<下一个待触发表项
+    acoral_time now;///<超周期内当前时刻(ticks)
+    acoral_time h_period;///<超周期(ticks)
+    acoral_thread_t *last;///<最近一次放行段的线程
+    acoral_thread_t *reload;///<被中止后等待切换出去再重新开始的线程
+#ifdef CFG_SMP
+    acoral_spinlock_t lock;///<分派表自旋锁
+#endif
+}timed_table_t;
+
+///各cpu分派表
+static timed_table_t timed_table[CFG_MAX_CPU];
+#endif
+
+#ifndef CFG_TIMED_TABLE
 /**
  * @brief 时间确定性线程队列添加节点
  * 
@@ -87,6 +124,7 @@ static void timed_start_time_reload(acoral_thread_t *thread)
     acoral_vlist_init(&thread->timing, thread->time - time_last);//初始化timing链表
     acoral_timed_time_queue_add(thread);//添加进周期队列
 }
+#endif
 /**
  * @brief 时间确定性线程退出函数
  * 
@@ -96,6 +134,251 @@ static void timed_thread_exit()
     acoral_suspend_self();
 }
 
+#ifdef CFG_TIMED_TABLE
+/**
+ * @brief 为创建中的线程预留分派表表项，检查与预留一起完成，其他cpu同时创建线程时不会超出容量
+ *
+ * @param cpu 所在cpu
+ * @param cnt 需要的表项数量
+ * @return acoral_bool 剩余表项足够并已预留返回TRUE
+ */
+static acoral_bool timed_table_reserve(acoral_u32 cpu, acoral_u32 cnt)
+{
+    timed_table_t *table=&timed_table[cpu];
+    acoral_bool ret;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&table->lock);
+#endif
+    ret=table->num+table->reserved+cnt<=CFG_TIMED_TABLE_SIZE;
+    if(ret)
+        table->reserved+=cnt;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&table->lock);
+#endif
+    acoral_exit_critical();
+    return ret;
+}
+
+/**
+ * @brief 线程创建失败时归还预留的表项
+ *
+ * @param cpu 所在cpu
+ * @param cnt 预留的表项数量
+ */
+static void timed_table_unreserve(acoral_u32 cpu, acoral_u32 cnt)
+{
+    timed_table_t *table=&timed_table[cpu];
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&table->lock);
+#endif
+    table->reserved-=cnt;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&table->lock);
+#endif
+    acoral_exit_critical();
+}
+
+/**
+ * @brief 将线程一个超周期内的全部段开始与实例结束时刻插入分派表，使用timed_table_reserve预留的表项
+ *
+ * 同一时刻实例结束排在段开始之前，同一线程的段按序号排列
+ *
+ * @param thread 线程tcb指针
+ */
+static void timed_table_add(acoral_thread_t *thread)
+{
+    timed_private_data_t *private_data=thread->private_data;
+    timed_table_t *table=&timed_table[thread->cpu];
+    timed_table_entry_t entry;
+    acoral_u32 run,section,pos,k;
+    acoral_u32 cnt=private_data->frequency*(private_data->section_num+1);
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&table->lock);
+#endif
+    table->reserved-=cnt;
+    if(table->num==0)//第一个线程，超周期从下一个tick开始
+    {
+        table->cursor=0;
+        table->now=(acoral_time)-1;//下一个tick加1后为0，与之后的超周期一样在该tick放行0时刻的表项
+        table->h_period=0;
+        table->last=NULL;
+        table->reload=NULL;
+    }
+    entry.thread=thread;
+    for(run=0;run<private_data->frequency;run++)
+    {
+        for(section=1;section<=private_data->section_num+1;section++)
+        {
+            entry.time=TIME_TO_TICKS(private_data->start_time[run*(private_data->section_num+1)+section-1]);
+            entry.section=section>private_data->section_num?0:section;
+            for(pos=table->num;pos>0;pos--)//插入排序，相同键值保持插入顺序
+            {
+                if(table->entry[pos-1].time<entry.time||
+                   (table->entry[pos-1].time==entry.time&&table->entry[pos-1].section<=entry.section))
+                    break;
+            }
+            for(k=table->num;k>pos;k--)
+                table->entry[k]=table->entry[k-1];
+            table->entry[pos]=entry;
+            table->num++;
+            if(pos<table->cursor)//本超周期内已经过去的时刻
+                table->cursor++;
+            if(entry.time>table->h_period)
+                table->h_period=entry.time;
+        }
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&table->lock);
+#endif
+    acoral_exit_critical();
+}
+
+/**
+ * @brief 从分派表中删除线程的全部表项
+ *
+ * @param thread 线程tcb指针
+ */
+static void timed_table_del(acoral_thread_t *thread)
+{
+    timed_table_t *table=&timed_table[thread->cpu];
+    acoral_u32 i,k=0,cursor;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&table->lock);
+#endif
+    cursor=table->cursor;
+    for(i=0;i<table->num;i++)
+    {
+        if(table->entry[i].thread==thread)
+        {
+            if(i<table->cursor)
+                cursor--;
+            continue;
+        }
+        table->entry[k++]=table->entry[i];
+    }
+    table->num=k;
+    table->cursor=cursor;
+    if(table->last==thread)
+        table->last=NULL;
+    if(table->reload==thread)
+        table->reload=NULL;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&table->lock);
+#endif
+    acoral_exit_critical();
+}
+
+/**
+ * @brief 重新开始时间确定性线程的一个实例
+ *
+ * @param thread 线程tcb指针，不能是正在运行的线程
+ */
+static void timed_thread_restart(acoral_thread_t *thread)
+{
+    timed_private_data_t *private_data=thread->private_data;
+    acoral_ipc_t *ipc=thread->ipc;
+    if(ipc!=NULL)//上一实例还在等待段信号量
+    {
+#ifdef CFG_SMP
+        acoral_spin_lock(&ipc->lock);
+#endif
+        acoral_ipc_wait_queue_del(ipc, thread);
+#ifdef CFG_SMP
+        acoral_spin_unlock(&ipc->lock);
+#endif
+    }
+    private_data->section=1;
+    for(acoral_u8 i=0;i<private_data->section_num;i++)
+        acoral_sem_init(private_data->ipc[i], 0);
+    if(thread->hook.deal_hook!=NULL)
+        thread->hook.deal_hook(thread);
+    thread->stack=(acoral_u32 *)((acoral_8 *)thread->stack_buttom+thread->stack_size-4);
+    HAL_STACK_INIT(&thread->stack,private_data->route,timed_thread_exit,private_data->args);
+    acoral_rdy_thread(thread);
+}
+
+/**
+ * @brief 处理一个到期的分派表表项
+ *
+ * @param table 分派表指针
+ * @param entry 表项指针
+ */
+static void timed_table_dispatch(timed_table_t *table, timed_table_entry_t *entry)
+{
+    acoral_thread_t *thread=entry->thread;
+    acoral_thread_t *last=table->last;
+    timed_private_data_t *private_data;
+    if(last!=NULL&&last==running_thread[thread->cpu])//上一段还没执行完，中止该实例
+    {
+        private_data=last->private_data;
+        acoral_suspend_thread(last);
+        last->state|=ACORAL_THREAD_STATE_RELOAD;
+        private_data->section=private_data->section_num+1;//本实例剩余的段不再放行
+        table->last=NULL;
+    }
+    private_data=thread->private_data;
+    if(entry->section==0)//实例结束，下一实例开始
+    {
+        if(thread==running_thread[thread->cpu])//刚被中止，切换出去后再重新开始
+            table->reload=thread;
+        else
+            timed_thread_restart(thread);
+    }
+    else if(private_data->section==entry->section)//放行该段
+    {
+        acoral_sem_post(private_data->ipc[entry->section-1]);
+        private_data->section++;
+        table->last=thread;
+    }
+}
+
+/**
+ * @brief 推进分派表游标，放行到期的表项
+ *
+ * @param cpu cpu
+ * @return acoral_bool 是否有表项到期
+ */
+static acoral_bool timed_table_deal(acoral_u32 cpu)
+{
+    timed_table_t *table=&timed_table[cpu];
+    acoral_thread_t *thread;
+    acoral_u32 cursor;
+    acoral_bool ret;
+#ifdef CFG_SMP
+    acoral_spin_lock(&table->lock);
+#endif
+    cursor=table->cursor;//其他cpu插入或删除表项时会移动游标，需在锁内读取
+    if(table->num!=0)
+    {
+        thread=table->reload;
+        if(thread!=NULL&&thread!=running_thread[cpu])//被中止的线程已切换出去
+        {
+            table->reload=NULL;
+            timed_thread_restart(thread);
+        }
+        table->now++;
+        while(table->cursor<table->num&&table->entry[table->cursor].time<=table->now)
+            timed_table_dispatch(table,&table->entry[table->cursor++]);
+        if(table->now>=table->h_period)//超周期结束，游标回到表头
+        {
+            table->now=0;
+            table->cursor=0;
+            while(table->cursor<table->num&&table->entry[table->cursor].time==0)
+                timed_table_dispatch(table,&table->entry[table->cursor++]);
+        }
+    }
+    ret=cursor!=table->cursor;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&table->lock);
+#endif
+    return ret;
+}
+#endif
+
 /**
  * @brief 时间确定性线程初始化
  * 
@@ -134,6 +417,17 @@ static acoral_id timed_policy_thread_init(acoral_thread_t *thread,void (*route)(
         private_data->section = 1;
         private_data->run_num = 1;
         private_data->route = route;
+#ifdef CFG_TIMED_TABLE
+        if(!timed_table_reserve(thread->cpu,private_data->frequency*(private_data->section_num+1)))//预留分派表表项
+        {
+            acoral_printerr("No timed table space for thread:%s\n",thread->name);
+            acoral_vol_free(private_data);
+            acoral_enter_critical();
+            acoral_release_res((acoral_res_t *)thread);
+            acoral_exit_critical();
+            return KR_POLICY_ERR_FULL;
+        }
+#endif
         private_data->section_route = policy_data->section_route;
         private_data->section_args = policy_data->section_args;
         private_data->args = args;
@@ -148,6 +442,10 @@ static acoral_id timed_policy_thread_init(acoral_thread_t *thread,void (*route)(
     if((err = acoral_thread_init(thread,route,timed_thread_exit,args))!=0)//通用线程初始化
     {
         acoral_printerr("No thread stack:%s\n",thread->name);
+#ifdef CFG_TIMED_TABLE
+        if(thread->policy==ACORAL_SCHED_POLICY_TIMED)
+            timed_table_unreserve(thread->cpu,private_data->frequency*(private_data->section_num+1));
+#endif
         acoral_enter_critical();
         acoral_release_res((acoral_res_t *)thread);
         acoral_exit_critical();
@@ -155,9 +453,13 @@ static acoral_id timed_policy_thread_init(acoral_thread_t *thread,void (*route)(
     }
     thread->data = data;
     thread->preempt_type = ACORAL_PREEMPT_TIMED;
+#ifdef CFG_TIMED_TABLE
+    timed_table_add(thread);//表项已在创建开始时预留
+#else
     acoral_enter_critical();
     timed_start_time_reload(thread);
     acoral_exit_critical();
+#endif
     //将线程就绪，并重新调度
     acoral_rdy_thread(thread);
     return thread->res.id;
@@ -188,6 +490,9 @@ void acoral_timed_task(void *args)
 static void timed_policy_thread_release(acoral_thread_t *thread)
 {
     timed_private_data_t *private_data = thread->private_data;
+#ifdef CFG_TIMED_TABLE
+    timed_table_del(thread);
+#endif
     acoral_vol_free(private_data->section_route);
     private_data->section_route = NULL;
     acoral_vol_free(private_data->section_args);
@@ -202,6 +507,36 @@ static void timed_policy_thread_release(acoral_thread_t *thread)
 }
 #include "calculate_time.h"
 #include "measure.h"
+#ifdef CFG_TIMED_TABLE
+/**
+ * @brief 时间确定性线程策略处理函数，分派表模式
+ *
+ */
+static void timed_time_deal()
+{
+#if (MEASURE_SCHED_TIMED == 1)
+    acoral_u8 is_valid_measure = 0;
+    cal_time_start();
+#endif
+    for(acoral_u8 cpu=0;cpu<CFG_MAX_CPU;cpu++)
+    {
+#if (MEASURE_SCHED_TIMED == 1)
+        if(timed_table_deal(cpu))
+            is_valid_measure = 1;
+#else
+        timed_table_deal(cpu);
+#endif
+    }
+#if (MEASURE_SCHED_TIMED == 1)
+    extern during_buffer_t sched_buffer;
+    double during = cal_time_end();
+    if ((during > 0) && (1 == is_valid_measure))
+    {
+        push_during(&sched_buffer, during);
+    }
+#endif
+}
+#else
 /**
  * @brief 时间确定性线程策略处理函数
  * 
@@ -299,6 +634,7 @@ static void timed_time_deal()
     }
 #endif
 }
+#endif
 
 /**
  * @brief 时间确定性线程策略初始化
@@ -309,6 +645,9 @@ void timed_policy_init(void)
     for(acoral_u8 cpu=0;cpu<CFG_MAX_CPU;cpu++)
     {
         acoral_tick_queue_init(&timed_time_queue[cpu]);//初始化时间确定性线程队列
+#if defined(CFG_TIMED_TABLE)&&defined(CFG_SMP)
+        acoral_spin_init(&timed_table[cpu].lock);
+#endif
     }
     timed_policy.type=ACORAL_SCHED_POLICY_TIMED;
     timed_policy.policy_thread_init=timed_policy_thread_init;
@@ -11,6 +11,10 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-07-12 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>tick中处理软件定时器
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>初始化单调时钟
+ *         <tr><td>v1.3 <td>胡博文 <td>2026-10-19 <td>tick中更新cpu占用率窗口
+ *         <tr><td>v1.4 <td>胡博文 <td>2026-10-19 <td>基石时钟中断延迟统计
  */
 #include <hal.h>
 #include <queue.h>
@@ -20,8 +24,17 @@
 #include <lsched.h>
 #include <timer.h>
 #include <print.h>
+#include <clock.h>
+#include <usage.h>
+#include <irq_stat.h>
+#ifdef CFG_SOFT_TIMER
+#include <soft_timer.h>
+#endif
 #include "xscutimer.h"
 
+///私有定时器装载值，不分频时计数频率为cpu频率的一半，1ms到期一次
+#define TICKS_LOAD (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2000)
+
 ///时钟控制结构体
 static XScuTimer acoral_timer;
 ///延时队列
@@ -37,8 +50,14 @@ void acoral_sched(void);
  */
 void acoral_time_sys_init(void)
 {
+    //单调时钟初始化
+    acoral_clock_init();
     //延时队列初始化
 	acoral_tick_queue_init(&time_delay_queue);
+#ifdef CFG_SOFT_TIMER
+    //软件定时器初始化
+    acoral_soft_timer_sys_init();
+#endif
 }
 
 /**
@@ -90,11 +109,30 @@ void acoral_ticks_handler(void *CallBackRef)
         {
             time_delay_deal();//延时链表处理
             acoral_policy_time_deal();//调度处理
+#ifdef CFG_SOFT_TIMER
+            acoral_soft_timer_deal();//软件定时器处理
+#endif
+#ifdef CFG_CPU_USAGE
+            acoral_usage_tick();//cpu占用率窗口
+#endif
         }
         //清楚定时器中断标志位
         XScuTimer_ClearInterruptStatus(TimerInstancePtr);
     }
 }
+#ifdef CFG_IRQ_STAT
+/**
+ * @brief 基石时钟中断延迟，私有定时器自动重装载后从装载值向下计数，已计的数即到期以来的时间
+ *        私有定时器不分频时与全局时钟同为cpu频率的一半，计数即cycles
+ * 
+ * @param data 定时器实例
+ * @return acoral_u32 到期以来的cycles
+ */
+static acoral_u32 ticks_latency(void *data)
+{
+    return TICKS_LOAD - XScuTimer_GetCounterValue((XScuTimer *)data);
+}
+#endif
 /**
  * @brief 基石时钟初始化
  * 
@@ -111,7 +149,10 @@ void acoral_ticks_init()
 
     XScuTimer_EnableAutoReload(&acoral_timer);//使能自动重装载
     XScuTimer_SetPrescaler(&acoral_timer, 0);//设置时钟分频
-    XScuTimer_LoadTimer(&acoral_timer, XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2000);//设置自动装载值
+    XScuTimer_LoadTimer(&acoral_timer, TICKS_LOAD);//设置自动装载值
+#ifdef CFG_IRQ_STAT
+    acoral_irq_stat_latency_register(XPAR_SCUTIMER_INTR, ticks_latency, &acoral_timer);
+#endif
 
     XScuTimer_EnableInterrupt( &acoral_timer );//时钟使能中断
     XScuTimer_Start(&acoral_timer);//启动时钟
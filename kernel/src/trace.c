@@ -0,0 +1,212 @@
+/**
+ * @file trace.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层事件追踪源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>每cpu无锁追踪环形缓冲区
+ */
+#include <acoral.h>
+
+#ifdef CFG_TRACE
+#if (CFG_TRACE_RING_SIZE&(CFG_TRACE_RING_SIZE-1))
+#error "CFG_TRACE_RING_SIZE must be power of 2"
+#endif
+
+///各cpu追踪环形缓冲区
+static acoral_trace_ring_t trace_ring[CFG_MAX_CPU];
+///开启的追踪类别掩码
+volatile acoral_u32 acoral_trace_mask = CFG_TRACE_MASK;
+///缓冲区满时的处理方式
+static volatile acoral_u8 trace_mode = CFG_TRACE_MODE;
+#ifdef CFG_SMP
+///读取者自旋锁，多个读取者互斥推进tail，写入者不使用
+static acoral_spinlock_t trace_read_lock;
+#endif
+
+/**
+ * @brief 在本cpu的追踪缓冲区中记录一个事件，可在中断和调度器中调用
+ *
+ * @param type 事件类型
+ * @param arg0 事件参数0
+ * @param arg1 事件参数1
+ * @param arg2 事件参数2
+ */
+void acoral_trace_record(acoral_u16 type, acoral_u32 arg0, acoral_u32 arg1, acoral_u32 arg2)
+{
+    acoral_u32 cpu,flags,head;
+    acoral_trace_ring_t *ring;
+    acoral_trace_rec_t *rec;
+    flags=acoral_intr_save();//只有本cpu写入，屏蔽本cpu的嵌套中断即可，不需要锁
+    cpu=acoral_current_cpu;
+    ring=&trace_ring[cpu];
+    head=ring->head;
+    if(trace_mode==ACORAL_TRACE_MODE_STOP&&head-ring->tail>=CFG_TRACE_RING_SIZE)
+    {
+        ring->dropped++;
+        acoral_intr_restore_flags(flags);
+        return;
+    }
+    rec=&ring->rec[head&(CFG_TRACE_RING_SIZE-1)];
+    rec->ts=acoral_clock_cycles();
+    rec->type=type;
+    rec->cpu=cpu;
+    rec->arg0=arg0;
+    rec->arg1=arg1;
+    rec->arg2=arg2;
+    acoral_dmb();//记录内容先于head对读取者可见
+    ring->head=head+1;
+    acoral_intr_restore_flags(flags);
+}
+
+/**
+ * @brief 设置开启的追踪类别
+ *
+ * @param mask 类别掩码，ACORAL_TRACE_CLASS_*的组合
+ */
+void acoral_trace_set_mask(acoral_u32 mask)
+{
+    acoral_trace_mask=mask;
+}
+
+/**
+ * @brief 获取开启的追踪类别
+ *
+ * @return acoral_u32 类别掩码
+ */
+acoral_u32 acoral_trace_get_mask(void)
+{
+    return acoral_trace_mask;
+}
+
+/**
+ * @brief 设置缓冲区满时的处理方式
+ *
+ * @param mode ACORAL_TRACE_MODE_OVERWRITE或ACORAL_TRACE_MODE_STOP
+ */
+void acoral_trace_set_mode(acoral_u8 mode)
+{
+    trace_mode=mode;
+}
+
+/**
+ * @brief 丢弃所有未读取的记录并清零丢失计数
+ *
+ */
+void acoral_trace_reset(void)
+{
+    acoral_u32 cpu;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&trace_read_lock);
+#endif
+    for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+    {
+        trace_ring[cpu].tail=trace_ring[cpu].head;
+        trace_ring[cpu].overwritten=0;
+        trace_ring[cpu].dropped=0;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&trace_read_lock);
+#endif
+    acoral_exit_critical();
+}
+
+/**
+ * @brief 复制序号[start,end)的记录，复制后再读head，丢掉复制期间可能被覆盖的开头部分
+ *
+ * @param ring 环形缓冲区
+ * @param start 起始序号
+ * @param end 结束序号
+ * @param buf 输出缓冲区，至少end-start个记录
+ * @param first 返回第一个有效记录的序号
+ * @return acoral_u32 有效记录个数
+ */
+static acoral_u32 trace_copy(acoral_trace_ring_t *ring, acoral_u32 start, acoral_u32 end, acoral_trace_rec_t *buf, acoral_u32 *first)
+{
+    acoral_u32 i,head,valid,skip;
+    for(i=start;i!=end;i++)
+        buf[i-start]=ring->rec[i&(CFG_TRACE_RING_SIZE-1)];
+    acoral_dmb();
+    head=ring->head;
+    //序号head的记录可能正在写入，它与序号head-size共用一个槽，因此有效记录从head-size+1开始
+    valid=head>=CFG_TRACE_RING_SIZE?head-CFG_TRACE_RING_SIZE+1:0;
+    skip=0;
+    if((acoral_32)(valid-start)>0)
+        skip=valid-start<end-start?valid-start:end-start;
+    for(i=skip;i<end-start;i++)
+        buf[i-skip]=buf[i];
+    *first=start+skip;
+    return end-start-skip;
+}
+
+/**
+ * @brief 获取某cpu最近的记录，不推进读取位置；返回的记录在复制期间没有被覆盖
+ *
+ * @param cpu cpu号
+ * @param buf 输出缓冲区
+ * @param num 输出缓冲区可容纳的记录数
+ * @param lost 返回至今丢失的记录数，可为NULL
+ * @return acoral_u32 复制的记录数，按时间顺序
+ */
+acoral_u32 acoral_trace_snapshot(acoral_u32 cpu, acoral_trace_rec_t *buf, acoral_u32 num, acoral_u32 *lost)
+{
+    acoral_trace_ring_t *ring;
+    acoral_u32 head,start,first,cnt;
+    if(cpu>=CFG_MAX_CPU||buf==NULL)
+        return 0;
+    ring=&trace_ring[cpu];
+    head=ring->head;
+    acoral_dmb();
+    if(num>CFG_TRACE_RING_SIZE)
+        num=CFG_TRACE_RING_SIZE;
+    start=head-ring->tail<num?ring->tail:head-num;
+    cnt=trace_copy(ring,start,head,buf,&first);
+    if(lost!=NULL)
+        *lost=ring->dropped+ring->overwritten;
+    return cnt;
+}
+
+/**
+ * @brief 读取某cpu未读取的记录并推进读取位置；覆盖模式下读取太慢时跳过已被覆盖的记录并计入丢失
+ *
+ * @param cpu cpu号
+ * @param buf 输出缓冲区
+ * @param num 输出缓冲区可容纳的记录数
+ * @param lost 返回至今丢失的记录数，可为NULL
+ * @return acoral_u32 读取的记录数，按时间顺序
+ */
+acoral_u32 acoral_trace_read(acoral_u32 cpu, acoral_trace_rec_t *buf, acoral_u32 num, acoral_u32 *lost)
+{
+    acoral_trace_ring_t *ring;
+    acoral_u32 head,tail,end,first,cnt;
+    if(cpu>=CFG_MAX_CPU||buf==NULL)
+        return 0;
+    ring=&trace_ring[cpu];
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&trace_read_lock);
+#endif
+    head=ring->head;
+    acoral_dmb();
+    tail=ring->tail;
+    end=head-tail>num?tail+num:head;
+    cnt=trace_copy(ring,tail,end,buf,&first);
+    ring->overwritten+=first-tail;
+    acoral_dmb();//复制完成后才释放槽给停止模式的写入者
+    ring->tail=first+cnt;
+    if(lost!=NULL)
+        *lost=ring->dropped+ring->overwritten;
+#ifdef CFG_SMP
+    acoral_spin_unlock(&trace_read_lock);
+#endif
+    acoral_exit_critical();
+    return cnt;
+}
+#endif
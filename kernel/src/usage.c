@@ -0,0 +1,470 @@
+/**
+ * @file usage.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层cpu时间统计源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>线程运行时间与各核空闲/中断/内核时间统计
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>时钟中断只结束cpu窗口，线程占用率在查询时结算
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>报告复制线程名字而不是指针
+ */
+#include <acoral.h>
+
+#ifdef CFG_CPU_USAGE
+///千分比打印参数
+#define USAGE_PM(x) (x)/10,(x)%10
+
+/**
+ * @brief 每cpu记账状态，记账字段只由所在cpu关中断写入，写入前后各加一次序号，读取者序号变化时重读
+ *
+ */
+typedef struct{
+    volatile acoral_u32 seq;///<写入序号，奇数表示正在写入
+    acoral_u32 depth;///<中断嵌套深度
+    acoral_u64 last;///<上次记账时刻，0表示还没有开始
+    acoral_usage_time_t total;///<累计时间，不含last以后的部分
+    acoral_usage_time_t mark;///<上个窗口结束时的累计时间，只由窗口更新者写入
+    acoral_usage_time_t window;///<上个窗口内的时间，只由窗口更新者写入
+}__attribute__((aligned(ACORAL_CACHE_LINE_SIZE))) usage_cpu_t;
+
+/**
+ * @brief 报告中的一个线程
+ *
+ */
+typedef struct{
+    acoral_char name[ACORAL_REPORT_NAME_LEN];///<名字，复制一份，打印时线程可能已被回收
+    acoral_id id;///<线程id
+    acoral_u32 cpu;///<所在cpu
+    acoral_u8 prio;///<优先级
+    acoral_u32 load;///<最近两次结算之间的占用率(千分比)
+    acoral_u32 ms;///<累计运行时间(ms)
+}usage_entry_t;
+
+///各cpu记账状态
+static usage_cpu_t usage_cpu[CFG_MAX_CPU];
+///当前窗口开始时刻，0表示还没有开始，只由cpu0时钟中断写入
+static acoral_u64 usage_window_start;
+///上个窗口的长度(cycles)
+static acoral_u64 usage_window_len;
+///窗口结果写入序号，奇数表示正在写入，读取者序号变化时重读
+static volatile acoral_u32 usage_window_seq;
+///已结束的窗口数
+static volatile acoral_u32 usage_window_num;
+///线程占用率最近一次结算时的窗口数
+static acoral_u32 usage_thread_num;
+///线程占用率最近一次结算的时刻
+static acoral_u64 usage_thread_start;
+///线程占用率的统计长度(cycles)，即最近两次结算之间的时间
+static acoral_u64 usage_thread_len;
+#ifdef CFG_SMP
+///线程结算自旋锁，结算者与查询者共用，只在线程上下文使用
+static acoral_spinlock_t usage_lock;
+#endif
+
+/**
+ * @brief 线程运行时间计入的分类
+ *
+ * @param t 时间分类
+ * @param thread 线程
+ * @return acoral_u64* 分类
+ */
+static acoral_u64 *usage_bucket(acoral_usage_time_t *t, acoral_thread_t *thread)
+{
+    if(thread->prio==ACORAL_IDLE_PRIO)
+        return &t->idle;
+    if(thread->usage_kernel)
+        return &t->kernel;
+    return &t->thread;
+}
+
+/**
+ * @brief 把上次记账以来的时间记到中断或线程上，调用者关中断且处于写入中
+ *
+ * @param uc 本cpu记账状态
+ * @param thread 正在运行的线程
+ * @param now 当前时刻
+ */
+static void usage_charge(usage_cpu_t *uc, acoral_thread_t *thread, acoral_u64 now)
+{
+    acoral_u64 delta;
+    if(uc->last!=0&&thread!=NULL)
+    {
+        delta=now-uc->last;
+        if(uc->depth>0)
+            uc->total.irq+=delta;
+        else
+        {
+            thread->run_cycles+=delta;
+            *usage_bucket(&uc->total,thread)+=delta;
+        }
+    }
+    uc->last=now;
+}
+
+/**
+ * @brief 线程切换时记账，在切换上下文时调用
+ *
+ * @param prev 被换出的线程
+ */
+void acoral_usage_switch(acoral_thread_t *prev)
+{
+    acoral_u32 flags=acoral_intr_save();
+    usage_cpu_t *uc=&usage_cpu[acoral_current_cpu];
+    uc->seq++;
+    acoral_dmb();
+    usage_charge(uc,prev,acoral_clock_cycles());
+    acoral_dmb();
+    uc->seq++;
+    acoral_intr_restore_flags(flags);
+}
+
+/**
+ * @brief 进入中断时记账，最外层中断之前的时间记到被打断的线程上
+ *
+ */
+void acoral_usage_irq_enter(void)
+{
+    acoral_u32 flags=acoral_intr_save();
+    usage_cpu_t *uc=&usage_cpu[acoral_current_cpu];
+    uc->seq++;
+    acoral_dmb();
+    usage_charge(uc,acoral_cur_thread,acoral_clock_cycles());
+    uc->depth++;
+    acoral_dmb();
+    uc->seq++;
+    acoral_intr_restore_flags(flags);
+}
+
+/**
+ * @brief 退出中断时记账，中断服务时间记到中断上
+ *
+ */
+void acoral_usage_irq_exit(void)
+{
+    acoral_u32 flags=acoral_intr_save();
+    usage_cpu_t *uc=&usage_cpu[acoral_current_cpu];
+    uc->seq++;
+    acoral_dmb();
+    usage_charge(uc,acoral_cur_thread,acoral_clock_cycles());
+    if(uc->depth>0)
+        uc->depth--;
+    acoral_dmb();
+    uc->seq++;
+    acoral_intr_restore_flags(flags);
+}
+
+/**
+ * @brief 读取某cpu的累计时间和线程的累计运行时间，加上正在进行还没有记账的部分，可在任意cpu调用
+ *
+ * @param cpu cpu号
+ * @param thread 线程，可为NULL
+ * @param total 返回该cpu的累计时间
+ * @return acoral_u64 线程的累计运行时间，thread为NULL时为0
+ */
+static acoral_u64 usage_read(acoral_u32 cpu, acoral_thread_t *thread, acoral_usage_time_t *total)
+{
+    usage_cpu_t *uc=&usage_cpu[cpu];
+    acoral_thread_t *cur;
+    acoral_u32 seq,depth;
+    acoral_u64 last,now,run,delta;
+    while(1)
+    {
+        seq=uc->seq;
+        acoral_dmb();
+        if(seq&1)
+            continue;
+        *total=uc->total;
+        last=uc->last;
+        depth=uc->depth;
+        cur=running_thread[cpu];
+        run=thread!=NULL?thread->run_cycles:0;
+        now=acoral_clock_cycles();
+        acoral_dmb();
+        if(uc->seq==seq)
+            break;
+    }
+    if(last==0||cur==NULL)
+        return run;
+    delta=now-last;
+    if(depth>0)
+        total->irq+=delta;
+    else
+    {
+        *usage_bucket(total,cur)+=delta;
+        if(cur==thread)
+            run+=delta;
+    }
+    return run;
+}
+
+/**
+ * @brief 结束当前统计窗口，计算各cpu在窗口内的时间，在cpu0时钟中断中调用
+ *
+ * 不遍历线程也不取线程队列锁，线程的占用率在查询时结算
+ *
+ * @param now 当前时刻
+ */
+static void usage_roll(acoral_u64 now)
+{
+    acoral_usage_time_t total;
+    acoral_u32 cpu;
+    usage_cpu_t *uc;
+    usage_window_seq++;
+    acoral_dmb();
+    for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+    {
+        uc=&usage_cpu[cpu];
+        usage_read(cpu,NULL,&total);
+        uc->window.thread=total.thread-uc->mark.thread;
+        uc->window.kernel=total.kernel-uc->mark.kernel;
+        uc->window.irq=total.irq-uc->mark.irq;
+        uc->window.idle=total.idle-uc->mark.idle;
+        uc->mark=total;
+    }
+    usage_window_len=now-usage_window_start;
+    usage_window_start=now;
+    usage_window_num++;
+    acoral_dmb();
+    usage_window_seq++;
+}
+
+/**
+ * @brief 时钟中断中调用，每CFG_CPU_USAGE_WINDOW毫秒结束一个统计窗口
+ *
+ */
+void acoral_usage_tick(void)
+{
+    acoral_u64 now=acoral_clock_cycles();
+    if(usage_window_start==0)
+    {
+        usage_window_start=now;
+        usage_thread_start=now;//第一次结算前不会有结算者写入
+        return;
+    }
+    if(now-usage_window_start>=acoral_us_to_cycles((acoral_u64)CFG_CPU_USAGE_WINDOW*1000))
+        usage_roll(now);
+}
+
+/**
+ * @brief 读取一个cpu上个窗口内的时间和窗口长度，可在任意cpu调用
+ *
+ * @param cpu cpu号
+ * @param window 返回窗口内的时间
+ * @return acoral_u64 窗口长度，0表示还没有完整窗口
+ */
+static acoral_u64 usage_window_read(acoral_u32 cpu, acoral_usage_time_t *window)
+{
+    acoral_u32 seq;
+    acoral_u64 len;
+    while(1)
+    {
+        seq=usage_window_seq;
+        acoral_dmb();
+        if(seq&1)
+            continue;
+        *window=usage_cpu[cpu].window;
+        len=usage_window_len;
+        acoral_dmb();
+        if(usage_window_seq==seq)
+            break;
+    }
+    return len;
+}
+
+/**
+ * @brief 结算各线程自上次结算以来的运行时间，距上次结算至少结束过一个窗口时才进行
+ *
+ * 只在线程上下文调用，调用者已进入临界区并持有usage_lock
+ *
+ */
+static void usage_thread_roll(void)
+{
+    acoral_usage_time_t total;
+    acoral_list_t *tmp,*head;
+    acoral_thread_t *thread;
+    acoral_u64 run,now;
+    if(usage_thread_num==usage_window_num)
+        return;
+    now=acoral_clock_cycles();
+    head=&acoral_threads_queue.head;
+#ifdef CFG_SMP
+    acoral_spin_lock(&acoral_threads_queue.lock);
+#endif
+    for(tmp=head->next;tmp!=head;tmp=tmp->next)
+    {
+        thread=list_entry(tmp,acoral_thread_t,global_list);
+        run=usage_read(thread->cpu,thread,&total);
+        thread->run_window=run-thread->run_mark;
+        thread->run_mark=run;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&acoral_threads_queue.lock);
+#endif
+    usage_thread_len=now-usage_thread_start;
+    usage_thread_start=now;
+    usage_thread_num=usage_window_num;
+}
+
+/**
+ * @brief 把线程标记为内核服务线程，其运行时间计入内核时间
+ *
+ * @param thread_id 线程id
+ */
+void acoral_usage_set_kernel_by_id(acoral_id thread_id)
+{
+    acoral_thread_t *thread=(acoral_thread_t *)acoral_get_res_by_id(thread_id);
+    if(thread!=NULL)
+        thread->usage_kernel=1;
+}
+
+/**
+ * @brief 获取线程的累计运行时间，含正在运行还没有记账的部分
+ *
+ * @param thread 线程tcb指针
+ * @return acoral_u64 运行时间(cycles)
+ */
+acoral_u64 acoral_usage_thread_cycles(acoral_thread_t *thread)
+{
+    acoral_usage_time_t total;
+    if(thread==NULL||thread->cpu>=CFG_MAX_CPU)
+        return 0;
+    return usage_read(thread->cpu,thread,&total);
+}
+
+/**
+ * @brief 获取线程在最近两次结算之间占所在cpu的比例，只在线程上下文调用
+ *
+ * 结算在查询时进行，距上次结算至少结束过一个窗口，查询间隔较长时为这段时间内的平均值
+ *
+ * @param thread 线程tcb指针
+ * @return acoral_u32 千分比，还没有结算过时为0
+ */
+acoral_u32 acoral_usage_thread_load(acoral_thread_t *thread)
+{
+    acoral_u32 load=0;
+    if(thread==NULL)
+        return 0;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&usage_lock);
+#endif
+    usage_thread_roll();
+    if(usage_thread_len!=0)
+        load=(acoral_u32)(thread->run_window*1000/usage_thread_len);
+#ifdef CFG_SMP
+    acoral_spin_unlock(&usage_lock);
+#endif
+    acoral_exit_critical();
+    return load;
+}
+
+/**
+ * @brief 获取cpu的累计时间和上个统计窗口内的时间
+ *
+ * @param cpu cpu号
+ * @param stat 返回统计
+ * @return acoral_err 错误检测
+ */
+acoral_err acoral_usage_cpu_get(acoral_u32 cpu, acoral_usage_cpu_t *stat)
+{
+    if(stat==NULL)
+        return KR_STAT_ERR_NULL;
+    if(cpu>=CFG_MAX_CPU)
+        return KR_STAT_ERR_CPU;
+    usage_read(cpu,NULL,&stat->total);
+    stat->window_len=usage_window_read(cpu,&stat->window);
+    return KR_OK;
+}
+
+/**
+ * @brief 获取cpu在上个统计窗口内的非空闲比例
+ *
+ * @param cpu cpu号
+ * @return acoral_u32 千分比，还没有完整窗口时为0
+ */
+acoral_u32 acoral_usage_cpu_load(acoral_u32 cpu)
+{
+    acoral_usage_cpu_t stat;
+    if(acoral_usage_cpu_get(cpu,&stat)!=KR_OK||stat.window_len==0||stat.window.idle>=stat.window_len)
+        return 0;
+    return (acoral_u32)((stat.window_len-stat.window.idle)*1000/stat.window_len);
+}
+
+/**
+ * @brief 打印各cpu上个统计窗口和各线程最近两次结算之间的占用率，线程按占用率从高到低排列
+ *
+ */
+void acoral_usage_report(void)
+{
+    static usage_entry_t entry[CFG_MAX_THREAD];//不放在调用者栈上，shell栈较小
+    acoral_usage_cpu_t stat;
+    acoral_list_t *tmp,*head;
+    acoral_thread_t *thread;
+    usage_entry_t e;
+    acoral_usage_time_t total;
+    acoral_u32 cpu,num=0,i,j;
+    acoral_u64 len;
+    for(cpu=0;cpu<CFG_MAX_CPU;cpu++)
+    {
+        acoral_usage_cpu_get(cpu,&stat);
+        if(cpu==0)
+        {
+            acoral_print("window %u ms\r\n",(acoral_u32)acoral_cycles_to_ms(stat.window_len));
+            acoral_print("%-6s%8s%8s%8s%8s%8s\r\n","cpu","busy%","thread%","kernel%","irq%","idle%");
+        }
+        len=stat.window_len?stat.window_len:1;
+        acoral_print("%-6u%6u.%u%6u.%u%6u.%u%6u.%u%6u.%u\r\n",cpu,
+                     USAGE_PM(acoral_usage_cpu_load(cpu)),
+                     USAGE_PM((acoral_u32)(stat.window.thread*1000/len)),
+                     USAGE_PM((acoral_u32)(stat.window.kernel*1000/len)),
+                     USAGE_PM((acoral_u32)(stat.window.irq*1000/len)),
+                     USAGE_PM((acoral_u32)(stat.window.idle*1000/len)));
+    }
+    head=&acoral_threads_queue.head;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&usage_lock);
+#endif
+    usage_thread_roll();
+    len=usage_thread_len;
+#ifdef CFG_SMP
+    acoral_spin_lock(&acoral_threads_queue.lock);
+#endif
+    for(tmp=head->next;tmp!=head&&num<CFG_MAX_THREAD;tmp=tmp->next)
+    {
+        thread=list_entry(tmp,acoral_thread_t,global_list);
+        acoral_str_lcpy(entry[num].name,thread->name,sizeof(entry[num].name));
+        entry[num].id=thread->res.id;
+        entry[num].cpu=thread->cpu;
+        entry[num].prio=thread->prio;
+        entry[num].load=len?(acoral_u32)(thread->run_window*1000/len):0;
+        entry[num].ms=(acoral_u32)acoral_cycles_to_ms(usage_read(thread->cpu,thread,&total));
+        num++;
+    }
+#ifdef CFG_SMP
+    acoral_spin_unlock(&acoral_threads_queue.lock);
+    acoral_spin_unlock(&usage_lock);
+#endif
+    acoral_exit_critical();
+    for(i=1;i<num;i++)//插入排序，线程数不多
+    {
+        e=entry[i];
+        for(j=i;j>0&&entry[j-1].load<e.load;j--)
+            entry[j]=entry[j-1];
+        entry[j]=e;
+    }
+    acoral_print("threads over last %u ms\r\n",(acoral_u32)acoral_cycles_to_ms(len));
+    acoral_print("%-20s%6s%5s%6s%8s%12s\r\n","name","id","cpu","prio","cpu%","total_ms");
+    for(i=0;i<num;i++)
+    {
+        acoral_print("%-20s%6d%5u%6u%6u.%u%12u\r\n",entry[i].name,entry[i].id,entry[i].cpu,entry[i].prio,
+                     USAGE_PM(entry[i].load),entry[i].ms);
+    }
+}
+#endif
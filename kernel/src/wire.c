@@ -0,0 +1,93 @@
+/**
+ * @file wire.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief kernel层串口紧凑编码帧源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>从monitor中拆出，供追踪与二进制日志共用
+ */
+#include <acoral.h>
+#include <wire.h>
+#ifdef CFG_UART_TX_RING
+#include "uart.h"
+#endif
+
+#ifdef CFG_WIRE
+///帧头字节数
+#define WIRE_HEAD 6
+///CRC字节数
+#define WIRE_CRC 2
+
+///组帧缓冲区
+static acoral_u8 wire_frame[WIRE_HEAD+ACORAL_WIRE_PAYLOAD_MAX+WIRE_CRC];
+///帧序号，所有发送者共用，接收端据此发现丢帧
+static acoral_u8 wire_seq;
+#ifdef CFG_SMP
+///组帧自旋锁
+static acoral_spinlock_t wire_lock;
+#endif
+
+/**
+ * @brief 计算CRC16-CCITT
+ *
+ * @param crc 初值
+ * @param data 数据
+ * @param len 字节数
+ * @return acoral_u16 CRC
+ */
+static acoral_u16 wire_crc16(acoral_u16 crc, const acoral_u8 *data, acoral_u32 len)
+{
+    acoral_u32 i;
+    while(len-->0)
+    {
+        crc^=(acoral_u16)(*data++)<<8;
+        for(i=0;i<8;i++)
+            crc=crc&0x8000?(crc<<1)^0x1021:crc<<1;
+    }
+    return crc;
+}
+
+/**
+ * @brief 加上帧头、序号和CRC后发送一帧；使用串口发送缓冲区时不等待，缓冲区满则整帧丢弃
+ *
+ * @param type 帧类型
+ * @param payload 负载
+ * @param len 负载字节数，不超过ACORAL_WIRE_PAYLOAD_MAX
+ */
+void acoral_wire_send(acoral_u8 type, const acoral_u8 *payload, acoral_u32 len)
+{
+    acoral_u16 crc;
+    if(len>ACORAL_WIRE_PAYLOAD_MAX)
+        return;
+    acoral_enter_critical();
+#ifdef CFG_SMP
+    acoral_spin_lock(&wire_lock);
+#endif
+    wire_frame[0]=ACORAL_WIRE_MAGIC0;
+    wire_frame[1]=ACORAL_WIRE_MAGIC1;
+    wire_frame[2]=type;
+    wire_frame[3]=wire_seq++;
+    wire_frame[4]=len&0xFF;
+    wire_frame[5]=(len>>8)&0xFF;
+    acoral_memcpy(&wire_frame[WIRE_HEAD],payload,len);
+    crc=wire_crc16(0xFFFF,&wire_frame[2],len+WIRE_HEAD-2);
+    wire_frame[WIRE_HEAD+len]=crc&0xFF;
+    wire_frame[WIRE_HEAD+len+1]=crc>>8;
+#ifdef CFG_UART_TX_RING
+    acoral_uart_write_nb(wire_frame,WIRE_HEAD+len+WIRE_CRC);//只拷贝进发送缓冲区，持锁时间短
+#else
+    for(acoral_u32 i=0;i<WIRE_HEAD+len+WIRE_CRC;i++)
+        outbyte(wire_frame[i]);
+#endif
+#ifdef CFG_SMP
+    acoral_spin_unlock(&wire_lock);
+#endif
+    acoral_exit_critical();
+}
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file hal_clock_c.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief hal层全局定时器相关源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>全局定时器作为单调时钟源
+ */
+#include <type.h>
+#include <hal_clock.h>
+#include "xil_io.h"
+
+/**
+ * @brief 全局定时器初始化
+ *
+ * 只在未运行时清除预分频并使能计数，已在运行的计数器不会被清零或停止，
+ * 保证系统运行期间时钟单调递增
+ */
+void hal_clock_init(void)
+{
+    acoral_u32 ctrl;
+    ctrl=Xil_In32(HAL_GTC_BASE+HAL_GTC_CTRL);
+    if(ctrl&HAL_GTC_CTRL_ENABLE)
+        return;
+    ctrl&=~HAL_GTC_CTRL_PRESCALER;//不分频
+    Xil_Out32(HAL_GTC_BASE+HAL_GTC_CTRL,ctrl|HAL_GTC_CTRL_ENABLE);
+}
+
+/**
+ * @brief 读取全局定时器64位计数值
+ *
+ * 高低32位需分两次读取，按高-低-高的顺序读，两次高位不一致说明低位发生了进位，需重读
+ *
+ * @return acoral_u64 计数值
+ */
+acoral_u64 hal_clock_read(void)
+{
+    acoral_u32 high,low,high_again;
+    high=Xil_In32(HAL_GTC_BASE+HAL_GTC_DATH);
+    while(1)
+    {
+        low=Xil_In32(HAL_GTC_BASE+HAL_GTC_DATL);
+        high_again=Xil_In32(HAL_GTC_BASE+HAL_GTC_DATH);
+        if(high==high_again)
+            break;
+        high=high_again;
+    }
+    return ((acoral_u64)high<<32)|low;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file hal_pmu_c.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief hal层性能监控单元相关源文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>Cortex-A9 PMU cycle计数器与事件计数器
+ */
+#include <type.h>
+#include <hal_pmu.h>
+
+///读PMU寄存器，均位于cp15 c9
+#define PMU_MRC(crm,op2,value) __asm__ __volatile__("mrc p15, 0, %0, c9, " #crm ", " #op2 : "=r"(value))
+///写PMU寄存器
+#define PMU_MCR(crm,op2,value) __asm__ __volatile__("mcr p15, 0, %0, c9, " #crm ", " #op2 : : "r"(value) : "memory")
+///指令同步屏障，选择寄存器写入后再访问被选择的计数器
+#define PMU_ISB() __asm__ __volatile__("isb": : :"memory")
+
+/**
+ * @brief 本核PMU初始化，停止并清零全部计数器，关闭溢出中断
+ *
+ * PMU是每核私有的，每个核都要调用，QEMU等不模拟事件的平台事件计数器个数为0
+ *
+ * @return acoral_u32 事件计数器个数
+ */
+acoral_u32 hal_pmu_init(void)
+{
+    acoral_u32 pmcr;
+    PMU_MCR(c12,2,0xffffffff);//PMCNTENCLR，停止全部计数器
+    PMU_MCR(c14,2,0xffffffff);//PMINTENCLR，关闭全部溢出中断
+    PMU_MCR(c12,3,0xffffffff);//PMOVSR，清除溢出标志
+    PMU_MRC(c12,0,pmcr);
+    pmcr&=~HAL_PMU_PMCR_D;//cycle计数器不分频
+    pmcr|=HAL_PMU_PMCR_E|HAL_PMU_PMCR_P|HAL_PMU_PMCR_C;
+    PMU_MCR(c12,0,pmcr);
+    PMU_ISB();
+    return (pmcr>>HAL_PMU_PMCR_N_SHIFT)&HAL_PMU_PMCR_N_MASK;
+}
+
+/**
+ * @brief 设置事件计数器所计的事件
+ *
+ * @param idx 事件计数器号
+ * @param event 事件号
+ */
+void hal_pmu_event_set(acoral_u32 idx, acoral_u32 event)
+{
+    PMU_MCR(c12,5,idx);//PMSELR
+    PMU_ISB();
+    PMU_MCR(c13,1,event);//PMXEVTYPER
+}
+
+/**
+ * @brief 读取事件计数器
+ *
+ * @param idx 事件计数器号
+ * @return acoral_u32 计数值
+ */
+acoral_u32 hal_pmu_event_read(acoral_u32 idx)
+{
+    acoral_u32 value;
+    PMU_MCR(c12,5,idx);//PMSELR
+    PMU_ISB();
+    PMU_MRC(c13,2,value);//PMXEVCNTR
+    return value;
+}
+
+/**
+ * @brief 写入事件计数器
+ *
+ * @param idx 事件计数器号
+ * @param value 计数值
+ */
+void hal_pmu_event_write(acoral_u32 idx, acoral_u32 value)
+{
+    PMU_MCR(c12,5,idx);//PMSELR
+    PMU_ISB();
+    PMU_MCR(c13,2,value);//PMXEVCNTR
+}
+
+/**
+ * @brief 读取cycle计数器
+ *
+ * @return acoral_u32 计数值
+ */
+acoral_u32 hal_pmu_cycles_read(void)
+{
+    acoral_u32 value;
+    PMU_MRC(c13,0,value);//PMCCNTR
+    return value;
+}
+
+/**
+ * @brief 写入cycle计数器
+ *
+ * @param value 计数值
+ */
+void hal_pmu_cycles_write(acoral_u32 value)
+{
+    PMU_MCR(c13,0,value);//PMCCNTR
+}
+
+/**
+ * @brief 使能计数器
+ *
+ * @param mask 计数器位，cycle计数器为HAL_PMU_CYCLES_BIT
+ */
+void hal_pmu_counter_enable(acoral_u32 mask)
+{
+    PMU_MCR(c12,1,mask);//PMCNTENSET
+}
+
+/**
+ * @brief 使能计数器溢出中断
+ *
+ * @param mask 计数器位，cycle计数器为HAL_PMU_CYCLES_BIT
+ */
+void hal_pmu_intr_enable(acoral_u32 mask)
+{
+    PMU_MCR(c14,1,mask);//PMINTENSET
+}
+
+/**
+ * @brief 读取并清除溢出标志
+ *
+ * @return acoral_u32 清除前的溢出标志
+ */
+acoral_u32 hal_pmu_overflow_clear(void)
+{
+    acoral_u32 value;
+    PMU_MRC(c12,3,value);//PMOVSR
+    PMU_MCR(c12,3,value);//写1清除
+    return value;
+}
@@ -11,6 +11,8 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-06-26 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>增加全局定时器时钟源
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>增加性能监控单元
  */
 #ifndef HAL_H
 #define HAL_H
@@ -18,6 +20,8 @@
 #include <hal_int.h>
 #include <hal_mem.h>
 #include <hal_thread.h>
+#include <hal_clock.h>
+#include <hal_pmu.h>
 #ifdef CFG_SMP
 #include <hal_cmp.h>
 #include <hal_spinlock.h>
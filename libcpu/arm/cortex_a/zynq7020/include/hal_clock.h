@@ -0,0 +1,44 @@
+/**
+ * @file hal_clock.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief hal层全局定时器相关头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>全局定时器作为单调时钟源
+ */
+#ifndef HAL_CLOCK_H
+#define HAL_CLOCK_H
+#include <type.h>
+#include <config.h>
+#include "xparameters.h"
+
+///全局定时器基地址，位于SCU私有外设区，两个核共享同一个计数器
+#define HAL_GTC_BASE 0xF8F00200
+///全局定时器计数值低32位寄存器偏移
+#define HAL_GTC_DATL 0x00
+///全局定时器计数值高32位寄存器偏移
+#define HAL_GTC_DATH 0x04
+///全局定时器控制寄存器偏移
+#define HAL_GTC_CTRL 0x08
+///全局定时器控制寄存器：计数使能位
+#define HAL_GTC_CTRL_ENABLE 0x01
+///全局定时器控制寄存器：预分频位域
+#define HAL_GTC_CTRL_PRESCALER 0xff00
+
+///全局定时器计数频率(Hz)，为cpu频率的一半
+#define HAL_CLOCK_HZ (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ/2)
+
+void hal_clock_init(void);
+acoral_u64 hal_clock_read(void);
+
+///重定义全局定时器初始化函数，为上层使用
+#define HAL_CLOCK_INIT() hal_clock_init()
+///重定义读取全局定时器64位计数值函数，为上层使用
+#define HAL_CLOCK_READ() hal_clock_read()
+#endif
@@ -11,6 +11,7 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-06-26 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>可嵌套的本cpu关中断与恢复
  */
 
 #ifndef HAL_INT_H
@@ -36,4 +37,33 @@ void hal_intr_restore(void);
 ///重定义恢复中断函数
 #define HAL_INTR_RESTORE() hal_intr_restore()
 
+/**
+ * @brief 关闭本cpu的IRQ，返回关闭前的CPSR，可在关中断状态下嵌套使用
+ *
+ * @return acoral_u32 关闭前的CPSR
+ */
+static inline acoral_u32 hal_intr_save(void)
+{
+    acoral_u32 cpsr;
+    __asm__ __volatile__("mrs %0, cpsr\n"
+                         "cpsid i\n"
+                         : "=r"(cpsr) : : "memory");
+    return cpsr;
+}
+
+/**
+ * @brief 恢复hal_intr_save保存的CPSR控制域
+ *
+ * @param cpsr hal_intr_save的返回值
+ */
+static inline void hal_intr_restore_flags(acoral_u32 cpsr)
+{
+    __asm__ __volatile__("msr cpsr_c, %0" : : "r"(cpsr) : "memory");
+}
+
+///重定义可嵌套关中断函数
+#define HAL_INTR_SAVE() hal_intr_save()
+///重定义可嵌套恢复中断函数
+#define HAL_INTR_RESTORE_FLAGS(cpsr) hal_intr_restore_flags(cpsr)
+
 #endif
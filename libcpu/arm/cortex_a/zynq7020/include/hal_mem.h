@@ -11,6 +11,7 @@
  *     <table>
  *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
  *         <tr><td>v1.0 <td>胡博文 <td>2022-06-26 <td>增加注释
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>cache行大小与数据内存屏障
  */
 
 #ifndef HAL_MEM_H
@@ -26,6 +27,11 @@ extern acoral_u32 _heap_end[];
 ///重定义链接文件中的heap尾，为上层使用
 #define HAL_HEAP_END    _heap_end
 
+///Cortex-A9 L1数据cache行字节数
+#define HAL_CACHE_LINE_SIZE 32
+///数据内存屏障，屏障前的访存对其他cpu先于屏障后的访存可见
+#define HAL_DMB() __asm__ __volatile__("dmb": : :"memory")
+
 void hal_mem_init(void);
 
 ///重定义hal层文件中的内存初始化函数，为上层使用
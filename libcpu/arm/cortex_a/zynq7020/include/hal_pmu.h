@@ -0,0 +1,67 @@
+/**
+ * @file hal_pmu.h
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief hal层性能监控单元相关头文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>Cortex-A9 PMU cycle计数器与事件计数器
+ */
+#ifndef HAL_PMU_H
+#define HAL_PMU_H
+#include <type.h>
+#include <config.h>
+
+///PMCR：全部计数器使能位
+#define HAL_PMU_PMCR_E 0x01
+///PMCR：事件计数器清零位
+#define HAL_PMU_PMCR_P 0x02
+///PMCR：cycle计数器清零位
+#define HAL_PMU_PMCR_C 0x04
+///PMCR：cycle计数器64分频位
+#define HAL_PMU_PMCR_D 0x08
+///PMCR：事件计数器个数位移
+#define HAL_PMU_PMCR_N_SHIFT 11
+///PMCR：事件计数器个数掩码
+#define HAL_PMU_PMCR_N_MASK 0x1f
+///使能、溢出、中断寄存器中cycle计数器的位
+#define HAL_PMU_CYCLES_BIT (1u<<31)
+///使能、溢出、中断寄存器中第idx个事件计数器的位
+#define HAL_PMU_EVENT_BIT(idx) (1u<<(idx))
+///PMU溢出中断号，zynq中cpu0为SPI 37，cpu1为SPI 38
+#define HAL_PMU_IRQ(cpu) (37+(cpu))
+
+acoral_u32 hal_pmu_init(void);
+void hal_pmu_event_set(acoral_u32 idx, acoral_u32 event);
+acoral_u32 hal_pmu_event_read(acoral_u32 idx);
+void hal_pmu_event_write(acoral_u32 idx, acoral_u32 value);
+acoral_u32 hal_pmu_cycles_read(void);
+void hal_pmu_cycles_write(acoral_u32 value);
+void hal_pmu_counter_enable(acoral_u32 mask);
+void hal_pmu_intr_enable(acoral_u32 mask);
+acoral_u32 hal_pmu_overflow_clear(void);
+
+///重定义PMU初始化函数，返回事件计数器个数，为上层使用
+#define HAL_PMU_INIT() hal_pmu_init()
+///重定义设置事件计数器所计事件函数，为上层使用
+#define HAL_PMU_EVENT_SET(idx,event) hal_pmu_event_set(idx,event)
+///重定义读取事件计数器函数，为上层使用
+#define HAL_PMU_EVENT_READ(idx) hal_pmu_event_read(idx)
+///重定义写入事件计数器函数，为上层使用
+#define HAL_PMU_EVENT_WRITE(idx,value) hal_pmu_event_write(idx,value)
+///重定义读取cycle计数器函数，为上层使用
+#define HAL_PMU_CYCLES_READ() hal_pmu_cycles_read()
+///重定义写入cycle计数器函数，为上层使用
+#define HAL_PMU_CYCLES_WRITE(value) hal_pmu_cycles_write(value)
+///重定义使能计数器函数，为上层使用
+#define HAL_PMU_COUNTER_ENABLE(mask) hal_pmu_counter_enable(mask)
+///重定义使能溢出中断函数，为上层使用
+#define HAL_PMU_INTR_ENABLE(mask) hal_pmu_intr_enable(mask)
+///重定义读取并清除溢出标志函数，为上层使用
+#define HAL_PMU_OVERFLOW_CLEAR() hal_pmu_overflow_clear()
+#endif
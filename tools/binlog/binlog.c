@@ -0,0 +1,795 @@
+/**
+ * @file binlog.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief 主机端二进制日志解码工具，用ELF中的格式串格式化目标端发送的日志记录
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>创建文件
+ *
+ * 格式串表来自固件ELF的.acoral_log_fmt段（链接脚本中不加载且地址从0开始，格式串的地址即格式串号），
+ * 也可以来自-t导出的表文件，每行为"格式串号<TAB>转义后的格式串"，构建时导出可避免每次读取ELF。
+ * 输入为kernel/src/wire.c发送的紧凑编码帧，可以是抓取文件、串口设备或PTY，串口设备会被设为raw模式：
+ *   0xA5 0x5A，类型u8，序号u8，负载长度u16，负载，CRC16-CCITT u16(覆盖类型到负载末尾)
+ *   类型4 AcoSimLogBatch，见components/acosim/src/acosim.proto，其他类型的帧只检查CRC和序号
+ * 每条日志输出一行"[cpu 时刻us] 文本"，时刻相对第一条日志；目标端丢弃的记录数变化时输出提示。
+ * 格式化支持%d %i %u %x %X %o %c %p %%，可带标志、宽度和精度，长度修饰符被忽略；参数只有32位整数，
+ * %s无法取得目标端内存，输出为地址。
+ * 退出码：0成功，2输入错误
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <type.h>
+
+///格式串所在段，与kernel/include/binlog.h一致
+#define BL_SECTION ".acoral_log_fmt"
+///紧凑编码帧头长度
+#define BL_WIRE_HEAD 6
+///紧凑编码CRC长度
+#define BL_WIRE_CRC 2
+///负载长度上限，超过视为失步
+#define BL_PAYLOAD_MAX 1024
+///日志帧类型，与kernel/include/wire.h一致
+#define BL_WIRE_LOG 4
+///最大cpu数量
+#define BL_CPU_MAX 8
+///单条日志最多的参数个数，与kernel/include/binlog.h的头字格式一致
+#define BL_ARGS_MAX 15
+///格式化后的最大长度
+#define BL_TEXT_MAX 1024
+
+/**
+ * @brief 格式串
+ *
+ */
+typedef struct{
+    acoral_u32 id;///<格式串号
+    char *fmt;///<格式串
+}bl_fmt_t;
+
+/**
+ * @brief 解码状态
+ *
+ */
+typedef struct{
+    bl_fmt_t *fmt;///<格式串表，按格式串号升序
+    acoral_u32 fmt_num;///<格式串数
+    acoral_u32 fmt_cap;///<格式串表容量
+    double hz;///<时间戳频率
+    acoral_u64 t0;///<第一条日志的时刻
+    acoral_u8 started;///<是否已收到日志
+    acoral_u32 records;///<输出的日志数
+    acoral_u32 unknown;///<格式串号不在表中的日志数
+    acoral_u32 bad;///<失步丢弃的字节数
+    acoral_u32 frames;///<收到的帧数
+    acoral_u32 crc;///<CRC错误的帧数
+    acoral_u32 gap;///<按序号推算丢失的帧数
+    acoral_32 seq;///<上一帧序号，-1表示还没有收到
+    acoral_u32 lost[BL_CPU_MAX];///<各cpu目标端报告的丢弃记录数
+}bl_t;
+
+///Ctrl-C停止读取
+static volatile sig_atomic_t bl_stop;
+
+/**
+ * @brief SIGINT处理，停止读取后照常输出统计
+ *
+ * @param sig 信号
+ */
+static void bl_sigint(int sig)
+{
+    (void)sig;
+    bl_stop=1;
+}
+
+/**
+ * @brief 读取小端u16
+ *
+ * @param p 数据
+ * @return acoral_u32 值
+ */
+static acoral_u32 bl_u16(const acoral_u8 *p)
+{
+    return (acoral_u32)p[0]|((acoral_u32)p[1]<<8);
+}
+
+/**
+ * @brief 读取小端u32
+ *
+ * @param p 数据
+ * @return acoral_u32 值
+ */
+static acoral_u32 bl_u32(const acoral_u8 *p)
+{
+    return (acoral_u32)p[0]|((acoral_u32)p[1]<<8)|((acoral_u32)p[2]<<16)|((acoral_u32)p[3]<<24);
+}
+
+/**
+ * @brief 追加一个格式串
+ *
+ * @param bl 解码状态
+ * @param id 格式串号
+ * @param fmt 格式串
+ * @param len 格式串长度
+ */
+static void bl_fmt_add(bl_t *bl, acoral_u32 id, const char *fmt, size_t len)
+{
+    bl_fmt_t *p;
+    if(bl->fmt_num==bl->fmt_cap)
+    {
+        bl->fmt_cap=bl->fmt_cap?bl->fmt_cap*2:256;
+        p=realloc(bl->fmt,bl->fmt_cap*sizeof(bl_fmt_t));
+        if(p==NULL)
+        {
+            fprintf(stderr,"out of memory\n");
+            exit(2);
+        }
+        bl->fmt=p;
+    }
+    p=&bl->fmt[bl->fmt_num++];
+    p->id=id;
+    p->fmt=malloc(len+1);
+    if(p->fmt==NULL)
+    {
+        fprintf(stderr,"out of memory\n");
+        exit(2);
+    }
+    memcpy(p->fmt,fmt,len);
+    p->fmt[len]='\0';
+}
+
+/**
+ * @brief 查找格式串
+ *
+ * @param bl 解码状态
+ * @param id 格式串号
+ * @return const char* 格式串，没有时返回NULL
+ */
+static const char *bl_fmt_find(bl_t *bl, acoral_u32 id)
+{
+    acoral_u32 lo=0,hi=bl->fmt_num,mid;
+    while(lo<hi)
+    {
+        mid=(lo+hi)/2;
+        if(bl->fmt[mid].id==id)
+            return bl->fmt[mid].fmt;
+        if(bl->fmt[mid].id<id)
+            lo=mid+1;
+        else
+            hi=mid;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 从ELF32小端文件的格式串段建立格式串表，段中每个以0结尾的字符串为一个格式串
+ *
+ * @param bl 解码状态
+ * @param buf 文件内容
+ * @param size 文件大小
+ * @return int 0成功，-1不是有效的ELF或没有格式串段
+ */
+static int bl_load_elf(bl_t *bl, const acoral_u8 *buf, size_t size)
+{
+    acoral_u32 shoff,shentsize,shnum,shstrndx,i,off,len;
+    const acoral_u8 *sh,*strtab,*sec;
+    acoral_u32 str_off,str_size,addr,sec_off,sec_size;
+    if(size<52||buf[4]!=1||buf[5]!=1)
+    {
+        fprintf(stderr,"only 32-bit little-endian ELF is supported\n");
+        return -1;
+    }
+    shoff=bl_u32(buf+0x20);
+    shentsize=bl_u16(buf+0x2E);
+    shnum=bl_u16(buf+0x30);
+    shstrndx=bl_u16(buf+0x32);
+    if(shentsize<40||shstrndx>=shnum||shoff>size||(size-shoff)/shentsize<shnum)
+    {
+        fprintf(stderr,"bad ELF section headers\n");
+        return -1;
+    }
+    sh=buf+shoff+shstrndx*shentsize;
+    str_off=bl_u32(sh+16);
+    str_size=bl_u32(sh+20);
+    if(str_off>size||str_size>size-str_off)
+        return -1;
+    strtab=buf+str_off;
+    for(i=0;i<shnum;i++)
+    {
+        sh=buf+shoff+i*shentsize;
+        off=bl_u32(sh);
+        if(off>=str_size||strncmp((const char *)strtab+off,BL_SECTION,str_size-off)!=0)
+            continue;
+        addr=bl_u32(sh+12);
+        sec_off=bl_u32(sh+16);
+        sec_size=bl_u32(sh+20);
+        if(sec_off>size||sec_size>size-sec_off)
+            return -1;
+        sec=buf+sec_off;
+        for(off=0;off<sec_size;off+=len+1)
+        {
+            len=0;
+            while(off+len<sec_size&&sec[off+len]!='\0')
+                len++;
+            if(len>0)//跳过对齐填充
+                bl_fmt_add(bl,addr+off,(const char *)sec+off,len);
+        }
+        return 0;
+    }
+    fprintf(stderr,"no %s section, is the firmware built with CFG_BINLOG and the matching linker script?\n",BL_SECTION);
+    return -1;
+}
+
+/**
+ * @brief 从-t导出的表文件建立格式串表
+ *
+ * @param bl 解码状态
+ * @param buf 文件内容，以0结尾
+ * @return int 0成功，-1格式错误
+ */
+static int bl_load_table(bl_t *bl, char *buf)
+{
+    char *line,*next,*p,*q,*end;
+    unsigned long id;
+    for(line=buf;line!=NULL&&*line!='\0';line=next)
+    {
+        next=strchr(line,'\n');
+        if(next!=NULL)
+            *next++='\0';
+        if(*line=='\0'||*line=='#')
+            continue;
+        id=strtoul(line,&end,0);
+        if(end==line||*end!='\t')
+        {
+            fprintf(stderr,"bad table line: %s\n",line);
+            return -1;
+        }
+        for(p=q=end+1;*p!='\0';p++)//原地去掉转义
+        {
+            if(*p!='\\'||p[1]=='\0')
+            {
+                *q++=*p;
+                continue;
+            }
+            p++;
+            *q++=*p=='n'?'\n':*p=='r'?'\r':*p=='t'?'\t':*p;
+        }
+        bl_fmt_add(bl,(acoral_u32)id,end+1,(size_t)(q-(end+1)));
+    }
+    return 0;
+}
+
+/**
+ * @brief 格式串表排序：格式串号
+ *
+ * @param a 格式串a
+ * @param b 格式串b
+ * @return int 比较结果
+ */
+static int bl_fmt_cmp(const void *a, const void *b)
+{
+    const bl_fmt_t *x=(const bl_fmt_t *)a,*y=(const bl_fmt_t *)b;
+    return x->id<y->id?-1:(x->id>y->id);
+}
+
+/**
+ * @brief 读取ELF或表文件，建立格式串表
+ *
+ * @param bl 解码状态
+ * @param path 路径
+ * @return int 0成功，-1失败
+ */
+static int bl_load(bl_t *bl, const char *path)
+{
+    FILE *fp;
+    acoral_u8 *buf;
+    long size;
+    int ret;
+    fp=fopen(path,"rb");
+    if(fp==NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    fseek(fp,0,SEEK_END);
+    size=ftell(fp);
+    fseek(fp,0,SEEK_SET);
+    buf=malloc(size>0?(size_t)size+1:1);
+    if(buf==NULL||size<0||fread(buf,1,(size_t)size,fp)!=(size_t)size)
+    {
+        perror(path);
+        fclose(fp);
+        free(buf);
+        return -1;
+    }
+    fclose(fp);
+    buf[size]='\0';
+    if(size>=4&&memcmp(buf,"\x7f" "ELF",4)==0)
+        ret=bl_load_elf(bl,buf,(size_t)size);
+    else
+        ret=bl_load_table(bl,(char *)buf);
+    free(buf);
+    if(ret==0)
+        qsort(bl->fmt,bl->fmt_num,sizeof(bl_fmt_t),bl_fmt_cmp);
+    return ret;
+}
+
+/**
+ * @brief 输出格式串表，即构建时导出的表文件
+ *
+ * @param bl 解码状态
+ */
+static void bl_dump(bl_t *bl)
+{
+    acoral_u32 i;
+    const char *p;
+    for(i=0;i<bl->fmt_num;i++)
+    {
+        printf("0x%x\t",bl->fmt[i].id);
+        for(p=bl->fmt[i].fmt;*p!='\0';p++)
+        {
+            if(*p=='\n')
+                fputs("\\n",stdout);
+            else if(*p=='\r')
+                fputs("\\r",stdout);
+            else if(*p=='\t')
+                fputs("\\t",stdout);
+            else if(*p=='\\')
+                fputs("\\\\",stdout);
+            else
+                putchar(*p);
+        }
+        putchar('\n');
+    }
+}
+
+/**
+ * @brief 按格式串格式化参数
+ *
+ * @param out 输出
+ * @param size 输出大小
+ * @param fmt 格式串
+ * @param args 参数
+ * @param num 参数个数
+ */
+static void bl_format(char *out, size_t size, const char *fmt, const acoral_u32 *args, acoral_u32 num)
+{
+    char spec[32];
+    size_t n=0,k;
+    acoral_u32 used=0,arg;
+    int w;
+    const char *p;
+    while(*fmt!='\0'&&n+1<size)
+    {
+        if(*fmt!='%')
+        {
+            out[n++]=*fmt++;
+            continue;
+        }
+        if(fmt[1]=='%')
+        {
+            out[n++]='%';
+            fmt+=2;
+            continue;
+        }
+        //复制标志、宽度和精度，去掉长度修饰符
+        k=0;
+        spec[k++]='%';
+        for(p=fmt+1;*p!='\0'&&strchr("-+ #0123456789.",*p)!=NULL&&k<sizeof(spec)-4;p++)
+            spec[k++]=*p;
+        while(*p!='\0'&&strchr("hlqjzt",*p)!=NULL)
+            p++;
+        if(*p=='\0')
+            break;
+        arg=used<num?args[used]:0;
+        if(strchr("diuxXocps",*p)==NULL)
+        {
+            w=snprintf(out+n,size-n,"<%%%c?>",*p);
+        }
+        else if(used>=num)
+        {
+            w=snprintf(out+n,size-n,"<missing>");
+            used++;
+        }
+        else
+        {
+            used++;
+            if(*p=='p'||*p=='s')
+            {
+                spec[k++]='#';
+                spec[k++]='x';
+            }
+            else
+                spec[k++]=*p=='i'?'d':*p;
+            spec[k]='\0';
+            if(*p=='d'||*p=='i'||*p=='c')
+                w=snprintf(out+n,size-n,spec,(int)arg);
+            else
+                w=snprintf(out+n,size-n,spec,(unsigned int)arg);
+        }
+        if(w<0)
+            break;
+        n+=(size_t)w<size-n?(size_t)w:size-n-1;
+        fmt=p+1;
+    }
+    out[n]='\0';
+    //去掉结尾的换行，每条日志单独一行
+    while(n>0&&(out[n-1]=='\n'||out[n-1]=='\r'))
+        out[--n]='\0';
+}
+
+/**
+ * @brief 读取protobuf变长整数
+ *
+ * @param p 数据
+ * @param len 数据长度
+ * @param pos 读取位置，成功后前移
+ * @param v 返回值
+ * @return int 0成功，-1数据不完整
+ */
+static int bl_varint(const acoral_u8 *p, acoral_u32 len, acoral_u32 *pos, acoral_u64 *v)
+{
+    acoral_u32 shift=0;
+    *v=0;
+    while(*pos<len&&shift<64)
+    {
+        *v|=(acoral_u64)(p[*pos]&0x7F)<<shift;
+        if((p[(*pos)++]&0x80)==0)
+            return 0;
+        shift+=7;
+    }
+    return -1;
+}
+
+/**
+ * @brief 解码AcoSimLogBatch的记录字段并逐条输出
+ *
+ * @param bl 解码状态
+ * @param cpu cpu
+ * @param ts 第一条记录的时间戳
+ * @param p 记录
+ * @param len 字节数
+ */
+static void bl_records(bl_t *bl, acoral_u32 cpu, acoral_u64 ts, const acoral_u8 *p, acoral_u32 len)
+{
+    acoral_u32 args[BL_ARGS_MAX],pos=0,i;
+    acoral_u64 id,delta,num,v;
+    const char *fmt;
+    char text[BL_TEXT_MAX];
+    while(pos<len)
+    {
+        if(bl_varint(p,len,&pos,&id)<0||bl_varint(p,len,&pos,&delta)<0||bl_varint(p,len,&pos,&num)<0||num>BL_ARGS_MAX)
+            return;
+        for(i=0;i<num;i++)
+        {
+            if(bl_varint(p,len,&pos,&v)<0)
+                return;//不完整的记录，CRC通过时不应出现
+            args[i]=(acoral_u32)v;
+        }
+        ts+=delta;
+        if(!bl->started)
+        {
+            bl->started=1;
+            bl->t0=ts;
+        }
+        fmt=bl_fmt_find(bl,(acoral_u32)id);
+        if(fmt!=NULL)
+            bl_format(text,sizeof(text),fmt,args,(acoral_u32)num);
+        else
+        {
+            bl->unknown++;
+            snprintf(text,sizeof(text),"<unknown format 0x%x, %u args>",(acoral_u32)id,(acoral_u32)num);
+        }
+        printf("[cpu%u %12.3f] %s\n",cpu,(double)(acoral_64)(ts-bl->t0)*1e6/bl->hz,text);
+        bl->records++;
+    }
+}
+
+/**
+ * @brief 处理一个日志帧的负载
+ *
+ * @param bl 解码状态
+ * @param p 负载
+ * @param len 负载长度
+ */
+static void bl_frame(bl_t *bl, const acoral_u8 *p, acoral_u32 len)
+{
+    acoral_u32 pos=0,cpu=0,rec_len=0;
+    acoral_u64 key,v,base=0,lost=0;
+    const acoral_u8 *rec=NULL;
+    while(pos<len)
+    {
+        if(bl_varint(p,len,&pos,&key)<0)
+            return;
+        if((key&7)==0)
+        {
+            if(bl_varint(p,len,&pos,&v)<0)
+                return;
+            if((key>>3)==1)
+                cpu=(acoral_u32)v;
+            else if((key>>3)==2)
+                base=v;
+            else if((key>>3)==3)
+                lost=v;
+        }
+        else if((key&7)==2)
+        {
+            if(bl_varint(p,len,&pos,&v)<0||v>len-pos)
+                return;
+            if((key>>3)==4)
+            {
+                rec=p+pos;
+                rec_len=(acoral_u32)v;
+            }
+            pos+=(acoral_u32)v;
+        }
+        else
+            return;
+    }
+    if(cpu>=BL_CPU_MAX)
+        return;
+    if(rec!=NULL)
+        bl_records(bl,cpu,base,rec,rec_len);
+    if((acoral_u32)lost!=bl->lost[cpu])
+    {
+        printf("[cpu%u] %u records dropped on target so far\n",cpu,(acoral_u32)lost);
+        bl->lost[cpu]=(acoral_u32)lost;
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief 计算CRC16-CCITT，与wire.c一致
+ *
+ * @param p 数据
+ * @param len 字节数
+ * @return acoral_u16 CRC
+ */
+static acoral_u16 bl_crc16(const acoral_u8 *p, acoral_u32 len)
+{
+    acoral_u16 crc=0xFFFF;
+    int i;
+    while(len-->0)
+    {
+        crc^=(acoral_u16)(*p++)<<8;
+        for(i=0;i<8;i++)
+            crc=crc&0x8000?(acoral_u16)((crc<<1)^0x1021):(acoral_u16)(crc<<1);
+    }
+    return crc;
+}
+
+/**
+ * @brief 尝试在pos处解析一个紧凑编码帧
+ *
+ * @param bl 解码状态
+ * @param buf 数据
+ * @param len 数据长度
+ * @param pos 位置，buf[pos]为0xA5
+ * @return acoral_u32 帧长度；0表示数据不够，需要继续读取；1表示不是有效帧，跳过一个字节
+ */
+static acoral_u32 bl_wire_try(bl_t *bl, const acoral_u8 *buf, acoral_u32 len, acoral_u32 pos)
+{
+    acoral_u32 plen,seq;
+    const acoral_u8 *f=buf+pos;
+    if(len-pos<BL_WIRE_HEAD)
+        return 0;
+    if(f[1]!=0x5A)
+        return 1;
+    plen=bl_u16(f+4);
+    if(plen>BL_PAYLOAD_MAX)
+        return 1;
+    if(len-pos<BL_WIRE_HEAD+plen+BL_WIRE_CRC)
+        return 0;
+    if(bl_crc16(f+2,BL_WIRE_HEAD-2+plen)!=bl_u16(f+BL_WIRE_HEAD+plen))
+    {
+        bl->crc++;
+        return 1;
+    }
+    seq=f[3];
+    if(bl->seq>=0)
+        bl->gap+=(seq-(acoral_u32)bl->seq-1)&0xFF;
+    bl->seq=(acoral_32)seq;
+    bl->frames++;
+    if(f[2]==BL_WIRE_LOG)
+        bl_frame(bl,f+BL_WIRE_HEAD,plen);
+    return BL_WIRE_HEAD+plen+BL_WIRE_CRC;
+}
+
+/**
+ * @brief 读取帧流直到文件结束或Ctrl-C，帧头不对时逐字节重新同步
+ *
+ * @param bl 解码状态
+ * @param fd 输入
+ * @return int 0成功，-1读取错误
+ */
+static int bl_read(bl_t *bl, int fd)
+{
+    static acoral_u8 buf[65536];
+    acoral_u32 len=0,pos,flen;
+    ssize_t n;
+    while(!bl_stop)
+    {
+        n=read(fd,buf+len,sizeof(buf)-len);
+        if(n<0)
+        {
+            if(errno==EINTR)
+                continue;
+            perror("read");
+            return -1;
+        }
+        if(n==0)
+            break;
+        len+=(acoral_u32)n;
+        pos=0;
+        while(len-pos>=BL_WIRE_HEAD)
+        {
+            if(buf[pos]!=0xA5)
+            {
+                pos++;
+                bl->bad++;
+                continue;
+            }
+            flen=bl_wire_try(bl,buf,len,pos);
+            if(flen==0)
+                break;
+            if(flen==1)
+                bl->bad++;
+            pos+=flen;
+        }
+        memmove(buf,buf+pos,len-pos);
+        len-=pos;
+    }
+    return 0;
+}
+
+/**
+ * @brief 打开输入，串口设备设为raw模式
+ *
+ * @param path 路径，"-"为标准输入
+ * @param baud 波特率
+ * @return int 文件描述符，失败返回-1
+ */
+static int bl_open(const char *path, acoral_u32 baud)
+{
+    struct termios tio;
+    speed_t speed;
+    int fd;
+    if(strcmp(path,"-")==0)
+        return 0;
+    fd=open(path,O_RDONLY|O_NOCTTY);
+    if(fd<0)
+    {
+        perror(path);
+        return -1;
+    }
+    if(!isatty(fd))
+        return fd;
+    switch(baud)
+    {
+        case 9600:speed=B9600;break;
+        case 57600:speed=B57600;break;
+        case 230400:speed=B230400;break;
+        case 460800:speed=B460800;break;
+        case 921600:speed=B921600;break;
+        default:speed=B115200;break;
+    }
+    if(tcgetattr(fd,&tio)==0)
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio,speed);
+        cfsetospeed(&tio,speed);
+        tio.c_cc[VMIN]=1;
+        tio.c_cc[VTIME]=0;
+        tcsetattr(fd,TCSANOW,&tio);
+    }
+    return fd;
+}
+
+/**
+ * @brief 标准错误输出统计
+ *
+ * @param bl 解码状态
+ */
+static void bl_report(bl_t *bl)
+{
+    acoral_u32 i;
+    fprintf(stderr,"%u records, %u with unknown format, %u frames ok, %u crc errors, %u missing by sequence, %u bytes skipped\n",
+            bl->records,bl->unknown,bl->frames,bl->crc,bl->gap,bl->bad);
+    for(i=0;i<BL_CPU_MAX;i++)
+    {
+        if(bl->lost[i]!=0)
+            fprintf(stderr,"cpu %u: %u records dropped on target\n",i,bl->lost[i]);
+    }
+}
+
+/**
+ * @brief 打印用法
+ *
+ * @param prog 程序名
+ */
+static void bl_usage(const char *prog)
+{
+    fprintf(stderr,"usage: %s [-b baud] [-f hz] <firmware.elf|table> <capture|serial device|->\n"
+                   "       %s -t <firmware.elf> > table\n"
+                   "  -b  serial baud rate, default 115200\n"
+                   "  -f  timestamp clock in Hz, default 333333333 (zynq global timer)\n"
+                   "  -t  print the format string table extracted from the ELF and exit\n",prog,prog);
+}
+
+/**
+ * @brief 解析无符号十进制数
+ *
+ * @param s 字符串
+ * @param v 返回值
+ * @return int 0成功，-1失败
+ */
+static int bl_parse_u32(const char *s, acoral_u32 *v)
+{
+    char *end;
+    unsigned long x;
+    errno=0;
+    x=strtoul(s,&end,10);
+    if(errno||end==s||*end!='\0'||x>0xffffffffUL)
+        return -1;
+    *v=(acoral_u32)x;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static bl_t bl;
+    struct sigaction sa;
+    acoral_u32 baud=115200,hz=333333333;
+    int fd,i,dump=0;
+    for(i=1;i<argc&&argv[i][0]=='-'&&argv[i][1]!='\0';i++)
+    {
+        if(strcmp(argv[i],"-t")==0)
+            dump=1;
+        else if(strcmp(argv[i],"-b")==0&&i+1<argc&&bl_parse_u32(argv[i+1],&baud)==0)
+            i++;
+        else if(strcmp(argv[i],"-f")==0&&i+1<argc&&bl_parse_u32(argv[i+1],&hz)==0&&hz>0)
+            i++;
+        else
+        {
+            bl_usage(argv[0]);
+            return 2;
+        }
+    }
+    if(i!=argc-(dump?1:2))
+    {
+        bl_usage(argv[0]);
+        return 2;
+    }
+    if(bl_load(&bl,argv[i])<0)
+        return 2;
+    if(dump)
+    {
+        bl_dump(&bl);
+        return 0;
+    }
+    bl.hz=hz;
+    bl.seq=-1;
+    fd=bl_open(argv[i+1],baud);
+    if(fd<0)
+        return 2;
+    memset(&sa,0,sizeof(sa));
+    sa.sa_handler=bl_sigint;//不设SA_RESTART，read被打断后停止
+    sigaction(SIGINT,&sa,NULL);
+    if(bl_read(&bl,fd)<0)
+        return 2;
+    if(fd!=0)
+        close(fd);
+    bl_report(&bl);
+    return 0;
+}
@@ -0,0 +1,460 @@
+/**
+ * @file rta_cli.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief 主机端可调度性分析工具，与准入控制共用响应时间分析库
+ * @version 1.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>创建文件
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>不动点迭代次数上限
+ *
+ * 任务集描述文件，每行一条，#之后为注释，时间单位统一（与准入控制一致为ms）：
+ *   cpus <n>                                     cpu数量，默认2
+ *   timed <cpu> <超周期> <起始>:<长度> ...          时间确定性任务占用的时间段
+ *   res <名字> [cpu]                              声明资源，可指定资源代理所在cpu
+ *   task <名字> <周期> <wcet> <截止时间> [cpu=<n>] [prio=<n>] [<资源>:<次数>:<临界区长度> ...]
+ *
+ * 所有任务都给出cpu和prio时直接分析，否则按截止时间单调分配优先级并自动划分，
+ * -a强制重新分配。退出码：0可调度，1不可调度，2输入错误
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rta.h>
+
+///单行最大长度
+#define LINE_MAX_LEN 1024
+
+/**
+ * @brief 解析过程中的任务集
+ *
+ */
+typedef struct{
+    acoral_rta_task_t *task;///<任务表
+    acoral_u32 task_num;///<任务数量
+    acoral_u32 task_cap;///<任务表容量
+    acoral_rta_res_t *res;///<资源表
+    acoral_u32 res_num;///<资源数量
+    acoral_u32 res_cap;///<资源表容量
+    acoral_rta_timed_t *timed;///<各cpu时间表
+    acoral_u32 cpu_num;///<cpu数量
+    acoral_u8 need_prio;///<有任务未给出优先级
+    acoral_u8 need_cpu;///<有任务未给出cpu
+}cli_set_t;
+
+/**
+ * @brief 分配内存，失败时退出
+ *
+ * @param ptr 原内存
+ * @param size 大小
+ * @return void* 新内存
+ */
+static void *cli_realloc(void *ptr, size_t size)
+{
+    void *ret=realloc(ptr,size);
+    if(ret==NULL)
+    {
+        fprintf(stderr,"out of memory\n");
+        exit(2);
+    }
+    return ret;
+}
+
+/**
+ * @brief 复制字符串
+ *
+ * @param s 字符串
+ * @return char* 副本
+ */
+static char *cli_strdup(const char *s)
+{
+    char *ret=cli_realloc(NULL,strlen(s)+1);
+    strcpy(ret,s);
+    return ret;
+}
+
+/**
+ * @brief 解析无符号整数
+ *
+ * @param s 字符串
+ * @param value 结果
+ * @return int 0成功，-1失败
+ */
+static int cli_parse_u32(const char *s, acoral_u32 *value)
+{
+    char *end;
+    unsigned long v;
+    if(s==NULL||*s=='\0')
+        return -1;
+    v=strtoul(s,&end,0);
+    if(*end!='\0'||v>0xffffffffUL)
+        return -1;
+    *value=(acoral_u32)v;
+    return 0;
+}
+
+/**
+ * @brief 设置cpu数量，扩展时间表
+ *
+ * @param set 任务集
+ * @param cpu_num cpu数量
+ */
+static void cli_set_cpus(cli_set_t *set, acoral_u32 cpu_num)
+{
+    acoral_u32 i;
+    set->timed=cli_realloc(set->timed,sizeof(acoral_rta_timed_t)*cpu_num);
+    for(i=set->cpu_num;i<cpu_num;i++)
+        memset(&set->timed[i],0,sizeof(acoral_rta_timed_t));
+    set->cpu_num=cpu_num;
+}
+
+/**
+ * @brief 查找资源，不存在时创建
+ *
+ * @param set 任务集
+ * @param name 资源名字
+ * @return acoral_u32 资源下标
+ */
+static acoral_u32 cli_res_get(cli_set_t *set, const char *name)
+{
+    acoral_u32 i;
+    for(i=0;i<set->res_num;i++)
+    {
+        if(strcmp(set->res[i].name,name)==0)
+            return i;
+    }
+    if(set->res_num==set->res_cap)
+    {
+        set->res_cap=set->res_cap?set->res_cap*2:8;
+        set->res=cli_realloc(set->res,sizeof(acoral_rta_res_t)*set->res_cap);
+    }
+    memset(&set->res[set->res_num],0,sizeof(acoral_rta_res_t));
+    set->res[set->res_num].name=cli_strdup(name);
+    set->res[set->res_num].cpu=ACORAL_RTA_NO_CPU;
+    return set->res_num++;
+}
+
+/**
+ * @brief 解析timed行
+ *
+ * @param set 任务集
+ * @param argc 字段数
+ * @param argv 字段
+ * @return int 0成功，-1失败
+ */
+static int cli_parse_timed(cli_set_t *set, int argc, char **argv)
+{
+    acoral_u32 cpu,k;
+    acoral_u32 *start,*len;
+    acoral_rta_timed_t *timed;
+    char *sep;
+    if(argc<3||cli_parse_u32(argv[1],&cpu)<0||cpu>=set->cpu_num)
+        return -1;
+    timed=&set->timed[cpu];
+    if(cli_parse_u32(argv[2],&timed->h_period)<0||timed->h_period==0)
+        return -1;
+    start=cli_realloc(NULL,sizeof(acoral_u32)*(argc-3+1));
+    len=cli_realloc(NULL,sizeof(acoral_u32)*(argc-3+1));
+    for(k=0;k<(acoral_u32)(argc-3);k++)
+    {
+        sep=strchr(argv[k+3],':');
+        if(sep==NULL)
+            return -1;
+        *sep='\0';
+        if(cli_parse_u32(argv[k+3],&start[k])<0||cli_parse_u32(sep+1,&len[k])<0)
+            return -1;
+        if(k>0&&start[k]<start[k-1])
+            return -1;
+    }
+    timed->start=start;
+    timed->len=len;
+    timed->slot_num=argc-3;
+    return 0;
+}
+
+/**
+ * @brief 解析res行
+ *
+ * @param set 任务集
+ * @param argc 字段数
+ * @param argv 字段
+ * @return int 0成功，-1失败
+ */
+static int cli_parse_res(cli_set_t *set, int argc, char **argv)
+{
+    acoral_u32 r,cpu;
+    if(argc<2||argc>3)
+        return -1;
+    r=cli_res_get(set,argv[1]);
+    if(argc==3)
+    {
+        if(cli_parse_u32(argv[2],&cpu)<0||cpu>=set->cpu_num)
+            return -1;
+        set->res[r].cpu=cpu;
+        set->res[r].pinned=1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 解析task行
+ *
+ * @param set 任务集
+ * @param argc 字段数
+ * @param argv 字段
+ * @return int 0成功，-1失败
+ */
+static int cli_parse_task(cli_set_t *set, int argc, char **argv)
+{
+    acoral_rta_task_t *task;
+    acoral_rta_use_t *use;
+    acoral_u8 has_cpu=0,has_prio=0;
+    char *cnt,*len;
+    int k;
+    if(argc<5)
+        return -1;
+    if(set->task_num==set->task_cap)
+    {
+        set->task_cap=set->task_cap?set->task_cap*2:16;
+        set->task=cli_realloc(set->task,sizeof(acoral_rta_task_t)*set->task_cap);
+    }
+    task=&set->task[set->task_num];
+    memset(task,0,sizeof(acoral_rta_task_t));
+    task->name=cli_strdup(argv[1]);
+    if(cli_parse_u32(argv[2],&task->period)<0||cli_parse_u32(argv[3],&task->wcet)<0||cli_parse_u32(argv[4],&task->dl)<0)
+        return -1;
+    if(task->period==0||task->wcet==0||task->dl==0)
+        return -1;
+    task->wcrt=task->dl;
+    task->seq=set->task_num;
+    task->use=cli_realloc(NULL,sizeof(acoral_rta_use_t)*(argc-5+1));
+    for(k=5;k<argc;k++)
+    {
+        if(strncmp(argv[k],"cpu=",4)==0)
+        {
+            if(cli_parse_u32(argv[k]+4,&task->cpu)<0||task->cpu>=set->cpu_num)
+                return -1;
+            has_cpu=1;
+        }
+        else if(strncmp(argv[k],"prio=",5)==0)
+        {
+            if(cli_parse_u32(argv[k]+5,&task->prio)<0)
+                return -1;
+            has_prio=1;
+        }
+        else
+        {
+            cnt=strchr(argv[k],':');
+            len=cnt!=NULL?strchr(cnt+1,':'):NULL;
+            if(len==NULL)
+                return -1;
+            *cnt++='\0';
+            *len++='\0';
+            use=&task->use[task->use_num];
+            use->res=cli_res_get(set,argv[k]);
+            if(cli_parse_u32(cnt,&use->cnt)<0||cli_parse_u32(len,&use->len)<0)
+                return -1;
+            task->use_num++;
+        }
+    }
+    if(!has_cpu)
+    {
+        task->cpu=ACORAL_RTA_NO_CPU;
+        set->need_cpu=1;
+    }
+    if(!has_prio)
+        set->need_prio=1;
+    set->task_num++;
+    return 0;
+}
+
+/**
+ * @brief 读取任务集描述文件
+ *
+ * @param set 任务集
+ * @param fp 文件
+ * @return int 0成功，-1失败
+ */
+static int cli_load(cli_set_t *set, FILE *fp)
+{
+    char line[LINE_MAX_LEN];
+    char *argv[LINE_MAX_LEN/2];
+    char *p;
+    int argc,ret;
+    acoral_u32 lineno=0,cpu_num;
+    while(fgets(line,sizeof(line),fp)!=NULL)
+    {
+        lineno++;
+        p=strchr(line,'#');
+        if(p!=NULL)
+            *p='\0';
+        argc=0;
+        for(p=strtok(line," \t\r\n");p!=NULL;p=strtok(NULL," \t\r\n"))
+            argv[argc++]=p;
+        if(argc==0)
+            continue;
+        if(strcmp(argv[0],"cpus")==0)
+        {
+            ret=(argc==2&&cli_parse_u32(argv[1],&cpu_num)==0&&cpu_num>0&&cpu_num<=ACORAL_RTA_MAX_CPU&&set->task_num==0)?0:-1;
+            if(ret==0)
+                cli_set_cpus(set,cpu_num);
+        }
+        else if(strcmp(argv[0],"timed")==0)
+            ret=cli_parse_timed(set,argc,argv);
+        else if(strcmp(argv[0],"res")==0)
+            ret=cli_parse_res(set,argc,argv);
+        else if(strcmp(argv[0],"task")==0)
+            ret=cli_parse_task(set,argc,argv);
+        else
+            ret=-1;
+        if(ret<0)
+        {
+            fprintf(stderr,"line %u: invalid '%s' entry\n",lineno,argv[0]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 打印分析结果
+ *
+ * @param set 任务集
+ * @param rta 分析用任务集
+ * @return acoral_bool 是否全部可调度
+ */
+static acoral_bool cli_report(cli_set_t *set, acoral_rta_set_t *rta)
+{
+    acoral_rta_task_t *task;
+    acoral_rta_res_t *res;
+    acoral_u32 i,c,load;
+    acoral_bool ok=true;
+    char cpu_str[12],resp_str[12];
+    printf("%-16s%8s%8s%8s%6s%6s%10s%8s\n","task","period","wcet","dl","cpu","prio","wcrt","result");
+    for(i=0;i<set->task_num;i++)
+    {
+        task=&set->task[i];
+        if(task->cpu==ACORAL_RTA_NO_CPU)
+            snprintf(cpu_str,sizeof(cpu_str),"-");
+        else
+            snprintf(cpu_str,sizeof(cpu_str),"%u",task->cpu);
+        if(task->response==ACORAL_RTA_UNSCHED)
+            snprintf(resp_str,sizeof(resp_str),"-");
+        else
+            snprintf(resp_str,sizeof(resp_str),"%u",task->response);
+        if(task->cpu==ACORAL_RTA_NO_CPU||task->response>task->dl)
+            ok=false;
+        printf("%-16s%8u%8u%8u%6s%6u%10s%8s\n",task->name,task->period,task->wcet,task->dl,
+               cpu_str,task->prio,resp_str,(task->cpu!=ACORAL_RTA_NO_CPU&&task->response<=task->dl)?"ok":"MISS");
+    }
+    if(set->res_num)
+    {
+        printf("\n%-16s%6s%8s%9s\n","resource","cpu","type","ceiling");
+        for(i=0;i<set->res_num;i++)
+        {
+            res=&set->res[i];
+            if(res->cpu==ACORAL_RTA_NO_CPU||res->ceiling==ACORAL_RTA_UNSCHED)
+            {
+                printf("%-16s%6s%8s%9s\n",res->name,"-","unused","-");
+                continue;
+            }
+            printf("%-16s%6u%8s%9u\n",res->name,res->cpu,res->global?"global":"local",res->ceiling);
+        }
+    }
+    printf("\n%-6s%10s%8s\n","cpu","load(%)","result");
+    for(c=0;c<set->cpu_num;c++)
+    {
+        acoral_bool cpu_ok=true;
+        for(i=0;i<set->task_num;i++)
+        {
+            task=&set->task[i];
+            if(task->cpu==c&&task->response>task->dl)
+                cpu_ok=false;
+        }
+        load=acoral_rta_cpu_load(rta,c);
+        printf("%-6u%6u.%03u%8s\n",c,load/10000,(load%10000)/10,cpu_ok?"ok":"MISS");
+    }
+    printf("\n%s\n",ok?"schedulable":"NOT schedulable");
+    return ok;
+}
+
+/**
+ * @brief 打印用法
+ *
+ * @param prog 程序名
+ */
+static void cli_usage(const char *prog)
+{
+    fprintf(stderr,"usage: %s [-a] [-b prio_base] [-s prio_step] [-n iter_max] <taskset file|->\n",prog);
+    fprintf(stderr,"  -a  reassign priorities (deadline monotonic) and partition even if given\n");
+    fprintf(stderr,"  -b  highest priority used when assigning, default 2\n");
+    fprintf(stderr,"  -s  priority step used when assigning, default 1\n");
+    fprintf(stderr,"  -n  max fixed-point iterations per task, 0 for unlimited, default 0\n");
+}
+
+int main(int argc, char **argv)
+{
+    cli_set_t set;
+    acoral_rta_set_t rta;
+    acoral_u32 prio_base=2,prio_step=1,iter_max=0;
+    acoral_u8 force=0;
+    FILE *fp;
+    int i;
+    memset(&set,0,sizeof(set));
+    cli_set_cpus(&set,2);
+    for(i=1;i<argc&&argv[i][0]=='-'&&argv[i][1]!='\0';i++)
+    {
+        if(strcmp(argv[i],"-a")==0)
+            force=1;
+        else if(strcmp(argv[i],"-b")==0&&i+1<argc&&cli_parse_u32(argv[i+1],&prio_base)==0)
+            i++;
+        else if(strcmp(argv[i],"-s")==0&&i+1<argc&&cli_parse_u32(argv[i+1],&prio_step)==0&&prio_step>0)
+            i++;
+        else if(strcmp(argv[i],"-n")==0&&i+1<argc&&cli_parse_u32(argv[i+1],&iter_max)==0)
+            i++;
+        else
+        {
+            cli_usage(argv[0]);
+            return 2;
+        }
+    }
+    if(i!=argc-1)
+    {
+        cli_usage(argv[0]);
+        return 2;
+    }
+    fp=strcmp(argv[i],"-")==0?stdin:fopen(argv[i],"r");
+    if(fp==NULL)
+    {
+        perror(argv[i]);
+        return 2;
+    }
+    if(cli_load(&set,fp)<0)
+        return 2;
+    if(fp!=stdin)
+        fclose(fp);
+    rta.task=set.task;
+    rta.task_num=set.task_num;
+    rta.res=set.res;
+    rta.res_num=set.res_num;
+    rta.timed=set.timed;
+    rta.cpu_num=set.cpu_num;
+    rta.iter_max=iter_max;
+    if(force||set.need_prio)
+        acoral_rta_assign_prio(&rta,prio_base,prio_step);
+    if(force||set.need_cpu)
+        acoral_rta_partition(&rta);
+    else
+    {
+        acoral_rta_bind_res(&rta);
+        for(i=0;i<(int)set.task_num;i++)
+            set.task[i].response=ACORAL_RTA_UNSCHED;
+        acoral_rta_analyse(&rta);
+    }
+    return cli_report(&set,&rta)?0:1;
+}
@@ -0,0 +1,1172 @@
+/**
+ * @file trace2json.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief 主机端追踪流转换工具，把monitor的串口帧转换为Perfetto/Chrome trace-event JSON
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>创建文件
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>解码紧凑编码帧，检查CRC和序号
+ *         <tr><td>v1.2 <td>胡博文 <td>2026-10-19 <td>跳过二进制日志帧
+ *
+ * 输入为kernel/src/monitor.c发送的帧，可以是抓取文件、串口设备或PTY，串口设备会被设为raw模式。
+ * 原始帧：
+ *   帧头12字节："++++"，类型u32，负载长度u32，均为小端
+ *   类型1  CPUcore_info：id u32，频率u32，名字char[32]
+ *   类型2  thread_info：策略u32，优先级u32，tcb指针u32，周期u32，超周期u32，cpu u32，创建tick u32，名字char[32]
+ *   类型3  acoral_trace_rec_t：时间戳u64(cycles)，事件u16，cpu u16，arg0~arg2 u32，事件编号与kernel/include/trace.h一致
+ * 紧凑编码帧(CFG_TRACE_WIRE_COMPACT)，两种帧可混在同一输入中：
+ *   0xA5 0x5A，类型u8，序号u8，负载长度u16，负载，CRC16-CCITT u16(覆盖类型到负载末尾)
+ *   负载为protobuf，类型1 AcoSimCore，类型2 AcoSimTask，类型3 AcoSimTraceBatch，见components/acosim/src/acosim.proto
+ *   类型4 AcoSimLogBatch为二进制日志，由tools/binlog解码，这里只检查CRC和序号
+ *   线程以taskId代替tcb指针，CRC错误的帧被丢弃，序号不连续计为丢帧
+ * 读到文件结束或Ctrl-C后，按时间戳合并各cpu的记录，输出：
+ *   进程"cores"：每个cpu一条运行线程轨道和一条中断轨道
+ *   进程"threads"：每个线程一条状态轨道（running/ready/blocked），tcb指针按类型2信息解析为线程名
+ * 标准错误输出各线程就绪到运行的最大延迟和各中断的最大执行时间，超过-t阈值的就绪延迟在JSON中打标记。
+ * 退出码：0成功，2输入错误
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <type.h>
+
+///帧头长度
+#define TR_HEADER_SIZE 12
+///负载长度上限，超过视为失步
+#define TR_PAYLOAD_MAX 1024
+///类型1负载长度
+#define TR_CORE_SIZE 40
+///类型2负载长度
+#define TR_THREAD_SIZE 60
+///类型3负载长度
+#define TR_REC_SIZE 24
+///紧凑编码帧头长度
+#define TR_WIRE_HEAD 6
+///紧凑编码CRC长度
+#define TR_WIRE_CRC 2
+///最大cpu数量
+#define TR_CPU_MAX 8
+///中断嵌套深度上限
+#define TR_IRQ_DEPTH 8
+///中断号上限（GIC）
+#define TR_IRQ_MAX 1024
+///中断轨道tid相对cpu号的偏移
+#define TR_IRQ_TID 100
+
+///追踪事件，与kernel/include/trace.h一致
+#define TR_SWITCH 0x00
+#define TR_WAKE 0x01
+#define TR_CREATE 0x02
+#define TR_IRQ_ENTER 0x10
+#define TR_IRQ_EXIT 0x11
+#define TR_IPI_SEND 0x20
+#define TR_IPI_RECV 0x21
+#define TR_IPC_BLOCK 0x30
+#define TR_IPC_UNBLOCK 0x31
+
+///线程状态位，与kernel/include/thread.h一致
+#define TR_STATE_SUSPEND (1<<1)
+#define TR_STATE_EXIT (1<<3)
+
+/**
+ * @brief 线程在状态轨道上的状态
+ *
+ */
+typedef enum{
+    TR_NONE,
+    TR_RUNNING,
+    TR_READY,
+    TR_BLOCKED
+}tr_state_t;
+
+/**
+ * @brief 追踪记录
+ *
+ */
+typedef struct{
+    acoral_u64 ts;///<时间戳(cycles)
+    acoral_u16 type;///<事件
+    acoral_u16 cpu;///<cpu
+    acoral_u32 arg[3];///<参数
+    acoral_u32 seq;///<到达顺序，时间戳相同时保持原顺序
+}tr_rec_t;
+
+/**
+ * @brief 类型2线程信息
+ *
+ */
+typedef struct{
+    acoral_u32 tcb;///<tcb指针
+    acoral_u32 prio;///<优先级
+    acoral_u32 cpu;///<cpu
+    char name[33];///<名字
+}tr_info_t;
+
+/**
+ * @brief 线程，同一tcb被回收再创建时为不同线程
+ *
+ */
+typedef struct{
+    acoral_u32 tcb;///<tcb指针
+    acoral_u32 tid;///<状态轨道tid
+    acoral_u32 born;///<该tcb之前已创建的次数，用于匹配线程信息
+    char name[48];///<名字
+    tr_state_t state;///<当前状态
+    acoral_u64 since;///<进入当前状态的时刻
+    acoral_u64 wake;///<就绪时刻，0表示不在等待运行
+    acoral_u32 ipc;///<阻塞的ipc
+    acoral_u32 runs;///<被换入次数
+    acoral_u64 lat_max;///<就绪到运行的最大延迟(cycles)
+    acoral_u64 lat_total;///<就绪到运行的延迟总和
+    acoral_u32 lat_num;///<延迟样本数
+    acoral_u64 lat_at;///<最大延迟发生时刻
+}tr_thread_t;
+
+/**
+ * @brief cpu状态
+ *
+ */
+typedef struct{
+    char name[33];///<名字
+    acoral_u32 cur;///<当前运行的线程下标加1，0表示未知
+    acoral_u64 since;///<当前线程换入时刻
+    acoral_u32 irq_id[TR_IRQ_DEPTH];///<嵌套中断号
+    acoral_u64 irq_ts[TR_IRQ_DEPTH];///<嵌套中断进入时刻
+    acoral_u32 irq_depth;///<嵌套深度
+}tr_cpu_t;
+
+/**
+ * @brief 中断统计
+ *
+ */
+typedef struct{
+    acoral_u32 num;///<次数
+    acoral_u64 max;///<最大执行时间(cycles)
+    acoral_u64 total;///<执行时间总和
+}tr_irq_t;
+
+/**
+ * @brief 转换状态
+ *
+ */
+typedef struct{
+    tr_rec_t *rec;///<记录
+    acoral_u32 rec_num;///<记录数
+    acoral_u32 rec_cap;///<记录容量
+    tr_info_t *info;///<线程信息
+    acoral_u32 info_num;///<线程信息数
+    acoral_u32 info_cap;///<线程信息容量
+    tr_thread_t *thread;///<线程
+    acoral_u32 thread_num;///<线程数
+    acoral_u32 thread_cap;///<线程容量
+    tr_cpu_t cpu[TR_CPU_MAX];///<cpu
+    acoral_u32 cpu_num;///<出现过的cpu数量
+    tr_irq_t irq[TR_IRQ_MAX];///<中断统计
+    double hz;///<时间戳频率
+    acoral_u64 t0;///<第一条记录的时刻
+    acoral_u64 threshold;///<就绪延迟标记阈值(cycles)，0不标记
+    acoral_u32 bad;///<失步丢弃的字节数
+    acoral_u32 wire_frames;///<收到的紧凑编码帧数
+    acoral_u32 wire_crc;///<CRC错误的紧凑编码帧数
+    acoral_u32 wire_gap;///<按序号推算丢失的紧凑编码帧数
+    acoral_32 wire_seq;///<上一帧序号，-1表示还没有收到
+    acoral_u32 wire_lost[TR_CPU_MAX];///<各cpu目标端报告的丢失记录数
+    FILE *out;///<输出
+    acoral_u32 events;///<已输出的事件数
+}tr_t;
+
+///Ctrl-C停止读取
+static volatile sig_atomic_t tr_stop;
+
+/**
+ * @brief SIGINT处理，停止读取后照常输出
+ *
+ * @param sig 信号
+ */
+static void tr_sigint(int sig)
+{
+    (void)sig;
+    tr_stop=1;
+}
+
+/**
+ * @brief 读取小端u32
+ *
+ * @param p 数据
+ * @return acoral_u32 值
+ */
+static acoral_u32 tr_u32(const acoral_u8 *p)
+{
+    return (acoral_u32)p[0]|((acoral_u32)p[1]<<8)|((acoral_u32)p[2]<<16)|((acoral_u32)p[3]<<24);
+}
+
+/**
+ * @brief 扩容数组
+ *
+ * @param ptr 数组指针
+ * @param cap 容量
+ * @param num 需要的元素数
+ * @param size 元素大小
+ */
+static void tr_grow(void **ptr, acoral_u32 *cap, acoral_u32 num, size_t size)
+{
+    void *p;
+    if(num<=*cap)
+        return;
+    *cap=*cap?*cap*2:256;
+    p=realloc(*ptr,*cap*size);
+    if(p==NULL)
+    {
+        fprintf(stderr,"out of memory\n");
+        exit(2);
+    }
+    *ptr=p;
+}
+
+/**
+ * @brief 复制定长名字
+ *
+ * @param dst 目标，至少33字节
+ * @param src 源，32字节，不一定以0结尾
+ */
+static void tr_name(char *dst, const acoral_u8 *src)
+{
+    memcpy(dst,src,32);
+    dst[32]='\0';
+}
+
+/**
+ * @brief 追加一条追踪记录
+ *
+ * @param tr 转换状态
+ * @return tr_rec_t* 记录，seq已填好
+ */
+static tr_rec_t *tr_rec_new(tr_t *tr)
+{
+    tr_rec_t *rec;
+    tr_grow((void **)&tr->rec,&tr->rec_cap,tr->rec_num+1,sizeof(tr_rec_t));
+    rec=&tr->rec[tr->rec_num];
+    memset(rec,0,sizeof(*rec));
+    rec->seq=tr->rec_num++;
+    return rec;
+}
+
+/**
+ * @brief 处理一帧
+ *
+ * @param tr 转换状态
+ * @param type 帧类型
+ * @param p 负载
+ * @param len 负载长度
+ */
+static void tr_frame(tr_t *tr, acoral_u32 type, const acoral_u8 *p, acoral_u32 len)
+{
+    tr_rec_t *rec;
+    tr_info_t *info;
+    acoral_u32 id;
+    if(type==1&&len>=TR_CORE_SIZE)
+    {
+        id=tr_u32(p);
+        if(id<TR_CPU_MAX)
+            tr_name(tr->cpu[id].name,p+8);
+    }
+    else if(type==2&&len>=TR_THREAD_SIZE)
+    {
+        tr_grow((void **)&tr->info,&tr->info_cap,tr->info_num+1,sizeof(tr_info_t));
+        info=&tr->info[tr->info_num++];
+        info->prio=tr_u32(p+4);
+        info->tcb=tr_u32(p+8);
+        info->cpu=tr_u32(p+20);
+        tr_name(info->name,p+28);
+    }
+    else if(type==3&&len>=TR_REC_SIZE)
+    {
+        rec=tr_rec_new(tr);
+        rec->ts=(acoral_u64)tr_u32(p)|((acoral_u64)tr_u32(p+4)<<32);
+        rec->type=(acoral_u16)(p[8]|(p[9]<<8));
+        rec->cpu=(acoral_u16)(p[10]|(p[11]<<8));
+        rec->arg[0]=tr_u32(p+12);
+        rec->arg[1]=tr_u32(p+16);
+        rec->arg[2]=tr_u32(p+20);
+        if(rec->cpu>=TR_CPU_MAX)
+            tr->rec_num--;
+    }
+}
+
+/**
+ * @brief 计算CRC16-CCITT，与monitor.c一致
+ *
+ * @param p 数据
+ * @param len 字节数
+ * @return acoral_u16 CRC
+ */
+static acoral_u16 tr_crc16(const acoral_u8 *p, acoral_u32 len)
+{
+    acoral_u16 crc=0xFFFF;
+    int i;
+    while(len-->0)
+    {
+        crc^=(acoral_u16)(*p++)<<8;
+        for(i=0;i<8;i++)
+            crc=crc&0x8000?(acoral_u16)((crc<<1)^0x1021):(acoral_u16)(crc<<1);
+    }
+    return crc;
+}
+
+/**
+ * @brief 读取protobuf变长整数
+ *
+ * @param p 数据
+ * @param len 数据长度
+ * @param pos 读取位置，成功后前移
+ * @param v 返回值
+ * @return int 0成功，-1数据不完整
+ */
+static int tr_varint(const acoral_u8 *p, acoral_u32 len, acoral_u32 *pos, acoral_u64 *v)
+{
+    acoral_u32 shift=0;
+    *v=0;
+    while(*pos<len&&shift<64)
+    {
+        *v|=(acoral_u64)(p[*pos]&0x7F)<<shift;
+        if((p[(*pos)++]&0x80)==0)
+            return 0;
+        shift+=7;
+    }
+    return -1;
+}
+
+/**
+ * @brief 读取protobuf字段，varint字段返回值，长度字段返回内容位置
+ *
+ * @param p 数据
+ * @param len 数据长度
+ * @param pos 读取位置，成功后前移到下一个字段
+ * @param field 返回字段号
+ * @param v 返回varint值或长度字段的长度
+ * @param data 返回长度字段内容，varint字段为NULL
+ * @return int 0成功，-1数据不完整或不支持的类型
+ */
+static int tr_pb_field(const acoral_u8 *p, acoral_u32 len, acoral_u32 *pos, acoral_u32 *field, acoral_u64 *v, const acoral_u8 **data)
+{
+    acoral_u64 key;
+    if(tr_varint(p,len,pos,&key)<0)
+        return -1;
+    *field=(acoral_u32)(key>>3);
+    *data=NULL;
+    switch(key&7)
+    {
+        case 0:
+            return tr_varint(p,len,pos,v);
+        case 2:
+            if(tr_varint(p,len,pos,v)<0||*v>len-*pos)
+                return -1;
+            *data=p+*pos;
+            *pos+=(acoral_u32)*v;
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief 复制protobuf字符串字段
+ *
+ * @param dst 目标，至少33字节
+ * @param src 源
+ * @param len 长度
+ */
+static void tr_pb_name(char *dst, const acoral_u8 *src, acoral_u64 len)
+{
+    if(len>32)
+        len=32;
+    memcpy(dst,src,(size_t)len);
+    dst[len]='\0';
+}
+
+/**
+ * @brief 事件的参数个数，与monitor.c一致
+ *
+ * @param type 事件
+ * @return acoral_u32 参数个数
+ */
+static acoral_u32 tr_wire_args(acoral_u32 type)
+{
+    switch(type)
+    {
+        case TR_IRQ_ENTER:
+        case TR_IRQ_EXIT:
+            return 1;
+        case TR_WAKE:
+        case TR_IPI_RECV:
+        case TR_IPC_BLOCK:
+        case TR_IPC_UNBLOCK:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+/**
+ * @brief 解码AcoSimTraceBatch的事件字段
+ *
+ * @param tr 转换状态
+ * @param cpu cpu
+ * @param ts 第一个事件的时间戳
+ * @param p 事件
+ * @param len 字节数
+ */
+static void tr_wire_events(tr_t *tr, acoral_u32 cpu, acoral_u64 ts, const acoral_u8 *p, acoral_u32 len)
+{
+    tr_rec_t *rec;
+    acoral_u64 type,delta,arg;
+    acoral_u32 pos=0,i,num;
+    while(pos<len)
+    {
+        if(tr_varint(p,len,&pos,&type)<0||tr_varint(p,len,&pos,&delta)<0)
+            return;
+        ts+=delta;
+        rec=tr_rec_new(tr);
+        rec->ts=ts;
+        rec->type=(acoral_u16)type;
+        rec->cpu=(acoral_u16)cpu;
+        num=tr_wire_args((acoral_u32)type);
+        for(i=0;i<num;i++)
+        {
+            if(tr_varint(p,len,&pos,&arg)<0)
+            {
+                tr->rec_num--;//不完整的事件，CRC通过时不应出现
+                return;
+            }
+            rec->arg[i]=(acoral_u32)arg;
+        }
+    }
+}
+
+/**
+ * @brief 处理一个紧凑编码帧的负载
+ *
+ * @param tr 转换状态
+ * @param type 帧类型
+ * @param p 负载
+ * @param len 负载长度
+ */
+static void tr_wire_frame(tr_t *tr, acoral_u32 type, const acoral_u8 *p, acoral_u32 len)
+{
+    tr_info_t info;
+    acoral_u32 pos=0,field,cpu=0,events_len=0;
+    acoral_u64 v,base=0,lost=0;
+    const acoral_u8 *data,*events=NULL;
+    char name[33]="";
+    memset(&info,0,sizeof(info));
+    while(pos<len)
+    {
+        if(tr_pb_field(p,len,&pos,&field,&v,&data)<0)
+            return;
+        if(type==1)
+        {
+            if(field==1&&data==NULL)
+                cpu=(acoral_u32)v;
+            else if(field==2&&data!=NULL)
+                tr_pb_name(name,data,v);
+        }
+        else if(type==2)
+        {
+            if(field==1&&data==NULL)
+                info.tcb=(acoral_u32)v;
+            else if(field==3&&data==NULL)
+                info.prio=(acoral_u32)v;
+            else if(field==6&&data==NULL)
+                info.cpu=(acoral_u32)v;
+            else if(field==8&&data!=NULL)
+                tr_pb_name(info.name,data,v);
+        }
+        else if(type==3)
+        {
+            if(field==1&&data==NULL)
+                cpu=(acoral_u32)v;
+            else if(field==2&&data==NULL)
+                base=v;
+            else if(field==3&&data==NULL)
+                lost=v;
+            else if(field==4&&data!=NULL)
+            {
+                events=data;
+                events_len=(acoral_u32)v;
+            }
+        }
+    }
+    if(type==1&&cpu<TR_CPU_MAX)
+        snprintf(tr->cpu[cpu].name,sizeof(tr->cpu[cpu].name),"%s",name);
+    else if(type==2)
+    {
+        tr_grow((void **)&tr->info,&tr->info_cap,tr->info_num+1,sizeof(tr_info_t));
+        tr->info[tr->info_num++]=info;
+    }
+    else if(type==3&&cpu<TR_CPU_MAX)
+    {
+        tr->wire_lost[cpu]=(acoral_u32)lost;
+        if(events!=NULL)
+            tr_wire_events(tr,cpu,base,events,events_len);
+    }
+}
+
+/**
+ * @brief 尝试在pos处解析一个紧凑编码帧
+ *
+ * @param tr 转换状态
+ * @param buf 数据
+ * @param len 数据长度
+ * @param pos 位置，buf[pos]为0xA5
+ * @return acoral_u32 帧长度；0表示数据不够，需要继续读取；1表示不是有效帧，跳过一个字节
+ */
+static acoral_u32 tr_wire_try(tr_t *tr, const acoral_u8 *buf, acoral_u32 len, acoral_u32 pos)
+{
+    acoral_u32 plen,seq;
+    const acoral_u8 *f=buf+pos;
+    if(len-pos<TR_WIRE_HEAD)
+        return 0;
+    if(f[1]!=0x5A)
+        return 1;
+    plen=(acoral_u32)f[4]|((acoral_u32)f[5]<<8);
+    if(plen>TR_PAYLOAD_MAX)
+        return 1;
+    if(len-pos<TR_WIRE_HEAD+plen+TR_WIRE_CRC)
+        return 0;
+    if(tr_crc16(f+2,TR_WIRE_HEAD-2+plen)!=((acoral_u32)f[TR_WIRE_HEAD+plen]|((acoral_u32)f[TR_WIRE_HEAD+plen+1]<<8)))
+    {
+        tr->wire_crc++;
+        return 1;
+    }
+    seq=f[3];
+    if(tr->wire_seq>=0)
+        tr->wire_gap+=(seq-(acoral_u32)tr->wire_seq-1)&0xFF;
+    tr->wire_seq=(acoral_32)seq;
+    tr->wire_frames++;
+    tr_wire_frame(tr,f[2],f+TR_WIRE_HEAD,plen);
+    return TR_WIRE_HEAD+plen+TR_WIRE_CRC;
+}
+
+/**
+ * @brief 读取帧流直到文件结束或Ctrl-C，帧头不对时逐字节重新同步
+ *
+ * @param tr 转换状态
+ * @param fd 输入
+ * @return int 0成功，-1读取错误
+ */
+static int tr_read(tr_t *tr, int fd)
+{
+    static acoral_u8 buf[65536];
+    acoral_u32 len=0,pos,plen,flen;
+    ssize_t n;
+    while(!tr_stop)
+    {
+        n=read(fd,buf+len,sizeof(buf)-len);
+        if(n<0)
+        {
+            if(errno==EINTR)
+                continue;
+            perror("read");
+            return -1;
+        }
+        if(n==0)
+            break;
+        len+=(acoral_u32)n;
+        pos=0;
+        while(len-pos>=TR_WIRE_HEAD)
+        {
+            if(buf[pos]==0xA5)
+            {
+                flen=tr_wire_try(tr,buf,len,pos);
+                if(flen==0)
+                    break;
+                if(flen==1)
+                    tr->bad++;
+                pos+=flen;
+                continue;
+            }
+            if(len-pos<TR_HEADER_SIZE)
+                break;
+            if(memcmp(buf+pos,"++++",4)!=0)
+            {
+                pos++;
+                tr->bad++;
+                continue;
+            }
+            plen=tr_u32(buf+pos+8);
+            if(plen>TR_PAYLOAD_MAX)
+            {
+                pos++;
+                tr->bad++;
+                continue;
+            }
+            if(len-pos<TR_HEADER_SIZE+plen)
+                break;
+            tr_frame(tr,tr_u32(buf+pos+4),buf+pos+TR_HEADER_SIZE,plen);
+            pos+=TR_HEADER_SIZE+plen;
+        }
+        memmove(buf,buf+pos,len-pos);
+        len-=pos;
+    }
+    return 0;
+}
+
+/**
+ * @brief 打开输入，串口设备设为raw模式
+ *
+ * @param path 路径，"-"为标准输入
+ * @param baud 波特率
+ * @return int 文件描述符，失败返回-1
+ */
+static int tr_open(const char *path, acoral_u32 baud)
+{
+    struct termios tio;
+    speed_t speed;
+    int fd;
+    if(strcmp(path,"-")==0)
+        return 0;
+    fd=open(path,O_RDONLY|O_NOCTTY);
+    if(fd<0)
+    {
+        perror(path);
+        return -1;
+    }
+    if(!isatty(fd))
+        return fd;
+    switch(baud)
+    {
+        case 9600:speed=B9600;break;
+        case 57600:speed=B57600;break;
+        case 230400:speed=B230400;break;
+        case 460800:speed=B460800;break;
+        case 921600:speed=B921600;break;
+        default:speed=B115200;break;
+    }
+    if(tcgetattr(fd,&tio)==0)
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio,speed);
+        cfsetospeed(&tio,speed);
+        tio.c_cc[VMIN]=1;
+        tio.c_cc[VTIME]=0;
+        tcsetattr(fd,TCSANOW,&tio);
+    }
+    return fd;
+}
+
+/**
+ * @brief 记录排序：时间戳，其次到达顺序
+ *
+ * @param a 记录a
+ * @param b 记录b
+ * @return int 比较结果
+ */
+static int tr_rec_cmp(const void *a, const void *b)
+{
+    const tr_rec_t *x=(const tr_rec_t *)a,*y=(const tr_rec_t *)b;
+    if(x->ts!=y->ts)
+        return x->ts<y->ts?-1:1;
+    return x->seq<y->seq?-1:(x->seq>y->seq);
+}
+
+/**
+ * @brief cycles转为相对第一条记录的微秒
+ *
+ * @param tr 转换状态
+ * @param ts 时间戳
+ * @return double 微秒
+ */
+static double tr_us(tr_t *tr, acoral_u64 ts)
+{
+    return (double)(ts-tr->t0)*1e6/tr->hz;
+}
+
+/**
+ * @brief 输出JSON字符串，转义引号、反斜杠和控制字符
+ *
+ * @param fp 输出
+ * @param s 字符串
+ */
+static void tr_json_str(FILE *fp, const char *s)
+{
+    fputc('"',fp);
+    for(;*s;s++)
+    {
+        if(*s=='"'||*s=='\\')
+            fprintf(fp,"\\%c",*s);
+        else if((unsigned char)*s<0x20)
+            fprintf(fp,"\\u%04x",(unsigned char)*s);
+        else
+            fputc(*s,fp);
+    }
+    fputc('"',fp);
+}
+
+/**
+ * @brief 开始一个事件对象，处理逗号
+ *
+ * @param tr 转换状态
+ */
+static void tr_event_begin(tr_t *tr)
+{
+    fprintf(tr->out,"%s\n{",tr->events++?",":"");
+}
+
+/**
+ * @brief 输出元数据事件
+ *
+ * @param tr 转换状态
+ * @param what process_name或thread_name
+ * @param pid 进程
+ * @param tid 线程
+ * @param name 名字
+ */
+static void tr_meta(tr_t *tr, const char *what, acoral_u32 pid, acoral_u32 tid, const char *name)
+{
+    tr_event_begin(tr);
+    fprintf(tr->out,"\"ph\":\"M\",\"name\":\"%s\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":",what,pid,tid);
+    tr_json_str(tr->out,name);
+    fprintf(tr->out,"}}");
+}
+
+/**
+ * @brief 输出完整切片
+ *
+ * @param tr 转换状态
+ * @param name 名字
+ * @param cat 类别
+ * @param pid 进程
+ * @param tid 线程
+ * @param start 开始时刻
+ * @param end 结束时刻
+ * @param args 附加参数JSON对象内容，可为NULL
+ */
+static void tr_slice(tr_t *tr, const char *name, const char *cat, acoral_u32 pid, acoral_u32 tid, acoral_u64 start, acoral_u64 end, const char *args)
+{
+    tr_event_begin(tr);
+    fprintf(tr->out,"\"ph\":\"X\",\"name\":");
+    tr_json_str(tr->out,name);
+    fprintf(tr->out,",\"cat\":\"%s\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+            cat,pid,tid,tr_us(tr,start),tr_us(tr,end)-tr_us(tr,start));
+    if(args!=NULL)
+        fprintf(tr->out,",\"args\":{%s}",args);
+    fputc('}',tr->out);
+}
+
+/**
+ * @brief 输出瞬时事件
+ *
+ * @param tr 转换状态
+ * @param name 名字
+ * @param cat 类别
+ * @param pid 进程
+ * @param tid 线程
+ * @param ts 时刻
+ * @param args 附加参数JSON对象内容，可为NULL
+ */
+static void tr_instant(tr_t *tr, const char *name, const char *cat, acoral_u32 pid, acoral_u32 tid, acoral_u64 ts, const char *args)
+{
+    tr_event_begin(tr);
+    fprintf(tr->out,"\"ph\":\"i\",\"s\":\"t\",\"name\":");
+    tr_json_str(tr->out,name);
+    fprintf(tr->out,",\"cat\":\"%s\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f",cat,pid,tid,tr_us(tr,ts));
+    if(args!=NULL)
+        fprintf(tr->out,",\"args\":{%s}",args);
+    fputc('}',tr->out);
+}
+
+/**
+ * @brief 新建线程，名字取该tcb第born+1次出现的线程信息
+ *
+ * @param tr 转换状态
+ * @param tcb tcb指针
+ * @param born 该tcb之前已创建的次数
+ * @return tr_thread_t* 线程
+ */
+static tr_thread_t *tr_thread_new(tr_t *tr, acoral_u32 tcb, acoral_u32 born)
+{
+    tr_thread_t *th;
+    acoral_u32 i,k=0;
+    const char *name=NULL;
+    tr_grow((void **)&tr->thread,&tr->thread_cap,tr->thread_num+1,sizeof(tr_thread_t));
+    th=&tr->thread[tr->thread_num];
+    memset(th,0,sizeof(*th));
+    th->tcb=tcb;
+    th->tid=tr->thread_num++;
+    th->born=born;
+    for(i=0;i<tr->info_num;i++)
+    {
+        if(tr->info[i].tcb!=tcb)
+            continue;
+        name=tr->info[i].name;
+        if(k++==born)
+            break;
+    }
+    if(name!=NULL)
+        snprintf(th->name,sizeof(th->name),"%s",name);
+    else if(tr->wire_frames!=0)
+        snprintf(th->name,sizeof(th->name),"task %u",tcb);
+    else
+        snprintf(th->name,sizeof(th->name),"0x%08x",tcb);
+    return th;
+}
+
+/**
+ * @brief 按tcb查找最近创建的线程，没有则新建
+ *
+ * @param tr 转换状态
+ * @param tcb tcb指针
+ * @return tr_thread_t* 线程
+ */
+static tr_thread_t *tr_thread_get(tr_t *tr, acoral_u32 tcb)
+{
+    acoral_u32 i;
+    for(i=tr->thread_num;i>0;i--)
+    {
+        if(tr->thread[i-1].tcb==tcb)
+            return &tr->thread[i-1];
+    }
+    return tr_thread_new(tr,tcb,0);
+}
+
+/**
+ * @brief 改变线程状态，输出上一状态的切片
+ *
+ * @param tr 转换状态
+ * @param th 线程
+ * @param state 新状态
+ * @param ts 时刻
+ */
+static void tr_thread_state(tr_t *tr, tr_thread_t *th, tr_state_t state, acoral_u64 ts)
+{
+    static const char *name[]={"","running","ready","blocked"};
+    char args[64];
+    if(th->state!=TR_NONE&&ts>th->since)
+    {
+        if(th->state==TR_BLOCKED&&th->ipc!=0)
+        {
+            snprintf(args,sizeof(args),"\"ipc\":\"0x%08x\"",th->ipc);
+            tr_slice(tr,name[th->state],"state",1,th->tid,th->since,ts,args);
+        }
+        else
+            tr_slice(tr,name[th->state],"state",1,th->tid,th->since,ts,NULL);
+    }
+    th->state=state;
+    th->since=ts;
+}
+
+/**
+ * @brief 处理一次切换
+ *
+ * @param tr 转换状态
+ * @param rec 记录
+ */
+static void tr_on_switch(tr_t *tr, tr_rec_t *rec)
+{
+    tr_cpu_t *cpu=&tr->cpu[rec->cpu];
+    tr_thread_t *from=tr_thread_get(tr,rec->arg[0]);
+    tr_thread_t *to;
+    acoral_u32 to_idx;
+    acoral_u64 lat;
+    char args[64];
+    if(cpu->cur!=0&&tr->thread[cpu->cur-1].tcb==rec->arg[0])
+        tr_slice(tr,from->name,"sched",0,rec->cpu,cpu->since,rec->ts,NULL);
+    if(rec->arg[2]&TR_STATE_EXIT)
+        tr_thread_state(tr,from,TR_NONE,rec->ts);
+    else if(rec->arg[2]&TR_STATE_SUSPEND)
+        tr_thread_state(tr,from,TR_BLOCKED,rec->ts);
+    else
+    {
+        tr_thread_state(tr,from,TR_READY,rec->ts);
+        from->wake=rec->ts;//被抢占，从现在开始等待运行
+    }
+    to=tr_thread_get(tr,rec->arg[1]);//可能扩容，之后不再使用from
+    to_idx=(acoral_u32)(to-tr->thread);
+    if(to->wake!=0)
+    {
+        lat=rec->ts-to->wake;
+        to->lat_total+=lat;
+        to->lat_num++;
+        if(lat>to->lat_max)
+        {
+            to->lat_max=lat;
+            to->lat_at=rec->ts;
+        }
+        if(tr->threshold!=0&&lat>=tr->threshold)
+        {
+            snprintf(args,sizeof(args),"\"latency_us\":%.3f",(double)lat*1e6/tr->hz);
+            tr_instant(tr,"latency outlier","latency",1,to->tid,rec->ts,args);
+        }
+        to->wake=0;
+    }
+    to->runs++;
+    tr_thread_state(tr,to,TR_RUNNING,rec->ts);
+    cpu->cur=to_idx+1;
+    cpu->since=rec->ts;
+}
+
+/**
+ * @brief 按时间顺序处理全部记录并输出JSON
+ *
+ * @param tr 转换状态
+ */
+static void tr_convert(tr_t *tr)
+{
+    tr_rec_t *rec;
+    tr_thread_t *th;
+    tr_cpu_t *cpu;
+    acoral_u64 end,dur;
+    acoral_u32 i,id,born;
+    char name[64],args[96];
+    qsort(tr->rec,tr->rec_num,sizeof(tr_rec_t),tr_rec_cmp);
+    tr->t0=tr->rec_num?tr->rec[0].ts:0;
+    end=tr->rec_num?tr->rec[tr->rec_num-1].ts:0;
+    fprintf(tr->out,"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for(i=0;i<tr->rec_num;i++)
+    {
+        rec=&tr->rec[i];
+        cpu=&tr->cpu[rec->cpu];
+        if((acoral_u32)rec->cpu+1>tr->cpu_num)
+            tr->cpu_num=rec->cpu+1;
+        switch(rec->type)
+        {
+            case TR_SWITCH:
+                tr_on_switch(tr,rec);
+                break;
+            case TR_WAKE:
+                th=tr_thread_get(tr,rec->arg[0]);
+                if(th->state!=TR_RUNNING)
+                {
+                    th->wake=rec->ts;
+                    th->ipc=0;
+                    tr_thread_state(tr,th,TR_READY,rec->ts);
+                }
+                break;
+            case TR_CREATE:
+                for(born=0,id=0;id<tr->thread_num;id++)
+                {
+                    if(tr->thread[id].tcb==rec->arg[0])
+                        born++;
+                }
+                th=tr_thread_new(tr,rec->arg[0],born);
+                snprintf(args,sizeof(args),"\"prio\":%u,\"cpu\":%u",rec->arg[1],rec->arg[2]);
+                tr_instant(tr,"create","sched",1,th->tid,rec->ts,args);
+                th->wake=rec->ts;
+                tr_thread_state(tr,th,TR_READY,rec->ts);
+                break;
+            case TR_IRQ_ENTER:
+                if(cpu->irq_depth<TR_IRQ_DEPTH)
+                {
+                    cpu->irq_id[cpu->irq_depth]=rec->arg[0];
+                    cpu->irq_ts[cpu->irq_depth]=rec->ts;
+                }
+                cpu->irq_depth++;
+                break;
+            case TR_IRQ_EXIT:
+                if(cpu->irq_depth==0)
+                    break;
+                cpu->irq_depth--;
+                if(cpu->irq_depth>=TR_IRQ_DEPTH||cpu->irq_id[cpu->irq_depth]!=rec->arg[0])
+                    break;
+                id=rec->arg[0];
+                dur=rec->ts-cpu->irq_ts[cpu->irq_depth];
+                if(id==0)
+                    snprintf(name,sizeof(name),"irq 0 (ipi)");
+                else if(id==29)
+                    snprintf(name,sizeof(name),"irq 29 (tick)");
+                else
+                    snprintf(name,sizeof(name),"irq %u",id);
+                tr_slice(tr,name,"irq",0,TR_IRQ_TID+rec->cpu,cpu->irq_ts[cpu->irq_depth],rec->ts,NULL);
+                if(id<TR_IRQ_MAX)
+                {
+                    tr->irq[id].num++;
+                    tr->irq[id].total+=dur;
+                    if(dur>tr->irq[id].max)
+                        tr->irq[id].max=dur;
+                }
+                break;
+            case TR_IPI_SEND:
+                snprintf(args,sizeof(args),"\"to\":%u,\"cmd\":%u,\"thread_id\":%d",rec->arg[0],rec->arg[1],(acoral_32)rec->arg[2]);
+                tr_instant(tr,"ipi send","ipi",0,rec->cpu,rec->ts,args);
+                break;
+            case TR_IPI_RECV:
+                snprintf(args,sizeof(args),"\"cmd\":%u,\"thread_id\":%d",rec->arg[0],(acoral_32)rec->arg[1]);
+                tr_instant(tr,"ipi recv","ipi",0,rec->cpu,rec->ts,args);
+                break;
+            case TR_IPC_BLOCK:
+                th=tr_thread_get(tr,rec->arg[0]);
+                th->ipc=rec->arg[1];
+                break;
+            case TR_IPC_UNBLOCK:
+                th=tr_thread_get(tr,rec->arg[0]);
+                snprintf(args,sizeof(args),"\"ipc\":\"0x%08x\"",rec->arg[1]);
+                tr_instant(tr,"ipc unblock","ipc",1,th->tid,rec->ts,args);
+                break;
+            default:
+                break;
+        }
+    }
+    //收尾：输出仍在进行的切片
+    for(i=0;i<tr->cpu_num;i++)
+    {
+        if(tr->cpu[i].cur!=0)
+            tr_slice(tr,tr->thread[tr->cpu[i].cur-1].name,"sched",0,i,tr->cpu[i].since,end,NULL);
+    }
+    for(i=0;i<tr->thread_num;i++)
+        tr_thread_state(tr,&tr->thread[i],TR_NONE,end);
+    tr_meta(tr,"process_name",0,0,"cores");
+    tr_meta(tr,"process_name",1,0,"threads");
+    for(i=0;i<tr->cpu_num;i++)
+    {
+        if(tr->cpu[i].name[0]=='\0')
+            snprintf(tr->cpu[i].name,sizeof(tr->cpu[i].name),"CPU %u",i);
+        tr_meta(tr,"thread_name",0,i,tr->cpu[i].name);
+        snprintf(name,sizeof(name),"%s irq",tr->cpu[i].name);
+        tr_meta(tr,"thread_name",0,TR_IRQ_TID+i,name);
+    }
+    for(i=0;i<tr->thread_num;i++)
+        tr_meta(tr,"thread_name",1,tr->thread[i].tid,tr->thread[i].name);
+    fprintf(tr->out,"\n]}\n");
+}
+
+/**
+ * @brief 标准错误输出延迟统计
+ *
+ * @param tr 转换状态
+ */
+static void tr_report(tr_t *tr)
+{
+    acoral_u32 i;
+    tr_thread_t *th;
+    fprintf(stderr,"%u records, %u thread infos, %u bytes skipped, span %.3f ms\n",
+            tr->rec_num,tr->info_num,tr->bad,
+            tr->rec_num?(double)(tr->rec[tr->rec_num-1].ts-tr->t0)*1e3/tr->hz:0.0);
+    if(tr->wire_frames!=0||tr->wire_crc!=0)
+    {
+        fprintf(stderr,"compact frames: %u ok, %u crc errors, %u missing by sequence\n",
+                tr->wire_frames,tr->wire_crc,tr->wire_gap);
+        for(i=0;i<TR_CPU_MAX;i++)
+        {
+            if(tr->wire_lost[i]!=0)
+                fprintf(stderr,"cpu %u: %u records lost on target\n",i,tr->wire_lost[i]);
+        }
+    }
+    fprintf(stderr,"%-24s %8s %12s %12s %14s\n","thread","runs","lat_max_us","lat_avg_us","at_us");
+    for(i=0;i<tr->thread_num;i++)
+    {
+        th=&tr->thread[i];
+        if(th->runs==0)
+            continue;
+        fprintf(stderr,"%-24s %8u %12.3f %12.3f %14.3f\n",th->name,th->runs,
+                (double)th->lat_max*1e6/tr->hz,
+                th->lat_num?(double)th->lat_total/th->lat_num*1e6/tr->hz:0.0,
+                th->lat_max?tr_us(tr,th->lat_at):0.0);
+    }
+    fprintf(stderr,"%-24s %8s %12s %12s\n","irq","num","max_us","avg_us");
+    for(i=0;i<TR_IRQ_MAX;i++)
+    {
+        if(tr->irq[i].num==0)
+            continue;
+        fprintf(stderr,"%-24u %8u %12.3f %12.3f\n",i,tr->irq[i].num,
+                (double)tr->irq[i].max*1e6/tr->hz,
+                (double)tr->irq[i].total/tr->irq[i].num*1e6/tr->hz);
+    }
+}
+
+/**
+ * @brief 打印用法
+ *
+ * @param prog 程序名
+ */
+static void tr_usage(const char *prog)
+{
+    fprintf(stderr,"usage: %s [-b baud] [-f hz] [-t us] [-o out.json] <capture|serial device|->\n"
+                   "  -b  serial baud rate, default 115200\n"
+                   "  -f  timestamp clock in Hz, default 333333333 (zynq global timer)\n"
+                   "  -t  mark ready-to-run latencies at least this many us\n"
+                   "  -o  output file, default stdout\n",prog);
+}
+
+/**
+ * @brief 解析无符号十进制数
+ *
+ * @param s 字符串
+ * @param v 返回值
+ * @return int 0成功，-1失败
+ */
+static int tr_parse_u32(const char *s, acoral_u32 *v)
+{
+    char *end;
+    unsigned long x;
+    errno=0;
+    x=strtoul(s,&end,10);
+    if(errno||end==s||*end!='\0'||x>0xffffffffUL)
+        return -1;
+    *v=(acoral_u32)x;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static tr_t tr;
+    struct sigaction sa;
+    acoral_u32 baud=115200,hz=333333333,threshold=0;
+    const char *out=NULL;
+    int fd,i;
+    for(i=1;i<argc&&argv[i][0]=='-'&&argv[i][1]!='\0';i++)
+    {
+        if(strcmp(argv[i],"-o")==0&&i+1<argc)
+            out=argv[++i];
+        else if(strcmp(argv[i],"-b")==0&&i+1<argc&&tr_parse_u32(argv[i+1],&baud)==0)
+            i++;
+        else if(strcmp(argv[i],"-f")==0&&i+1<argc&&tr_parse_u32(argv[i+1],&hz)==0&&hz>0)
+            i++;
+        else if(strcmp(argv[i],"-t")==0&&i+1<argc&&tr_parse_u32(argv[i+1],&threshold)==0)
+            i++;
+        else
+        {
+            tr_usage(argv[0]);
+            return 2;
+        }
+    }
+    if(i!=argc-1)
+    {
+        tr_usage(argv[0]);
+        return 2;
+    }
+    tr.hz=hz;
+    tr.wire_seq=-1;
+    tr.threshold=(acoral_u64)threshold*hz/1000000;
+    fd=tr_open(argv[i],baud);
+    if(fd<0)
+        return 2;
+    memset(&sa,0,sizeof(sa));
+    sa.sa_handler=tr_sigint;//不设SA_RESTART，read被打断后停止
+    sigaction(SIGINT,&sa,NULL);
+    if(tr_read(&tr,fd)<0)
+        return 2;
+    if(fd!=0)
+        close(fd);
+    tr.out=out!=NULL?fopen(out,"w"):stdout;
+    if(tr.out==NULL)
+    {
+        perror(out);
+        return 2;
+    }
+    tr_convert(&tr);
+    if(tr.out!=stdout)
+        fclose(tr.out);
+    tr_report(&tr);
+    return 0;
+}
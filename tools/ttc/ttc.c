@@ -0,0 +1,888 @@
+/**
+ * @file ttc.c
+ * @author 胡博文 (@921576434@qq.com)
+ * @brief 主机端时间触发调度表编译工具，生成timed_decode读取的调度表文件
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @par 修订历史
+ *     <table>
+ *         <tr><th>版本 <th>作者 <th>日期 <th>修改内容
+ *         <tr><td>v1.0 <td>胡博文 <td>2026-10-19 <td>创建文件
+ *         <tr><td>v1.1 <td>胡博文 <td>2026-10-19 <td>超周期固定写CFG_MAX_CPU个，线程数量位置与timed_decode一致
+ *
+ * 线程描述文件，每行一条，#之后为注释，时间单位ms：
+ *   cpus <n>                                     使用的cpu数量，不超过目标的CFG_MAX_CPU，默认为CFG_MAX_CPU
+ *   thread <名字> <周期> <cpu> <wcet1> [wcet2 ...] [dl=<截止时间>]
+ *                                                时间确定性线程，各段按顺序执行
+ *   prec <线程>.<段> <线程>.<段>                   前者结束后后者才能开始，
+ *                                                后者的每个实例依赖前者最近一次释放的实例
+ *
+ * 超周期为全部周期的最小公倍数，每个段实例在[释放时刻, 截止时间]内不可抢占地执行，
+ * 用非抢占表调度（可插入空闲）加随机扰动搜索可行的时间表。
+ * 调度表文件布局与components/tmp/lib/src/timed.c中timed_decode一致：
+ *   0   魔数3e 13 ff ff
+ *   4   各cpu超周期，u32小端，共CFG_MAX_CPU个，未使用的cpu为0
+ *   4+4*CFG_MAX_CPU  线程数量，u8
+ *   16  各线程数据偏移，u8
+ *   线程数据12字节：周期u32，段数量u8，执行次数u8，时间数组偏移u8，cpu u8，4字节保留
+ *   时间数组：各段执行时间u32，之后每次执行各段的开始时刻u32
+ * 线程在文件中的顺序与描述文件一致，对应timed_decode的段函数表下标。
+ * 目标的CFG_MAX_CPU在编译本工具时用TTC_MAX_CPU指定（make MAX_CPU=<n>），默认2。
+ * 退出码：0可行，1不可行，2输入错误
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <type.h>
+
+///单行最大长度
+#define LINE_MAX_LEN 1024
+///未安排
+#define TTC_NONE 0xffffffff
+///调度表文件中线程偏移表位置
+#define TTC_OFFSET_POS 16
+///调度表文件中线程数据大小（目标上的timed_thread_config_t）
+#define TTC_THREAD_SIZE 12
+#ifndef TTC_MAX_CPU
+///目标的CFG_MAX_CPU，timed_decode按它读取超周期
+#define TTC_MAX_CPU 2
+#endif
+///调度表文件中线程数量位置
+#define TTC_THREAD_NUM_POS (4+4*TTC_MAX_CPU)
+
+#if TTC_MAX_CPU < 1 || TTC_THREAD_NUM_POS >= TTC_OFFSET_POS
+#error "timed_decode reads the thread offsets at byte 16, TTC_MAX_CPU must be 1 to 2"
+#endif
+
+/**
+ * @brief 时间确定性线程
+ *
+ */
+typedef struct{
+    char *name;///<线程名字
+    acoral_u32 period;///<周期
+    acoral_u32 dl;///<相对截止时间
+    acoral_u32 cpu;///<所在cpu
+    acoral_u32 section_num;///<段数量
+    acoral_u32 *wcet;///<各段执行时间
+    acoral_u32 first;///<第一个段实例在段实例表中的下标
+}ttc_thread_t;
+
+/**
+ * @brief 段之间的前后约束
+ *
+ */
+typedef struct{
+    acoral_u32 from;///<前驱线程
+    acoral_u32 from_sec;///<前驱段，从0开始
+    acoral_u32 to;///<后继线程
+    acoral_u32 to_sec;///<后继段，从0开始
+}ttc_prec_t;
+
+/**
+ * @brief 段实例，即某个线程第job次执行的第sec段
+ *
+ */
+typedef struct{
+    acoral_u32 thread;///<线程下标
+    acoral_u32 job;///<执行次序
+    acoral_u32 sec;///<段下标
+    acoral_u32 release;///<最早开始时刻
+    acoral_u32 deadline;///<最晚结束时刻
+    acoral_u32 wcet;///<执行时间
+    acoral_u32 pred[2];///<前驱段实例，本线程上一段与前后约束各一个，无为TTC_NONE
+    acoral_u32 *pred_ext;///<其他前后约束的前驱段实例
+    acoral_u32 pred_ext_num;///<其他前驱数量
+    acoral_u32 start;///<安排的开始时刻
+    acoral_u32 key;///<搜索时的优先级键，越小越优先
+}ttc_item_t;
+
+/**
+ * @brief 输入与搜索状态
+ *
+ */
+typedef struct{
+    acoral_u32 cpu_num;///<cpu数量
+    ttc_thread_t *thread;///<线程表
+    acoral_u32 thread_num;///<线程数量
+    ttc_prec_t *prec;///<前后约束表
+    acoral_u32 prec_num;///<前后约束数量
+    ttc_item_t *item;///<段实例表
+    acoral_u32 item_num;///<段实例数量
+    acoral_u32 h_period;///<超周期
+    acoral_u32 margin;///<每段结束后到截止时间或下一段之间的保护时间
+    acoral_u32 *best;///<最优开始时刻
+    acoral_u32 *cpu_free;///<搜索时各cpu空闲时刻
+}ttc_t;
+
+/**
+ * @brief 分配内存，失败时退出
+ *
+ * @param ptr 原内存
+ * @param size 大小
+ * @return void* 新内存
+ */
+static void *ttc_realloc(void *ptr, size_t size)
+{
+    void *ret=realloc(ptr,size?size:1);
+    if(ret==NULL)
+    {
+        fprintf(stderr,"out of memory\n");
+        exit(2);
+    }
+    return ret;
+}
+
+/**
+ * @brief 复制字符串
+ *
+ * @param s 字符串
+ * @return char* 副本
+ */
+static char *ttc_strdup(const char *s)
+{
+    char *ret=ttc_realloc(NULL,strlen(s)+1);
+    strcpy(ret,s);
+    return ret;
+}
+
+/**
+ * @brief 解析无符号整数
+ *
+ * @param s 字符串
+ * @param value 结果
+ * @return int 0成功，-1失败
+ */
+static int ttc_parse_u32(const char *s, acoral_u32 *value)
+{
+    char *end;
+    unsigned long v;
+    if(s==NULL||*s=='\0')
+        return -1;
+    v=strtoul(s,&end,0);
+    if(*end!='\0'||v>0xffffffffUL)
+        return -1;
+    *value=(acoral_u32)v;
+    return 0;
+}
+
+/**
+ * @brief 最大公约数
+ *
+ * @param a 整数
+ * @param b 整数
+ * @return acoral_u64 最大公约数
+ */
+static acoral_u64 ttc_gcd(acoral_u64 a, acoral_u64 b)
+{
+    acoral_u64 t;
+    while(b)
+    {
+        t=a%b;
+        a=b;
+        b=t;
+    }
+    return a;
+}
+
+/**
+ * @brief 查找线程
+ *
+ * @param ttc 状态
+ * @param name 线程名字
+ * @return acoral_u32 线程下标，不存在时为TTC_NONE
+ */
+static acoral_u32 ttc_thread_find(ttc_t *ttc, const char *name)
+{
+    acoral_u32 i;
+    for(i=0;i<ttc->thread_num;i++)
+    {
+        if(strcmp(ttc->thread[i].name,name)==0)
+            return i;
+    }
+    return TTC_NONE;
+}
+
+/**
+ * @brief 解析thread行
+ *
+ * @param ttc 状态
+ * @param argc 字段数
+ * @param argv 字段
+ * @return int 0成功，-1失败
+ */
+static int ttc_parse_thread(ttc_t *ttc, int argc, char **argv)
+{
+    ttc_thread_t *thread;
+    int k;
+    if(argc<5||ttc_thread_find(ttc,argv[1])!=TTC_NONE)
+        return -1;
+    ttc->thread=ttc_realloc(ttc->thread,sizeof(ttc_thread_t)*(ttc->thread_num+1));
+    thread=&ttc->thread[ttc->thread_num];
+    memset(thread,0,sizeof(ttc_thread_t));
+    thread->name=ttc_strdup(argv[1]);
+    if(ttc_parse_u32(argv[2],&thread->period)<0||thread->period==0)
+        return -1;
+    if(ttc_parse_u32(argv[3],&thread->cpu)<0||thread->cpu>=ttc->cpu_num)
+        return -1;
+    thread->dl=thread->period;
+    thread->wcet=ttc_realloc(NULL,sizeof(acoral_u32)*argc);
+    for(k=4;k<argc;k++)
+    {
+        if(strncmp(argv[k],"dl=",3)==0)
+        {
+            if(ttc_parse_u32(argv[k]+3,&thread->dl)<0||thread->dl==0||thread->dl>thread->period)
+                return -1;
+            continue;
+        }
+        if(ttc_parse_u32(argv[k],&thread->wcet[thread->section_num])<0||thread->wcet[thread->section_num]==0)
+            return -1;
+        thread->section_num++;
+    }
+    if(thread->section_num==0)
+        return -1;
+    ttc->thread_num++;
+    return 0;
+}
+
+/**
+ * @brief 解析<线程>.<段>
+ *
+ * @param ttc 状态
+ * @param s 字符串
+ * @param thread 线程下标
+ * @param sec 段下标
+ * @return int 0成功，-1失败
+ */
+static int ttc_parse_ref(ttc_t *ttc, char *s, acoral_u32 *thread, acoral_u32 *sec)
+{
+    char *dot=strrchr(s,'.');
+    if(dot==NULL)
+        return -1;
+    *dot='\0';
+    *thread=ttc_thread_find(ttc,s);
+    if(*thread==TTC_NONE||ttc_parse_u32(dot+1,sec)<0||*sec==0||*sec>ttc->thread[*thread].section_num)
+        return -1;
+    (*sec)--;
+    return 0;
+}
+
+/**
+ * @brief 解析prec行
+ *
+ * @param ttc 状态
+ * @param argc 字段数
+ * @param argv 字段
+ * @return int 0成功，-1失败
+ */
+static int ttc_parse_prec(ttc_t *ttc, int argc, char **argv)
+{
+    ttc_prec_t *prec;
+    if(argc!=3)
+        return -1;
+    ttc->prec=ttc_realloc(ttc->prec,sizeof(ttc_prec_t)*(ttc->prec_num+1));
+    prec=&ttc->prec[ttc->prec_num];
+    if(ttc_parse_ref(ttc,argv[1],&prec->from,&prec->from_sec)<0||ttc_parse_ref(ttc,argv[2],&prec->to,&prec->to_sec)<0)
+        return -1;
+    if(prec->from==prec->to)
+        return -1;
+    ttc->prec_num++;
+    return 0;
+}
+
+/**
+ * @brief 读取线程描述文件
+ *
+ * @param ttc 状态
+ * @param fp 文件
+ * @return int 0成功，-1失败
+ */
+static int ttc_load(ttc_t *ttc, FILE *fp)
+{
+    char line[LINE_MAX_LEN];
+    char *argv[LINE_MAX_LEN/2];
+    char *p;
+    int argc,ret;
+    acoral_u32 lineno=0,cpu_num;
+    while(fgets(line,sizeof(line),fp)!=NULL)
+    {
+        lineno++;
+        p=strchr(line,'#');
+        if(p!=NULL)
+            *p='\0';
+        argc=0;
+        for(p=strtok(line," \t\r\n");p!=NULL;p=strtok(NULL," \t\r\n"))
+            argv[argc++]=p;
+        if(argc==0)
+            continue;
+        if(strcmp(argv[0],"cpus")==0)
+        {
+            ret=(argc==2&&ttc_parse_u32(argv[1],&cpu_num)==0&&cpu_num>0&&cpu_num<=TTC_MAX_CPU&&ttc->thread_num==0)?0:-1;
+            if(ret==0)
+                ttc->cpu_num=cpu_num;
+        }
+        else if(strcmp(argv[0],"thread")==0)
+            ret=ttc_parse_thread(ttc,argc,argv);
+        else if(strcmp(argv[0],"prec")==0)
+            ret=ttc_parse_prec(ttc,argc,argv);
+        else
+            ret=-1;
+        if(ret<0)
+        {
+            fprintf(stderr,"line %u: invalid '%s' entry\n",lineno,argv[0]);
+            return -1;
+        }
+    }
+    if(ttc->thread_num==0)
+    {
+        fprintf(stderr,"no thread\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 计算超周期并展开全部段实例
+ *
+ * @param ttc 状态
+ * @return int 0成功，-1失败
+ */
+static int ttc_expand(ttc_t *ttc)
+{
+    ttc_thread_t *thread,*from;
+    ttc_prec_t *prec;
+    ttc_item_t *item;
+    acoral_u64 h=1;
+    acoral_u32 i,k,s,p,job,index;
+    for(i=0;i<ttc->thread_num;i++)
+    {
+        h=h/ttc_gcd(h,ttc->thread[i].period)*ttc->thread[i].period;
+        if(h>0xffffffffULL)
+        {
+            fprintf(stderr,"hyper period overflow\n");
+            return -1;
+        }
+    }
+    ttc->h_period=(acoral_u32)h;
+    ttc->item_num=0;
+    for(i=0;i<ttc->thread_num;i++)
+    {
+        thread=&ttc->thread[i];
+        if(ttc->h_period/thread->period*(thread->section_num+1)>255)//timed_decode中开始时刻数量为u8
+        {
+            fprintf(stderr,"%s: %u jobs x %u sections exceed the 8-bit start time count\n",
+                    thread->name,ttc->h_period/thread->period,thread->section_num);
+            return -1;
+        }
+        thread->first=ttc->item_num;
+        ttc->item_num+=ttc->h_period/thread->period*thread->section_num;
+    }
+    ttc->item=ttc_realloc(NULL,sizeof(ttc_item_t)*ttc->item_num);
+    ttc->best=ttc_realloc(NULL,sizeof(acoral_u32)*ttc->item_num);
+    ttc->cpu_free=ttc_realloc(NULL,sizeof(acoral_u32)*ttc->cpu_num);
+    memset(ttc->item,0,sizeof(ttc_item_t)*ttc->item_num);
+    for(i=0;i<ttc->thread_num;i++)
+    {
+        thread=&ttc->thread[i];
+        for(k=0;k<ttc->h_period/thread->period;k++)
+        {
+            for(s=0;s<thread->section_num;s++)
+            {
+                item=&ttc->item[thread->first+k*thread->section_num+s];
+                item->thread=i;
+                item->job=k;
+                item->sec=s;
+                item->release=k*thread->period;
+                item->deadline=k*thread->period+thread->dl;
+                item->wcet=thread->wcet[s];
+                item->pred[0]=s?thread->first+k*thread->section_num+s-1:TTC_NONE;
+                item->pred[1]=TTC_NONE;
+            }
+        }
+    }
+    for(p=0;p<ttc->prec_num;p++)//后继的每个实例依赖前驱在其释放时刻之前最近一次释放的实例
+    {
+        prec=&ttc->prec[p];
+        thread=&ttc->thread[prec->to];
+        from=&ttc->thread[prec->from];
+        for(k=0;k<ttc->h_period/thread->period;k++)
+        {
+            item=&ttc->item[thread->first+k*thread->section_num+prec->to_sec];
+            job=(k*thread->period)/from->period;
+            index=from->first+job*from->section_num+prec->from_sec;
+            if(item->pred[1]==TTC_NONE)
+                item->pred[1]=index;
+            else
+            {
+                item->pred_ext=ttc_realloc(item->pred_ext,sizeof(acoral_u32)*(item->pred_ext_num+1));
+                item->pred_ext[item->pred_ext_num++]=index;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 段实例的前驱是否都已安排，并计算最早开始时刻
+ *
+ * @param ttc 状态
+ * @param item 段实例
+ * @param est 最早开始时刻
+ * @return acoral_bool 前驱是否都已安排
+ */
+static acoral_bool ttc_ready(ttc_t *ttc, ttc_item_t *item, acoral_u64 *est)
+{
+    ttc_item_t *pred;
+    acoral_u32 k,n;
+    acoral_u64 t=item->release;
+    if(ttc->cpu_free[ttc->thread[item->thread].cpu]>t)
+        t=ttc->cpu_free[ttc->thread[item->thread].cpu];
+    n=2+item->pred_ext_num;
+    for(k=0;k<n;k++)
+    {
+        acoral_u32 index=k<2?item->pred[k]:item->pred_ext[k-2];
+        if(index==TTC_NONE)
+            continue;
+        pred=&ttc->item[index];
+        if(pred->start==TTC_NONE)
+            return false;
+        if((acoral_u64)pred->start+pred->wcet+ttc->margin>t)
+            t=(acoral_u64)pred->start+pred->wcet+ttc->margin;
+    }
+    *est=t;
+    return true;
+}
+
+/**
+ * @brief 一次表调度：每步在最早可开始时刻之后window内可开始的段实例中选键值最小的安排
+ *
+ * @param ttc 状态
+ * @param window 允许插入的空闲时间，0为不插入空闲
+ * @param slack_min 最小余量（截止时间减结束时刻），为负时不可行
+ * @return int 0成功，-1前驱成环
+ */
+static int ttc_list_schedule(ttc_t *ttc, acoral_u32 window, acoral_64 *slack_min)
+{
+    ttc_item_t *item,*next;
+    acoral_u32 i,n;
+    acoral_u64 est,next_est,t_min;
+    acoral_64 slack;
+    for(i=0;i<ttc->item_num;i++)
+        ttc->item[i].start=TTC_NONE;
+    memset(ttc->cpu_free,0,sizeof(acoral_u32)*ttc->cpu_num);
+    *slack_min=ttc->h_period;
+    for(n=0;n<ttc->item_num;n++)
+    {
+        t_min=TTC_NONE;
+        for(i=0;i<ttc->item_num;i++)//最早可开始时刻
+        {
+            item=&ttc->item[i];
+            if(item->start==TTC_NONE&&ttc_ready(ttc,item,&est)&&est<t_min)
+                t_min=est;
+        }
+        if(t_min==TTC_NONE)//剩余的段实例都在等待未安排的前驱
+            return -1;
+        next=NULL;
+        next_est=0;
+        for(i=0;i<ttc->item_num;i++)
+        {
+            item=&ttc->item[i];
+            if(item->start!=TTC_NONE||!ttc_ready(ttc,item,&est)||est>t_min+window)
+                continue;
+            if(next==NULL||item->key<next->key||(item->key==next->key&&est<next_est))
+            {
+                next=item;
+                next_est=est;
+            }
+        }
+        next->start=(acoral_u32)next_est;
+        ttc->cpu_free[ttc->thread[next->thread].cpu]=(acoral_u32)(next_est+next->wcet+ttc->margin);
+        slack=(acoral_64)next->deadline-(acoral_64)(next_est+next->wcet+ttc->margin);
+        if(slack<*slack_min)
+            *slack_min=slack;
+    }
+    return 0;
+}
+
+/**
+ * @brief 搜索可行时间表：先按截止时间、再按最小余量表调度，之后随机扰动键值与插入空闲
+ *
+ * @param ttc 状态
+ * @param iter 迭代次数
+ * @param seed 随机数种子
+ * @param best_only 找到可行解后继续搜索最小余量最大的解
+ * @return int 1可行，0不可行，-1前驱成环
+ */
+static int ttc_search(ttc_t *ttc, acoral_u32 iter, acoral_u32 seed, acoral_bool best_only)
+{
+    ttc_item_t *item;
+    acoral_u32 i,k,window,max_wcet=0;
+    acoral_64 slack,best=0;
+    srand(seed);
+    for(i=0;i<ttc->item_num;i++)
+    {
+        if(ttc->item[i].wcet>max_wcet)
+            max_wcet=ttc->item[i].wcet;
+    }
+    for(k=0;k<iter;k++)
+    {
+        window=0;
+        for(i=0;i<ttc->item_num;i++)
+        {
+            item=&ttc->item[i];
+            if(k==1)//最小余量优先
+                item->key=item->deadline-item->wcet;
+            else//截止时间优先，之后随机扰动
+                item->key=item->deadline+(k?(acoral_u32)rand()%(ttc->thread[item->thread].dl+1):0);
+        }
+        if(k>=2)
+            window=(acoral_u32)rand()%(max_wcet+1);
+        if(ttc_list_schedule(ttc,window,&slack)<0)
+            return -1;
+        if(k==0||slack>best)
+        {
+            best=slack;
+            for(i=0;i<ttc->item_num;i++)
+                ttc->best[i]=ttc->item[i].start;
+        }
+        if(best>=0&&!best_only)
+            break;
+    }
+    for(i=0;i<ttc->item_num;i++)
+        ttc->item[i].start=ttc->best[i];
+    return best>=0;
+}
+
+/**
+ * @brief 写入u32小端
+ *
+ * @param buf 缓冲区
+ * @param value 数值
+ */
+static void ttc_put_u32(acoral_u8 *buf, acoral_u32 value)
+{
+    buf[0]=value&0xff;
+    buf[1]=(value>>8)&0xff;
+    buf[2]=(value>>16)&0xff;
+    buf[3]=(value>>24)&0xff;
+}
+
+/**
+ * @brief 读取u32小端
+ *
+ * @param buf 缓冲区
+ * @return acoral_u32 数值
+ */
+static acoral_u32 ttc_get_u32(const acoral_u8 *buf)
+{
+    return buf[0]|(buf[1]<<8)|(buf[2]<<16)|((acoral_u32)buf[3]<<24);
+}
+
+/**
+ * @brief 生成调度表文件内容，时间数组按大小从小到大排列，使各数组起始偏移尽量不超过8位
+ *
+ * @param ttc 状态
+ * @param size 文件大小
+ * @return acoral_u8* 文件内容，超出8位偏移时为NULL
+ */
+static acoral_u8 *ttc_image(ttc_t *ttc, acoral_u32 *size)
+{
+    ttc_thread_t *thread;
+    acoral_u8 *image,*rec;
+    acoral_u32 *order;
+    acoral_u32 i,j,k,s,t,pos,jobs;
+    order=ttc_realloc(NULL,sizeof(acoral_u32)*ttc->thread_num);
+    for(i=0;i<ttc->thread_num;i++)
+        order[i]=i;
+    for(i=1;i<ttc->thread_num;i++)//按时间数组大小插入排序
+    {
+        t=order[i];
+        for(j=i;j>0;j--)
+        {
+            thread=&ttc->thread[order[j-1]];
+            if((ttc->h_period/thread->period+1)*thread->section_num<=(ttc->h_period/ttc->thread[t].period+1)*ttc->thread[t].section_num)
+                break;
+            order[j]=order[j-1];
+        }
+        order[j]=t;
+    }
+    *size=TTC_OFFSET_POS+ttc->thread_num*(1+TTC_THREAD_SIZE);
+    for(i=0;i<ttc->thread_num;i++)
+        *size+=4*(ttc->h_period/ttc->thread[i].period+1)*ttc->thread[i].section_num;
+    image=ttc_realloc(NULL,*size);
+    memset(image,0,*size);
+    image[0]=0x3e;
+    image[1]=0x13;
+    image[2]=0xff;
+    image[3]=0xff;
+    for(i=0;i<ttc->cpu_num;i++)//全部cpu使用同一个超周期，跨cpu的前后约束在每个超周期内一致，其余cpu保持为0
+        ttc_put_u32(image+4+4*i,ttc->h_period);
+    image[TTC_THREAD_NUM_POS]=(acoral_u8)ttc->thread_num;
+    pos=TTC_OFFSET_POS+ttc->thread_num;
+    for(i=0;i<ttc->thread_num;i++)//线程数据
+    {
+        if(pos>0xff)
+            goto overflow;
+        image[TTC_OFFSET_POS+i]=(acoral_u8)pos;
+        pos+=TTC_THREAD_SIZE;
+    }
+    for(j=0;j<ttc->thread_num;j++)//时间数组
+    {
+        i=order[j];
+        thread=&ttc->thread[i];
+        jobs=ttc->h_period/thread->period;
+        if(pos>0xff)
+            goto overflow;
+        rec=image+image[TTC_OFFSET_POS+i];
+        ttc_put_u32(rec,thread->period);
+        rec[4]=(acoral_u8)thread->section_num;
+        rec[5]=(acoral_u8)jobs;
+        rec[6]=(acoral_u8)pos;
+        rec[7]=(acoral_u8)thread->cpu;
+        for(s=0;s<thread->section_num;s++,pos+=4)
+            ttc_put_u32(image+pos,thread->wcet[s]);
+        for(k=0;k<jobs;k++)
+        {
+            for(s=0;s<thread->section_num;s++,pos+=4)
+                ttc_put_u32(image+pos,ttc->item[thread->first+k*thread->section_num+s].start);
+        }
+    }
+    free(order);
+    return image;
+overflow:
+    fprintf(stderr,"schedule image needs offsets above 255, timed_decode uses 8-bit offsets; "
+                   "split the threads or reduce jobs per hyper period\n");
+    free(order);
+    free(image);
+    return NULL;
+}
+
+/**
+ * @brief 按timed_decode的读取方式解析调度表文件，检查与时间表一致
+ *
+ * @param ttc 状态
+ * @param image 文件内容
+ * @param size 文件大小
+ * @return acoral_bool 是否一致
+ */
+static acoral_bool ttc_image_check(ttc_t *ttc, const acoral_u8 *image, acoral_u32 size)
+{
+    const acoral_u8 *rec,*times;
+    ttc_thread_t *thread;
+    acoral_u32 i,k,s,num;
+    if(image[0]!=0x3e||image[1]!=0x13||image[2]!=0xff||image[3]!=0xff)
+        return false;
+    for(i=ttc->cpu_num;i<TTC_MAX_CPU;i++)
+    {
+        if(ttc_get_u32(image+4+4*i)!=0)
+            return false;
+    }
+    num=image[TTC_THREAD_NUM_POS];
+    if(num!=ttc->thread_num)
+        return false;
+    for(i=0;i<num;i++)
+    {
+        thread=&ttc->thread[i];
+        rec=image+image[TTC_OFFSET_POS+i];
+        if(ttc_get_u32(rec)!=thread->period||rec[4]!=thread->section_num||rec[7]!=thread->cpu)
+            return false;
+        times=image+rec[6];
+        if(times+4*thread->section_num*(rec[5]+1)>image+size)
+            return false;
+        for(s=0;s<rec[4];s++)
+        {
+            if(ttc_get_u32(times+4*s)!=thread->wcet[s])
+                return false;
+        }
+        times+=4*rec[4];
+        for(k=0;k<rec[5];k++)
+        {
+            for(s=0;s<rec[4];s++)
+            {
+                if(ttc_get_u32(times+4*(k*rec[4]+s))!=ttc->item[thread->first+k*thread->section_num+s].start)
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 打印时间表与甘特图
+ *
+ * @param ttc 状态
+ * @param width 甘特图宽度
+ * @param ok 是否可行
+ */
+static void ttc_report(ttc_t *ttc, acoral_u32 width, acoral_bool ok)
+{
+    ttc_item_t *item,*next;
+    ttc_thread_t *thread;
+    acoral_u32 *order;
+    acoral_u32 c,i,j,col,busy;
+    acoral_u64 t;
+    char *row;
+    printf("hyper period %u\n\n",ttc->h_period);
+    order=ttc_realloc(NULL,sizeof(acoral_u32)*ttc->item_num);
+    for(i=0;i<ttc->item_num;i++)//按cpu与开始时刻插入排序
+    {
+        item=&ttc->item[i];
+        for(j=i;j>0;j--)
+        {
+            next=&ttc->item[order[j-1]];
+            if(ttc->thread[next->thread].cpu<ttc->thread[item->thread].cpu||
+               (ttc->thread[next->thread].cpu==ttc->thread[item->thread].cpu&&next->start<=item->start))
+                break;
+            order[j]=order[j-1];
+        }
+        order[j]=i;
+    }
+    printf("%-4s%-16s%6s%6s%8s%8s%8s%8s\n","cpu","thread","job","sec","start","end","dl","slack");
+    for(c=0;c<ttc->cpu_num;c++)
+    {
+        busy=0;
+        for(i=0;i<ttc->item_num;i++)
+        {
+            item=&ttc->item[order[i]];
+            if(ttc->thread[item->thread].cpu!=c)
+                continue;
+            busy+=item->wcet;
+            printf("%-4u%-16s%6u%6u%8u%8u%8u%8d%s\n",c,ttc->thread[item->thread].name,item->job,item->sec+1,
+                   item->start,item->start+item->wcet,item->deadline,
+                   (int)item->deadline-(int)(item->start+item->wcet),
+                   item->start+item->wcet>item->deadline?"  MISS":"");
+        }
+        printf("%-4u%-16s%u.%u%%\n\n",c,"utilization",busy*100/ttc->h_period,busy*1000/ttc->h_period%10);
+    }
+    free(order);
+    if(width)
+    {
+        row=ttc_realloc(NULL,width+1);
+        printf("gantt: one column = %.2f ms\n",(double)ttc->h_period/width);
+        for(c=0;c<ttc->cpu_num;c++)
+        {
+            memset(row,'.',width);
+            row[width]='\0';
+            for(i=0;i<ttc->item_num;i++)
+            {
+                item=&ttc->item[i];
+                if(ttc->thread[item->thread].cpu!=c||item->start==TTC_NONE)
+                    continue;
+                for(t=item->start;t<(acoral_u64)item->start+item->wcet;t++)
+                {
+                    col=(acoral_u32)(t*width/ttc->h_period);
+                    if(col<width)
+                        row[col]=item->thread<26?'A'+item->thread:'a'+(item->thread-26)%26;
+                }
+            }
+            printf("cpu%-3u|%s|\n",c,row);
+        }
+        for(i=0;i<ttc->thread_num;i++)
+        {
+            thread=&ttc->thread[i];
+            printf("  %c = %s (index %u)\n",i<26?'A'+i:'a'+(i-26)%26,thread->name,i);
+        }
+        free(row);
+    }
+    printf("\n%s\n",ok?"feasible":"NOT feasible");
+}
+
+/**
+ * @brief 打印用法
+ *
+ * @param prog 程序名
+ */
+static void ttc_usage(const char *prog)
+{
+    fprintf(stderr,"usage: %s [-o image] [-n iter] [-r seed] [-m margin] [-w width] [-b] <thread file|->\n",prog);
+    fprintf(stderr,"  -o  write the schedule image read by timed_decode\n");
+    fprintf(stderr,"  -n  search iterations, default 2000\n");
+    fprintf(stderr,"  -r  random seed, default 1\n");
+    fprintf(stderr,"  -m  guard time after each section, default 0\n");
+    fprintf(stderr,"  -w  gantt chart width, 0 to disable, default 100\n");
+    fprintf(stderr,"  -b  keep searching for the largest minimum slack\n");
+}
+
+int main(int argc, char **argv)
+{
+    ttc_t ttc;
+    acoral_u32 iter=2000,seed=1,width=100,size;
+    acoral_u8 *image;
+    acoral_bool best_only=false;
+    int ok;
+    const char *out=NULL;
+    FILE *fp;
+    int i;
+    memset(&ttc,0,sizeof(ttc));
+    ttc.cpu_num=TTC_MAX_CPU;
+    for(i=1;i<argc&&argv[i][0]=='-'&&argv[i][1]!='\0';i++)
+    {
+        if(strcmp(argv[i],"-b")==0)
+            best_only=true;
+        else if(strcmp(argv[i],"-o")==0&&i+1<argc)
+            out=argv[++i];
+        else if(strcmp(argv[i],"-n")==0&&i+1<argc&&ttc_parse_u32(argv[i+1],&iter)==0&&iter>0)
+            i++;
+        else if(strcmp(argv[i],"-r")==0&&i+1<argc&&ttc_parse_u32(argv[i+1],&seed)==0)
+            i++;
+        else if(strcmp(argv[i],"-m")==0&&i+1<argc&&ttc_parse_u32(argv[i+1],&ttc.margin)==0)
+            i++;
+        else if(strcmp(argv[i],"-w")==0&&i+1<argc&&ttc_parse_u32(argv[i+1],&width)==0)
+            i++;
+        else
+        {
+            ttc_usage(argv[0]);
+            return 2;
+        }
+    }
+    if(i!=argc-1)
+    {
+        ttc_usage(argv[0]);
+        return 2;
+    }
+    fp=strcmp(argv[i],"-")==0?stdin:fopen(argv[i],"r");
+    if(fp==NULL)
+    {
+        perror(argv[i]);
+        return 2;
+    }
+    if(ttc_load(&ttc,fp)<0)
+        return 2;
+    if(fp!=stdin)
+        fclose(fp);
+    if(ttc_expand(&ttc)<0)
+        return 2;
+    ok=ttc_search(&ttc,iter,seed,best_only);
+    if(ok<0)
+    {
+        fprintf(stderr,"precedence cycle\n");
+        return 2;
+    }
+    ttc_report(&ttc,width,ok);
+    if(!ok)
+        return 1;
+    if(out!=NULL)
+    {
+        image=ttc_image(&ttc,&size);
+        if(image==NULL)
+            return 2;
+        if(!ttc_image_check(&ttc,image,size))
+        {
+            fprintf(stderr,"internal error: image does not decode to the schedule\n");
+            return 2;
+        }
+        fp=fopen(out,"wb");
+        if(fp==NULL||fwrite(image,1,size,fp)!=size)
+        {
+            perror(out);
+            return 2;
+        }
+        fclose(fp);
+        printf("wrote %s (%u bytes)\n",out,size);
+        free(image);
+    }
+    return 0;
+}